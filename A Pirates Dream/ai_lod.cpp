@@ -0,0 +1,88 @@
+#include "ai_lod.h"
+
+namespace game {
+
+AiLodScheduler::AiLodScheduler(void)
+{
+    frame_ = 0;
+
+    // roughly: on screen, just off screen, far away, and everything past that
+    bucket_distance_[0] = 5.0f;
+    bucket_distance_[1] = 9.0f;
+    bucket_distance_[2] = 16.0f;
+
+    ResetCounters();
+}
+
+
+void AiLodScheduler::BeginFrame(void)
+{
+    frame_++;
+}
+
+
+int AiLodScheduler::GetBucket(float distance) const
+{
+    for (int b = 0; b < AI_LOD_BUCKETS - 1; b++)
+    {
+        if (distance < bucket_distance_[b]) return b;
+    }
+    return AI_LOD_BUCKETS - 1;
+}
+
+
+bool AiLodScheduler::ShouldUpdate(int slot, float distance)
+{
+    int bucket = GetBucket(distance);
+
+    // the interval is a power of two, so this picks a different share of the bucket each frame
+    unsigned int mask = GetInterval(bucket) - 1;
+    if (((frame_ + static_cast<unsigned int>(slot)) & mask) == 0)
+    {
+        updates_run_[bucket]++;
+        return true;
+    }
+
+    updates_skipped_[bucket]++;
+    return false;
+}
+
+
+long long AiLodScheduler::GetTotalUpdatesRun(void) const
+{
+    long long total = 0;
+    for (int b = 0; b < AI_LOD_BUCKETS; b++) total += updates_run_[b];
+    return total;
+}
+
+
+long long AiLodScheduler::GetTotalUpdatesSkipped(void) const
+{
+    long long total = 0;
+    for (int b = 0; b < AI_LOD_BUCKETS; b++) total += updates_skipped_[b];
+    return total;
+}
+
+
+void AiLodScheduler::ResetCounters(void)
+{
+    for (int b = 0; b < AI_LOD_BUCKETS; b++)
+    {
+        updates_run_[b] = 0;
+        updates_skipped_[b] = 0;
+    }
+}
+
+
+void AiLodScheduler::Save(Snapshot &snapshot) const
+{
+    snapshot.Write(frame_);
+}
+
+
+void AiLodScheduler::Load(Snapshot &snapshot)
+{
+    snapshot.Read(frame_);
+}
+
+} // namespace game
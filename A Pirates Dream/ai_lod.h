@@ -0,0 +1,60 @@
+#ifndef AI_LOD_H_
+#define AI_LOD_H_
+
+#include "snapshot.h"
+
+// the number of distance buckets the scheduler sorts enemies into
+#define AI_LOD_BUCKETS 4
+
+namespace game {
+
+    /*
+        AiLodScheduler decides which enemies get a full update this frame
+        Enemies are bucketed by their distance to the player, near ones update every frame and
+        each bucket further out updates half as often. Within a bucket the enemies take turns
+        (round robin on their slot) so the work is spread evenly across frames, and a skipped
+        enemy is handed the time it missed on its next update so it catches up
+    */
+    class AiLodScheduler {
+
+        public:
+            // Constructor
+            AiLodScheduler(void);
+
+            // Call once at the start of every frame
+            void BeginFrame(void);
+
+            // Check whether the enemy in a given round robin slot should update this frame
+            bool ShouldUpdate(int slot, float distance);
+
+            // Which bucket a distance falls into, and how many frames apart that bucket updates
+            int GetBucket(float distance) const;
+            inline int GetInterval(int bucket) const { return 1 << bucket; }
+
+            // Counters
+            inline long long GetUpdatesRun(int bucket) const { return updates_run_[bucket]; }
+            inline long long GetUpdatesSkipped(int bucket) const { return updates_skipped_[bucket]; }
+            long long GetTotalUpdatesRun(void) const;
+            long long GetTotalUpdatesSkipped(void) const;
+            void ResetCounters(void);
+
+            // Save or restore the frame count that decides whose turn it is, the counters are left alone
+            void Save(Snapshot &snapshot) const;
+            void Load(Snapshot &snapshot);
+
+        private:
+            // the frame were on, used to pick whose turn it is
+            unsigned int frame_;
+
+            // the distance at which each bucket ends (the last bucket takes everything past it)
+            float bucket_distance_[AI_LOD_BUCKETS - 1];
+
+            // how many updates each bucket ran and skipped
+            long long updates_run_[AI_LOD_BUCKETS];
+            long long updates_skipped_[AI_LOD_BUCKETS];
+
+    }; // class AiLodScheduler
+
+} // namespace game
+
+#endif // AI_LOD_H_
@@ -0,0 +1,233 @@
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#include "alloc_tracker.h"
+
+namespace game {
+
+// the names the report uses for each tag, in ALLOC_TAG_ order
+static const char *tag_names_g[ALLOC_NUM_TAGS] = { "other", "object", "player", "enemy", "projectile", "collectible", "particles", "timer", "simulation", "render", "audio" };
+
+// every block gets a header in front with its size and tag so the free is counted against the right tag
+// it is a full 16 bytes so the memory handed out keeps mallocs alignment
+struct AllocHeader {
+    std::size_t size;
+    int tag;
+};
+#define ALLOC_HEADER_SIZE 16
+
+// the running counts, these live in static storage so they are zero before anything is allocated
+static std::atomic<long long> allocs_g[ALLOC_NUM_TAGS];
+static std::atomic<long long> frees_g[ALLOC_NUM_TAGS];
+static std::atomic<long long> bytes_g[ALLOC_NUM_TAGS];
+static std::atomic<long long> live_g[ALLOC_NUM_TAGS];
+static std::atomic<long long> live_bytes_g[ALLOC_NUM_TAGS];
+static std::atomic<long long> peak_live_g[ALLOC_NUM_TAGS];
+static std::atomic<long long> peak_live_bytes_g[ALLOC_NUM_TAGS];
+static std::atomic<long long> frame_allocs_g[ALLOC_NUM_TAGS];
+static std::atomic<long long> frame_bytes_g[ALLOC_NUM_TAGS];
+
+// the per frame counts, only touched by whoever calls EndFrame
+static long long max_frame_allocs_g[ALLOC_NUM_TAGS];
+static long long max_frame_bytes_g[ALLOC_NUM_TAGS];
+static long long counted_allocs_g[ALLOC_NUM_TAGS];
+static long long frames_g = 0;
+static long long quiet_frames_g = 0;
+static long long last_busy_frame_g = -1;
+
+static thread_local int tag_g = ALLOC_TAG_OTHER;
+
+
+// Raise a high water mark if the value went past it
+static inline void RaisePeak(std::atomic<long long> &peak, long long value)
+{
+    long long current = peak.load(std::memory_order_relaxed);
+    while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+
+int AllocTracker::GetTag(void)
+{
+    return tag_g;
+}
+
+
+void AllocTracker::SetTag(int tag)
+{
+    tag_g = tag;
+}
+
+
+void *AllocTracker::Allocate(std::size_t size)
+{
+    char *block = static_cast<char *>(malloc(size + ALLOC_HEADER_SIZE));
+    if (!block) return NULL;
+
+    int tag = tag_g;
+    AllocHeader *header = reinterpret_cast<AllocHeader *>(block);
+    header->size = size;
+    header->tag = tag;
+
+    long long bytes = static_cast<long long>(size);
+    allocs_g[tag].fetch_add(1, std::memory_order_relaxed);
+    bytes_g[tag].fetch_add(bytes, std::memory_order_relaxed);
+    frame_allocs_g[tag].fetch_add(1, std::memory_order_relaxed);
+    frame_bytes_g[tag].fetch_add(bytes, std::memory_order_relaxed);
+    RaisePeak(peak_live_g[tag], live_g[tag].fetch_add(1, std::memory_order_relaxed) + 1);
+    RaisePeak(peak_live_bytes_g[tag], live_bytes_g[tag].fetch_add(bytes, std::memory_order_relaxed) + bytes);
+
+    return block + ALLOC_HEADER_SIZE;
+}
+
+
+void AllocTracker::Free(void *pointer)
+{
+    if (!pointer) return;
+
+    char *block = static_cast<char *>(pointer) - ALLOC_HEADER_SIZE;
+    AllocHeader *header = reinterpret_cast<AllocHeader *>(block);
+
+    frees_g[header->tag].fetch_add(1, std::memory_order_relaxed);
+    live_g[header->tag].fetch_sub(1, std::memory_order_relaxed);
+    live_bytes_g[header->tag].fetch_sub(static_cast<long long>(header->size), std::memory_order_relaxed);
+
+    free(block);
+}
+
+
+void AllocTracker::EndFrame(void)
+{
+    long long frame_total = 0;
+    for (int t = 0; t < ALLOC_NUM_TAGS; t++)
+    {
+        long long allocs = frame_allocs_g[t].exchange(0, std::memory_order_relaxed);
+        long long bytes = frame_bytes_g[t].exchange(0, std::memory_order_relaxed);
+
+        if (allocs > max_frame_allocs_g[t]) max_frame_allocs_g[t] = allocs;
+        if (bytes > max_frame_bytes_g[t]) max_frame_bytes_g[t] = bytes;
+        counted_allocs_g[t] += allocs;
+        frame_total += allocs;
+    }
+
+    if (frame_total == 0) quiet_frames_g++;
+    else last_busy_frame_g = frames_g;
+    frames_g++;
+}
+
+
+void AllocTracker::Report(std::ostream &out)
+{
+    if (!IsEnabled())
+    {
+        out << "Allocation tracking is not compiled in, rebuild with -DTRACK_ALLOCATIONS=ON" << std::endl;
+        return;
+    }
+
+    out << "Allocations over " << frames_g << " frames" << std::endl;
+
+    char row[192];
+    snprintf(row, sizeof(row), "  %-12s %10s %10s %12s %8s %11s %9s %11s %10s %10s", "tag", "allocs", "frees", "bytes", "live", "live bytes", "peak live", "peak bytes", "max/frame", "avg/frame");
+    out << row << std::endl;
+
+    long long total_allocs = 0, total_frees = 0, total_bytes = 0, total_live = 0, total_live_bytes = 0;
+    for (int t = 0; t < ALLOC_NUM_TAGS; t++)
+    {
+        long long allocs = allocs_g[t].load();
+        if (allocs == 0) continue;
+
+        // only the allocations made inside a frame go into the average, not the ones from loading
+        double average = frames_g > 0 ? static_cast<double>(counted_allocs_g[t]) / frames_g : 0.0;
+        snprintf(row, sizeof(row), "  %-12s %10lld %10lld %12lld %8lld %11lld %9lld %11lld %10lld %10.2f", tag_names_g[t],
+                 allocs, frees_g[t].load(), bytes_g[t].load(), live_g[t].load(), live_bytes_g[t].load(),
+                 peak_live_g[t].load(), peak_live_bytes_g[t].load(), max_frame_allocs_g[t], average);
+        out << row << std::endl;
+
+        total_allocs += allocs;
+        total_frees += frees_g[t].load();
+        total_bytes += bytes_g[t].load();
+        total_live += live_g[t].load();
+        total_live_bytes += live_bytes_g[t].load();
+    }
+
+    snprintf(row, sizeof(row), "  %-12s %10lld %10lld %12lld %8lld %11lld", "total", total_allocs, total_frees, total_bytes, total_live, total_live_bytes);
+    out << row << std::endl;
+
+    // what we are driving towards is every frame allocating nothing once the game is going
+    out << "  " << quiet_frames_g << " of " << frames_g << " frames allocated nothing";
+    if (last_busy_frame_g >= 0) out << ", the last frame that allocated was " << last_busy_frame_g;
+    out << std::endl;
+}
+
+} // namespace game
+
+
+#ifdef ALLOC_TRACKING_ENABLED
+
+// the replaced global allocation functions, every new and delete in the program goes through these
+
+void *operator new(std::size_t size)
+{
+    void *pointer = game::AllocTracker::Allocate(size);
+    if (!pointer) throw std::bad_alloc();
+    return pointer;
+}
+
+
+void *operator new[](std::size_t size)
+{
+    void *pointer = game::AllocTracker::Allocate(size);
+    if (!pointer) throw std::bad_alloc();
+    return pointer;
+}
+
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    return game::AllocTracker::Allocate(size);
+}
+
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    return game::AllocTracker::Allocate(size);
+}
+
+
+void operator delete(void *pointer) noexcept
+{
+    game::AllocTracker::Free(pointer);
+}
+
+
+void operator delete[](void *pointer) noexcept
+{
+    game::AllocTracker::Free(pointer);
+}
+
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    game::AllocTracker::Free(pointer);
+}
+
+
+void operator delete[](void *pointer, std::size_t) noexcept
+{
+    game::AllocTracker::Free(pointer);
+}
+
+
+void operator delete(void *pointer, const std::nothrow_t &) noexcept
+{
+    game::AllocTracker::Free(pointer);
+}
+
+
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept
+{
+    game::AllocTracker::Free(pointer);
+}
+
+#endif // ALLOC_TRACKING_ENABLED
@@ -0,0 +1,87 @@
+#ifndef ALLOC_TRACKER_H_
+#define ALLOC_TRACKER_H_
+
+#include <cstddef>
+#include <ostream>
+
+// what an allocation gets counted against
+#define ALLOC_TAG_OTHER 0
+#define ALLOC_TAG_OBJECT 1
+#define ALLOC_TAG_PLAYER 2
+#define ALLOC_TAG_ENEMY 3
+#define ALLOC_TAG_PROJECTILE 4
+#define ALLOC_TAG_COLLECTIBLE 5
+#define ALLOC_TAG_PARTICLES 6
+#define ALLOC_TAG_TIMER 7
+#define ALLOC_TAG_SIMULATION 8
+#define ALLOC_TAG_RENDER 9
+#define ALLOC_TAG_AUDIO 10
+#define ALLOC_NUM_TAGS 11
+
+/*
+    Allocation tracking, only compiled in with cmake -DTRACK_ALLOCATIONS=ON (ALLOC_TRACKING_ENABLED)
+    The global operator new and delete are replaced so every allocation is counted against the tag
+    of the innermost ALLOC_SCOPE on its thread, and the game object classes tag their own
+    allocations with ALLOC_TAGGED_NEW. Without the define both macros are empty
+*/
+#ifdef ALLOC_TRACKING_ENABLED
+#define ALLOC_JOIN_(a, b) a##b
+#define ALLOC_JOIN(a, b) ALLOC_JOIN_(a, b)
+#define ALLOC_SCOPE(tag) game::AllocScope ALLOC_JOIN(alloc_scope_, __LINE__)(tag)
+#define ALLOC_TAGGED_NEW(tag)\
+    static void *operator new(std::size_t size) { game::AllocScope scope(tag); return ::operator new(size); }
+#else
+#define ALLOC_SCOPE(tag) ((void) 0)
+#define ALLOC_TAGGED_NEW(tag)
+#endif
+
+namespace game {
+
+    /*
+        AllocTracker keeps the counts for every tag: allocations and bytes in total and per frame,
+        what is still live, and the high water marks for sizing pools
+    */
+    class AllocTracker {
+
+        public:
+            // The tag new allocations on the calling thread are counted against
+            static int GetTag(void);
+            static void SetTag(int tag);
+
+            // Close off the counts for the frame that just finished
+            static void EndFrame(void);
+
+            // Print the counts for every tag
+            static void Report(std::ostream &out);
+
+            // Used by the replaced operator new and delete
+            static void *Allocate(std::size_t size);
+            static void Free(void *pointer);
+
+            // Whether the tracking was compiled in
+            static inline bool IsEnabled(void) {
+#ifdef ALLOC_TRACKING_ENABLED
+                return true;
+#else
+                return false;
+#endif
+            }
+
+    }; // class AllocTracker
+
+
+    // Counts the allocations made in the block it is declared in against a tag, use ALLOC_SCOPE instead of making one directly
+    class AllocScope {
+
+        public:
+            inline AllocScope(int tag) : previous_(AllocTracker::GetTag()) { AllocTracker::SetTag(tag); }
+            inline ~AllocScope() { AllocTracker::SetTag(previous_); }
+
+        private:
+            int previous_;
+
+    }; // class AllocScope
+
+} // namespace game
+
+#endif // ALLOC_TRACKER_H_
@@ -0,0 +1,60 @@
+#ifndef AUDIO_BACKEND_H_
+#define AUDIO_BACKEND_H_
+
+#include <stdint.h>
+
+// what a source is doing
+#define AUDIO_SOURCE_INITIAL 0
+#define AUDIO_SOURCE_PLAYING 1
+#define AUDIO_SOURCE_STOPPED 2
+
+namespace audio_manager {
+
+    /*
+        Whatever actually makes the sound, shaped after the parts of OpenAL the audio manager uses: buffers of
+        samples, sources that play a buffer (or a queue of them, for the streams) from somewhere in the world,
+        and the listener
+        OpenAlBackend plays through a sound card, SoftwareMixer mixes into memory so it works without one
+        Buffers and sources are numbers the backend hands out, 0 is never a real one
+    */
+    class AudioBackend {
+
+        public:
+            virtual ~AudioBackend() {}
+
+            // Buffers, the samples are signed 16 bit with the channels interleaved
+            virtual unsigned int CreateBuffer(void) = 0;
+            virtual void DeleteBuffer(unsigned int buffer) = 0;
+            virtual void SetBufferData(unsigned int buffer, const int16_t *samples, int frames, int channels, int sample_rate) = 0;
+
+            // Sources, setting the buffer replaces anything queued (0 takes it off)
+            virtual unsigned int CreateSource(void) = 0;
+            virtual void DeleteSource(unsigned int source) = 0;
+            virtual void SetSourceBuffer(unsigned int source, unsigned int buffer) = 0;
+            virtual void SetSourceLooping(unsigned int source, bool loop) = 0;
+            virtual void SetSourceGain(unsigned int source, float gain) = 0;
+            virtual void SetSourcePosition(unsigned int source, float x, float y, float z) = 0;
+            virtual void SetSourceRelative(unsigned int source, bool relative) = 0;
+            virtual void SetSourceDistance(unsigned int source, float reference, float max, float rolloff) = 0;
+            virtual void SetSourceOffset(unsigned int source, float seconds) = 0;
+            virtual void PlaySource(unsigned int source) = 0;
+            virtual void StopSource(unsigned int source) = 0;
+            virtual int GetSourceState(unsigned int source) = 0;
+
+            // Buffers queued up on a source one after the other, a processed buffer has been played and can be taken back
+            virtual void QueueBuffer(unsigned int source, unsigned int buffer) = 0;
+            virtual unsigned int UnqueueBuffer(unsigned int source) = 0;
+            virtual int GetQueuedBuffers(unsigned int source) = 0;
+            virtual int GetProcessedBuffers(unsigned int source) = 0;
+
+            // Where the sources are heard from
+            virtual void SetListenerPosition(float x, float y, float z) = 0;
+
+            // Whether any call since the last check failed
+            virtual bool HasError(void) = 0;
+
+    }; // class AudioBackend
+
+} // namespace audio_manager
+
+#endif // AUDIO_BACKEND_H_
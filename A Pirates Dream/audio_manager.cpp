@@ -1,191 +1,421 @@
-#include "audio_manager.h"
-
-/* Based on the example in http://ffainelli.github.io/openal-example/ */
-
-namespace audio_manager {
-
-
-AudioManager::AudioManager(void){
-
-    initialized_ = 0;
-
-}
-
-
-AudioManager::~AudioManager(){
-
-    if (initialized_){
-        ShutDown();
-    }
-}
-
-
-void AudioManager::Init(const char *device_name){
-
-    if (!initialized_){
-        ALCdevice *device = NULL;
-
-        /* Initialize audio device */
-        if (device_name){
-            device = alcOpenDevice(device_name);
-        } else {
-            /* If no device name specified, use default device */
-            const char *name = alcGetString(NULL, ALC_DEFAULT_DEVICE_SPECIFIER);
-            device = alcOpenDevice(name);
-        }
-
-        if (!device) {
-            throw(AudioManagerException(std::string("Unable to open device")));
-        }
-
-        //Name of device: alcGetString(device, ALC_DEVICE_SPECIFIER));
-
-        /* Create audio context */
-        context_ = alcCreateContext(device, NULL);
-        if (!alcMakeContextCurrent(context_)) {
-            throw(AudioManagerException(std::string("Failed to create default context")));
-        }
-        CheckForErrors("Failed to create default context");
-
-        /* Initialize the Alut library */
-        alutInitWithoutContext(NULL, NULL);
-
-        /* Remember that we initialized the audio system */
-        initialized_ = 1;
-    }
-}
-
-
-void AudioManager::ShutDown(void){
-
-    if (initialized_){
-
-        ALCdevice *device;
-
-        for (int i = 0; i < buffer_.size(); i++){
-            alDeleteSources(1, &source_[i]);
-            alDeleteBuffers(1, &buffer_[i]);
-        }
-        device = alcGetContextsDevice(context_);
-        alcMakeContextCurrent(NULL);
-        alcDestroyContext(context_);
-        alcCloseDevice(device);
-
-        alutExit();
-
-        initialized_ = 0;
-    }
-}
-
-
-int AudioManager::AddSound(const char *filename){
-
-    ALuint buffer;
-    ALuint source;
-
-    /* Load data from wav file with Alut library */
-    buffer = alutCreateBufferFromFile(filename);
-    if (!buffer){
-        throw(AudioManagerException(std::string("Failed to load wav file")));
-    }
-    CheckForErrors("Failed to load wav file");
-
-    /* Keep track of buffers created */
-    buffer_.push_back(buffer);
-
-    /* Create a source for this buffer */
-    alGenSources((ALuint)1, &source);
-    CheckForErrors("Failed to generate source");
-
-    /* Keep track of sources created */
-    source_.push_back(source);
-
-    /* Return index of last added buffer */
-    return buffer_.size()-1;
-}
-
-
-void AudioManager::PlaySound(int index){
-
-    /* Associate buffer to source */
-    //if (! SoundIsPlaying)
-    alSourcei(source_[index], AL_BUFFER, buffer_[index]);
-    CheckForErrors("Failed to bind buffer");
-
-    /* Play source */
-    alSourcePlay(source_[index]);
-    CheckForErrors("Failed to play source");
-}
-
-
-bool AudioManager::SoundIsPlaying(int index){
-
-    ALint source_state;
-
-    alGetSourcei(source_[index], AL_SOURCE_STATE, &source_state);
-    CheckForErrors("Failed to get source state");
-
-    return (source_state == AL_PLAYING);
-}
-
-
-bool AudioManager::AnySoundIsPlaying(void){
-
-    for (int i = 0; i < source_.size(); i++){
-        if (SoundIsPlaying(i)){
-            return true;
-        }
-    }
-    return false;
-}
-
-
-void AudioManager::ListAudioDevices(void){
-
-    std::cout << "Audio devices:" << std::endl;
-    const ALCchar *devices = alcGetString(NULL, ALC_DEVICE_SPECIFIER);
-    while (((*devices) != 0) && ((*(devices+1)) != 0)){
-        std::cout << (*devices);
-        devices++;
-    }
-}
-
-
-void AudioManager::CheckForErrors(const char *msg){
-
-    ALCenum error;
-
-    error = alGetError();
-
-    if (error != AL_NO_ERROR){
-        throw(AudioManagerException(std::string(msg)));
-    }
-}
-
-
-void AudioManager::SetListenerPosition(double x, double y, double z){
-
-    alListener3f(AL_POSITION, x, y, z);
-    CheckForErrors("Failed to set listener position");
-}
-
-
-void AudioManager::SetSoundPosition(int index, double x, double y, double z){
-
-    alSource3f(source_[index], AL_POSITION, x, y, z);
-    CheckForErrors("Failed to set sound position");
-}
-
-
-void AudioManager::SetLoop(int index, bool loop){
-
-    if (loop){
-        alSourcei(source_[index], AL_LOOPING, AL_TRUE);
-    } else {
-        alSourcei(source_[index], AL_LOOPING, AL_FALSE);
-    }
-    CheckForErrors("Failed to set sound looping flag");
-}
-
-
-} // namespace audio_manager;
+#include <chrono>
+
+#include "audio_manager.h"
+#include "openal_backend.h"
+#include "wav_decoder.h"
+
+namespace audio_manager {
+
+
+AudioManager::AudioManager(void){
+
+    initialized_ = 0;
+    backend_ = NULL;
+    owns_backend_ = false;
+
+    running_ = false;
+    threaded_ = false;
+    for (int i = 0; i < AUDIO_MAX_SOUNDS; i++){
+        sound_playing_[i] = false;
+    }
+    any_playing_ = false;
+    failed_ = false;
+}
+
+
+AudioManager::~AudioManager(){
+
+    if (initialized_){
+        ShutDown();
+    }
+}
+
+
+void AudioManager::Init(const char *device_name){
+
+    if (!initialized_){
+        /* Open the device through OpenAL, the manager keeps the backend */
+        OpenAlBackend *backend = new OpenAlBackend();
+        try {
+            backend->Open(device_name);
+        }
+        catch (AudioManagerException &e){
+            delete backend;
+            throw;
+        }
+
+        InitWithBackend(backend);
+        owns_backend_ = true;
+    }
+}
+
+
+void AudioManager::InitWithBackend(AudioBackend *backend){
+
+    if (!initialized_){
+        backend_ = backend;
+        owns_backend_ = false;
+
+        /* Make the sources the sounds share */
+        voices_.Init(backend_);
+        CheckForErrors("Failed to generate sources");
+
+        /* Remember that we initialized the audio system */
+        initialized_ = 1;
+    }
+}
+
+
+void AudioManager::ShutDown(void){
+
+    if (initialized_){
+
+        /* Take the backend back from the audio thread first */
+        if (threaded_){
+            running_ = false;
+            thread_.join();
+            threaded_ = false;
+        }
+
+        /* The streams have to let go of their sources before the backend goes */
+        for (int i = 0; i < stream_.size(); i++){
+            delete stream_[i];
+        }
+        stream_.clear();
+
+        voices_.ShutDown();
+        for (int i = 0; i < buffer_.size(); i++){
+            backend_->DeleteBuffer(buffer_[i]);
+        }
+        buffer_.clear();
+        sound_.clear();
+
+        if (owns_backend_){
+            delete backend_;
+        }
+        backend_ = NULL;
+        owns_backend_ = false;
+
+        initialized_ = 0;
+    }
+}
+
+
+int AudioManager::AddSound(const char *filename){
+
+    /* The audio thread reads the sounds without locking, they cant change under it */
+    if (threaded_){
+        throw(AudioManagerException(std::string("Sounds have to be added before the audio thread starts")));
+    }
+    if (sound_.size() >= AUDIO_MAX_SOUNDS){
+        throw(AudioManagerException(std::string("Too many sounds")));
+    }
+
+    /* Decode the whole wav file, it throws if the file is no good */
+    WavDecoder decoder;
+    decoder.Open(filename);
+    std::vector<int16_t> samples(decoder.GetFrames() * decoder.GetChannels());
+    int frames = samples.empty() ? 0 : decoder.Read(&samples[0], decoder.GetFrames());
+    if (frames == 0){
+        throw(AudioManagerException(std::string("Failed to load wav file")));
+    }
+
+    unsigned int buffer = backend_->CreateBuffer();
+    backend_->SetBufferData(buffer, &samples[0], frames, decoder.GetChannels(), decoder.GetSampleRate());
+    CheckForErrors("Failed to load wav file");
+
+    /* Keep track of buffers created */
+    buffer_.push_back(buffer);
+
+    /* The pool needs to know how long a play lasts and whether it can be placed */
+    SoundInfo info;
+    info.channels = decoder.GetChannels();
+    info.length = static_cast<double>(frames) / decoder.GetSampleRate();
+    info.x = info.y = info.z = 0.0;
+    info.loop = false;
+    info.priority = VOICE_PRIORITY_NORMAL;
+    sound_.push_back(info);
+
+    /* Return index of last added buffer */
+    return buffer_.size()-1;
+}
+
+
+void AudioManager::PlaySound(int index){
+
+    if (index < 0 || index >= sound_.size()) return;
+
+    /* value 0, the voice goes wherever the sound is when the command runs */
+    AudioCommand command = { AUDIO_COMMAND_PLAY_SOUND, index, 0, 0.0, 0.0, 0.0 };
+    Send(command);
+}
+
+
+void AudioManager::PlaySound(int index, double x, double y, double z){
+
+    if (index < 0 || index >= sound_.size()) return;
+
+    AudioCommand command = { AUDIO_COMMAND_PLAY_SOUND, index, 1, x, y, z };
+    Send(command);
+}
+
+
+void AudioManager::StopSound(int index){
+
+    if (index < 0 || index >= sound_.size()) return;
+
+    AudioCommand command = { AUDIO_COMMAND_STOP_SOUND, index, 0, 0.0, 0.0, 0.0 };
+    Send(command);
+}
+
+
+bool AudioManager::SoundIsPlaying(int index){
+
+    if (index < 0 || index >= sound_.size()) return false;
+    return sound_playing_[index];
+}
+
+
+bool AudioManager::AnySoundIsPlaying(void){
+
+    return any_playing_;
+}
+
+
+void AudioManager::ListAudioDevices(void){
+
+    OpenAlBackend::ListDevices();
+}
+
+
+void AudioManager::CheckForErrors(const char *msg){
+
+    if (backend_->HasError()){
+        throw(AudioManagerException(std::string(msg)));
+    }
+}
+
+
+void AudioManager::SetListenerPosition(double x, double y, double z){
+
+    AudioCommand command = { AUDIO_COMMAND_LISTENER_POSITION, 0, 0, x, y, z };
+    Send(command);
+}
+
+
+void AudioManager::SetSoundPosition(int index, double x, double y, double z){
+
+    if (index < 0 || index >= sound_.size()) return;
+
+    AudioCommand command = { AUDIO_COMMAND_SOUND_POSITION, index, 0, x, y, z };
+    Send(command);
+}
+
+
+void AudioManager::SetLoop(int index, bool loop){
+
+    if (index < 0 || index >= sound_.size()) return;
+
+    AudioCommand command = { AUDIO_COMMAND_SOUND_LOOP, index, loop, 0.0, 0.0, 0.0 };
+    Send(command);
+}
+
+
+void AudioManager::SetSoundPriority(int index, int priority){
+
+    if (index < 0 || index >= sound_.size()) return;
+
+    AudioCommand command = { AUDIO_COMMAND_SOUND_PRIORITY, index, priority, 0.0, 0.0, 0.0 };
+    Send(command);
+}
+
+
+int AudioManager::AddStream(const char *filename, bool loop){
+
+    if (threaded_){
+        throw(AudioManagerException(std::string("Streams have to be added before the audio thread starts")));
+    }
+
+    MusicStream *stream = new MusicStream();
+    try {
+        stream->Open(backend_, filename, loop);
+    }
+    catch (AudioManagerException &e){
+        delete stream;
+        throw;
+    }
+
+    stream_.push_back(stream);
+    return stream_.size()-1;
+}
+
+
+void AudioManager::PlayStream(int index){
+
+    if (index < 0 || index >= stream_.size()) return;
+
+    AudioCommand command = { AUDIO_COMMAND_PLAY_STREAM, index, 0, 0.0, 0.0, 0.0 };
+    Send(command);
+}
+
+
+void AudioManager::StopStream(int index){
+
+    if (index < 0 || index >= stream_.size()) return;
+
+    AudioCommand command = { AUDIO_COMMAND_STOP_STREAM, index, 0, 0.0, 0.0, 0.0 };
+    Send(command);
+}
+
+
+void AudioManager::SetStreamLoop(int index, bool loop){
+
+    if (index < 0 || index >= stream_.size()) return;
+
+    AudioCommand command = { AUDIO_COMMAND_STREAM_LOOP, index, loop, 0.0, 0.0, 0.0 };
+    Send(command);
+}
+
+
+void AudioManager::Start(void){
+
+    if (!initialized_ || threaded_) return;
+
+    /* Say where everything is before the thread takes over */
+    Tick(0.0);
+
+    running_ = true;
+    threaded_ = true;
+    thread_ = std::thread(&AudioManager::Run, this);
+}
+
+
+void AudioManager::Update(double delta_time){
+
+    if (!initialized_) return;
+
+    if (!threaded_){
+        Tick(delta_time);
+        return;
+    }
+
+    /* Errors on the audio thread come out here, on the game thread, where they can be caught */
+    if (failed_){
+        std::string error;
+        {
+            std::lock_guard<std::mutex> lock(error_mutex_);
+            error = error_;
+            failed_ = false;
+        }
+        throw(AudioManagerException(error));
+    }
+}
+
+
+void AudioManager::Send(const AudioCommand &command){
+
+    /* Without a context there is nothing to send it to */
+    if (!initialized_) return;
+
+    if (threaded_){
+        queue_.Push(command);
+    } else {
+        Execute(command);
+    }
+}
+
+
+void AudioManager::Execute(const AudioCommand &command){
+
+    switch (command.type){
+        case AUDIO_COMMAND_PLAY_SOUND: {
+            const SoundInfo &info = sound_[command.index];
+            if (command.value){
+                voices_.Play(buffer_[command.index], info.channels, info.length, command.index, info.priority, 1.0f, info.loop, command.x, command.y, command.z);
+            } else {
+                voices_.Play(buffer_[command.index], info.channels, info.length, command.index, info.priority, 1.0f, info.loop, info.x, info.y, info.z);
+            }
+            break;
+        }
+        case AUDIO_COMMAND_STOP_SOUND:
+            voices_.StopSound(command.index);
+            break;
+        case AUDIO_COMMAND_SOUND_POSITION:
+            sound_[command.index].x = command.x;
+            sound_[command.index].y = command.y;
+            sound_[command.index].z = command.z;
+            break;
+        case AUDIO_COMMAND_SOUND_LOOP:
+            sound_[command.index].loop = command.value != 0;
+            break;
+        case AUDIO_COMMAND_SOUND_PRIORITY:
+            sound_[command.index].priority = command.value;
+            break;
+        case AUDIO_COMMAND_LISTENER_POSITION:
+            backend_->SetListenerPosition(command.x, command.y, command.z);
+            voices_.SetListenerPosition(command.x, command.y, command.z);
+            break;
+        case AUDIO_COMMAND_PLAY_STREAM:
+            stream_[command.index]->Play();
+            break;
+        case AUDIO_COMMAND_STOP_STREAM:
+            stream_[command.index]->Stop();
+            break;
+        case AUDIO_COMMAND_STREAM_LOOP:
+            stream_[command.index]->SetLoop(command.value != 0);
+            break;
+    }
+}
+
+
+void AudioManager::Tick(double delta_time){
+
+    for (int i = 0; i < stream_.size(); i++){
+        stream_[i]->Update();
+    }
+    voices_.Update(delta_time);
+
+    /* One check for everything since the last tick, not one per call */
+    CheckForErrors("Failed to update audio");
+
+    /* Tell the game what is playing now */
+    bool any = false;
+    for (int i = 0; i < sound_.size(); i++){
+        bool playing = voices_.IsPlaying(i);
+        sound_playing_[i].store(playing, std::memory_order_relaxed);
+        any = any || playing;
+    }
+    any_playing_.store(any, std::memory_order_release);
+}
+
+
+void AudioManager::Run(void){
+
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point last = Clock::now();
+
+    while (running_){
+        std::this_thread::sleep_for(std::chrono::milliseconds(AUDIO_THREAD_PERIOD));
+
+        try {
+            AudioCommand command;
+            while (queue_.Pop(command)){
+                Execute(command);
+            }
+
+            /* The voices keep their own time, the game frames dont matter here */
+            Clock::time_point now = Clock::now();
+            double delta_time = std::chrono::duration<double>(now - last).count();
+            last = now;
+            Tick(delta_time);
+        }
+        catch (AudioManagerException &e){
+            std::lock_guard<std::mutex> lock(error_mutex_);
+            error_ = e.what();
+            failed_ = true;
+        }
+    }
+}
+
+
+} // namespace audio_manager;
@@ -1,78 +1,159 @@
-#ifndef AUDIO_MANAGER_H_
-#define AUDIO_MANAGER_H_
-
-#include <stdio.h>
-#include <stdlib.h>
-
-#include <AL/al.h>
-#include <AL/alc.h>
-#include <AL/alut.h>
-
-#include <exception>
-#include <iostream>
-#include <vector>
-
-namespace audio_manager {
-
-    // Audio manager exception type
-    class AudioManagerException: public std::exception
-    {
-        private:
-            std::string message_;
-        public:
-            AudioManagerException(std::string message) : message_(message) {};
-            ~AudioManagerException() throw () {};
-            virtual const char* what() const throw() { return message_.c_str(); };
-    };
-
-    // A simple audio manager implemented with OpenAl
-    class AudioManager {
-        public:
-            AudioManager(void);
-            ~AudioManager();
-            /* Initialize the audio system. device_name is the name of
-             * the audio device to be used. If the default device should
-             * be used, set device_name to NULL. */
-            void Init(const char *device_name);
-            // Shut down the audio system
-            void ShutDown(void);
-            /* Load a wav audio file and add its contents to a buffer.
-             * The buffer can then be played multiple times with
-             * PlaySound. AddSound returns the index of the file in
-             * the list of buffers. This index should be passed to
-             * PlaySound to play the respective file */
-            int AddSound(const char *filename);
-            // Play buffer with specific index
-            void PlaySound(int index);
-            // Check if the buffer with the given index is being played
-            bool SoundIsPlaying(int index);
-            // Check if any buffer is being played
-            bool AnySoundIsPlaying(void);
-            // List all audio devices available to standard output
-            void ListAudioDevices(void);
-            // Set spatial position of listener
-            void SetListenerPosition(double x, double y, double z);
-            /* Set spatial position of a sound. Same index as used for
-             * PlaySound */
-            void SetSoundPosition(int index, double x, double y, double z);
-            // Set whether sound should be looped
-            void SetLoop(int index, bool loop);
-
-        private:
-            // Audio context used by OpenAl
-            ALCcontext *context_;
-            // All the buffers we can play
-            std::vector<ALuint> buffer_;
-            // One source for each buffer
-            std::vector<ALuint> source_;
-
-            // Keep track if we already initialized the audio manager
-            int initialized_;
-
-            // Auxiliary method to handle OpenAl errors
-            void CheckForErrors(const char *msg);
-    }; 
-
-} // namespace audio_manager;
-
-#endif // AUDIO_MANAGER_H_
+#ifndef AUDIO_MANAGER_H_
+#define AUDIO_MANAGER_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <exception>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "audio_backend.h"
+#include "audio_queue.h"
+#include "music_stream.h"
+#include "voice_pool.h"
+
+// how many sounds can be loaded, the audio thread reports back on each one
+#define AUDIO_MAX_SOUNDS 64
+
+// how long the audio thread sleeps between updates, in milliseconds
+#define AUDIO_THREAD_PERIOD 5
+
+namespace audio_manager {
+
+    // Audio manager exception type
+    class AudioManagerException: public std::exception
+    {
+        private:
+            std::string message_;
+        public:
+            AudioManagerException(std::string message) : message_(message) {};
+            ~AudioManagerException() throw () {};
+            virtual const char* what() const throw() { return message_.c_str(); };
+    };
+
+    /* A simple audio manager, played through OpenAl or any other
+     * AudioBackend
+     * Once Start has been called the backend is only ever touched by the
+     * audio thread: the calls below just queue a command for it, and
+     * what they ask about is what it last reported back. So playing
+     * a sound never waits on the backend (or on alGetError) */
+    class AudioManager {
+        public:
+            AudioManager(void);
+            ~AudioManager();
+            /* Initialize the audio system. device_name is the name of
+             * the audio device to be used. If the default device should
+             * be used, set device_name to NULL. */
+            void Init(const char *device_name);
+            /* Initialize the audio system on a backend made elsewhere,
+             * like a SoftwareMixer to hear it without a device. The
+             * backend has to outlive the manager */
+            void InitWithBackend(AudioBackend *backend);
+            // Shut down the audio system
+            void ShutDown(void);
+            /* Load a wav audio file and add its contents to a buffer.
+             * The buffer can then be played multiple times with
+             * PlaySound. AddSound returns the index of the file in
+             * the list of buffers. This index should be passed to
+             * PlaySound to play the respective file */
+            int AddSound(const char *filename);
+            /* Play buffer with specific index. Every call gets its own
+             * voice from the pool, so the same sound can overlap itself */
+            void PlaySound(int index);
+            // Play a buffer at a position instead of the sounds own
+            void PlaySound(int index, double x, double y, double z);
+            // Stop every voice playing a buffer
+            void StopSound(int index);
+            /* Check if the buffer with the given index is being played,
+             * as of the last update (a sound just played wont show yet) */
+            bool SoundIsPlaying(int index);
+            // Check if any buffer is being played
+            bool AnySoundIsPlaying(void);
+            // List all audio devices available to standard output
+            void ListAudioDevices(void);
+            // Set spatial position of listener
+            void SetListenerPosition(double x, double y, double z);
+            /* Set spatial position of a sound. Same index as used for
+             * PlaySound, it applies to the plays after this */
+            void SetSoundPosition(int index, double x, double y, double z);
+            // Set whether sound should be looped
+            void SetLoop(int index, bool loop);
+            /* Set how important a sound is (VOICE_PRIORITY_), when
+             * there are more voices than sources the more important
+             * ones are heard */
+            void SetSoundPriority(int index, int priority);
+            /* Open a long wav file (music) to be streamed instead of
+             * loaded, it is decoded on a thread while it plays so
+             * loading it is quick and it only takes a fixed amount of
+             * memory. AddStream returns the index to pass to the
+             * Stream functions */
+            int AddStream(const char *filename, bool loop = false);
+            // Play or stop the stream with a specific index
+            void PlayStream(int index);
+            void StopStream(int index);
+            // Set whether a stream starts over when it ends
+            void SetStreamLoop(int index, bool loop);
+            /* Hand the backend over to the audio thread. Everything has to be
+             * loaded with AddSound and AddStream before this */
+            void Start(void);
+            /* Call once a frame. Without the audio thread this keeps the
+             * streams fed and hands the sources to the voices that
+             * matter most, with it it only throws whatever went wrong
+             * on the audio thread since the last call */
+            void Update(double delta_time);
+
+        private:
+            // What plays the sounds, and whether Init made it
+            AudioBackend *backend_;
+            bool owns_backend_;
+            // All the buffers we can play
+            std::vector<unsigned int> buffer_;
+            // What each buffer is played with: its channels, length in seconds, position, looping and priority
+            struct SoundInfo {
+                int channels;
+                double length;
+                double x, y, z;
+                bool loop;
+                int priority;
+            };
+            std::vector<SoundInfo> sound_;
+            // The sources every play request shares
+            VoicePool voices_;
+            // The streamed sounds, each with its own source
+            std::vector<MusicStream*> stream_;
+
+            // Keep track if we already initialized the audio manager
+            int initialized_;
+
+            // The audio thread and the commands waiting for it
+            AudioQueue queue_;
+            std::thread thread_;
+            std::atomic<bool> running_;
+            bool threaded_;
+            // What the audio thread reports back after each update
+            std::atomic<bool> sound_playing_[AUDIO_MAX_SOUNDS];
+            std::atomic<bool> any_playing_;
+            // The last error on the audio thread, for Update to throw
+            std::mutex error_mutex_;
+            std::string error_;
+            std::atomic<bool> failed_;
+
+            // Auxiliary method to handle OpenAl errors
+            void CheckForErrors(const char *msg);
+            // Run a command now, or queue it for the audio thread
+            void Send(const AudioCommand &command);
+            // Carry out a command
+            void Execute(const AudioCommand &command);
+            // Move the streams and voices along and report back
+            void Tick(double delta_time);
+            // What the audio thread runs
+            void Run(void);
+    }; 
+
+} // namespace audio_manager;
+
+#endif // AUDIO_MANAGER_H_
@@ -0,0 +1,39 @@
+#include "audio_queue.h"
+
+namespace audio_manager {
+
+AudioQueue::AudioQueue(void)
+{
+    write_ = 0;
+    read_ = 0;
+    dropped_ = 0;
+}
+
+
+bool AudioQueue::Push(const AudioCommand &command)
+{
+    long long write = write_.load(std::memory_order_relaxed);
+    if (write - read_.load(std::memory_order_acquire) >= AUDIO_QUEUE_SIZE)
+    {
+        // better to lose a sound than to hold up the frame
+        dropped_++;
+        return false;
+    }
+
+    commands_[write % AUDIO_QUEUE_SIZE] = command;
+    write_.store(write + 1, std::memory_order_release);
+    return true;
+}
+
+
+bool AudioQueue::Pop(AudioCommand &command)
+{
+    long long read = read_.load(std::memory_order_relaxed);
+    if (read == write_.load(std::memory_order_acquire)) return false;
+
+    command = commands_[read % AUDIO_QUEUE_SIZE];
+    read_.store(read + 1, std::memory_order_release);
+    return true;
+}
+
+} // namespace audio_manager
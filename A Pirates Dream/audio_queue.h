@@ -0,0 +1,64 @@
+#ifndef AUDIO_QUEUE_H_
+#define AUDIO_QUEUE_H_
+
+#include <atomic>
+
+// how many commands can be waiting for the audio thread, any more in one go are dropped
+#define AUDIO_QUEUE_SIZE 256
+
+// what a command asks the audio thread to do
+#define AUDIO_COMMAND_PLAY_SOUND 0
+#define AUDIO_COMMAND_STOP_SOUND 1
+#define AUDIO_COMMAND_SOUND_POSITION 2
+#define AUDIO_COMMAND_SOUND_LOOP 3
+#define AUDIO_COMMAND_SOUND_PRIORITY 4
+#define AUDIO_COMMAND_LISTENER_POSITION 5
+#define AUDIO_COMMAND_PLAY_STREAM 6
+#define AUDIO_COMMAND_STOP_STREAM 7
+#define AUDIO_COMMAND_STREAM_LOOP 8
+
+namespace audio_manager {
+
+    // One call the game made, carried out later on the audio thread
+    // index is the sound or stream, value is a flag or a priority and x y z a position, whichever the type needs
+    struct AudioCommand {
+        int type;
+        int index;
+        int value;
+        double x, y, z;
+    };
+
+    /*
+        The commands on their way from the game thread to the audio thread
+        Only the game pushes and only the audio thread pops, so like the music streams ring each side just
+        counts what it has done and neither ever waits for the other
+    */
+    class AudioQueue {
+
+        public:
+            // Constructor
+            AudioQueue(void);
+
+            // Add a command from the game thread, false if the queue was full and it was dropped
+            bool Push(const AudioCommand &command);
+
+            // Take the oldest command on the audio thread, false if there isnt one
+            bool Pop(AudioCommand &command);
+
+            // How many commands have been dropped so far
+            inline int GetDropped(void) const { return dropped_; }
+
+        private:
+            AudioCommand commands_[AUDIO_QUEUE_SIZE];
+
+            // commands ever pushed and popped
+            std::atomic<long long> write_;
+            std::atomic<long long> read_;
+
+            int dropped_;
+
+    }; // class AudioQueue
+
+} // namespace audio_manager
+
+#endif // AUDIO_QUEUE_H_
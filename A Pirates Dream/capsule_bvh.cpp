@@ -0,0 +1,251 @@
+#include <algorithm>
+#include <cmath>
+
+#include "capsule_bvh.h"
+#include "collision.h"
+
+// deep enough for a balanced tree over far more capsules than we will ever have
+#define BVH_STACK_SIZE 64
+
+namespace game {
+
+// Where the step from start to start + step enters a box, false if it misses it
+static bool StepHitsBox(const glm::vec2 &start, const glm::vec2 &step, const glm::vec2 &min, const glm::vec2 &max, float &entry)
+{
+    float t_min = 0.0f;
+    float t_max = 1.0f;
+    for (int axis = 0; axis < 2; axis++)
+    {
+        float origin = axis == 0 ? start.x : start.y;
+        float direction = axis == 0 ? step.x : step.y;
+        float low = axis == 0 ? min.x : min.y;
+        float high = axis == 0 ? max.x : max.y;
+
+        if (fabs(direction) < 1e-12f)
+        {
+            // running parallel to the slab, either inside it the whole way or never
+            if (origin < low || origin > high) return false;
+            continue;
+        }
+
+        float t1 = (low - origin) / direction;
+        float t2 = (high - origin) / direction;
+        if (t1 > t2) std::swap(t1, t2);
+        if (t1 > t_min) t_min = t1;
+        if (t2 < t_max) t_max = t2;
+        if (t_min > t_max) return false;
+    }
+
+    entry = t_min;
+    return true;
+}
+
+
+CapsuleBvh::CapsuleBvh(void)
+{
+}
+
+
+void CapsuleBvh::Clear(void)
+{
+    a_.clear();
+    b_.clear();
+    radius_.clear();
+    nodes_.clear();
+    order_.clear();
+}
+
+
+int CapsuleBvh::AddCapsule(const glm::vec2 &a, const glm::vec2 &b, float radius)
+{
+    a_.push_back(a);
+    b_.push_back(b);
+    radius_.push_back(radius);
+    return radius_.size() - 1;
+}
+
+
+void CapsuleBvh::SetCapsule(int id, const glm::vec2 &a, const glm::vec2 &b)
+{
+    a_[id] = a;
+    b_[id] = b;
+}
+
+
+void CapsuleBvh::Build(void)
+{
+    nodes_.clear();
+    if (radius_.empty()) return;
+
+    // a tree over n leaves always has 2n - 1 nodes
+    nodes_.reserve(2 * radius_.size() - 1);
+
+    order_.resize(radius_.size());
+    for (int i = 0; i < order_.size(); i++)
+    {
+        order_[i] = i;
+    }
+
+    BuildNode(0, order_.size());
+}
+
+
+int CapsuleBvh::BuildNode(int first, int count)
+{
+    int index = nodes_.size();
+    nodes_.push_back(Node());
+
+    if (count == 1)
+    {
+        nodes_[index].capsule = order_[first];
+        nodes_[index].right = -1;
+        CapsuleBox(order_[first], nodes_[index].min, nodes_[index].max);
+        return index;
+    }
+
+    // split at the median along whichever axis the centres are most spread out on
+    glm::vec2 low(1e30f, 1e30f);
+    glm::vec2 high(-1e30f, -1e30f);
+    for (int i = first; i < first + count; i++)
+    {
+        glm::vec2 centre = (a_[order_[i]] + b_[order_[i]]) * 0.5f;
+        low = glm::min(low, centre);
+        high = glm::max(high, centre);
+    }
+    bool split_x = high.x - low.x >= high.y - low.y;
+
+    int half = count / 2;
+    std::nth_element(order_.begin() + first, order_.begin() + first + half, order_.begin() + first + count, [this, split_x](int l, int r) {
+        glm::vec2 cl = a_[l] + b_[l];
+        glm::vec2 cr = a_[r] + b_[r];
+        return split_x ? cl.x < cr.x : cl.y < cr.y;
+    });
+
+    nodes_[index].capsule = -1;
+    BuildNode(first, half);
+    nodes_[index].right = BuildNode(first + half, count - half);
+
+    nodes_[index].min = glm::min(nodes_[index + 1].min, nodes_[nodes_[index].right].min);
+    nodes_[index].max = glm::max(nodes_[index + 1].max, nodes_[nodes_[index].right].max);
+    return index;
+}
+
+
+void CapsuleBvh::Refit(void)
+{
+    for (int i = nodes_.size() - 1; i >= 0; i--)
+    {
+        Node &node = nodes_[i];
+        if (node.capsule >= 0)
+        {
+            CapsuleBox(node.capsule, node.min, node.max);
+        }
+        else
+        {
+            node.min = glm::min(nodes_[i + 1].min, nodes_[node.right].min);
+            node.max = glm::max(nodes_[i + 1].max, nodes_[node.right].max);
+        }
+    }
+}
+
+
+int CapsuleBvh::Raycast(const glm::vec2 &start, const glm::vec2 &step) const
+{
+    if (nodes_.empty()) return -1;
+
+    glm::vec2 end = start + step;
+    int best = -1;
+    float best_s = 2.0f;
+
+    int stack[BVH_STACK_SIZE];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0)
+    {
+        int index = stack[--top];
+        const Node &node = nodes_[index];
+
+        // nothing in a box we only reach after the best hit so far can beat it
+        float entry;
+        if (!StepHitsBox(start, step, node.min, node.max, entry) || entry > best_s) continue;
+
+        if (node.capsule >= 0)
+        {
+            float s;
+            float radius = radius_[node.capsule];
+            if (SegmentSegmentDistanceSquared(start, end, a_[node.capsule], b_[node.capsule], s) <= radius * radius && s < best_s)
+            {
+                best = node.capsule;
+                best_s = s;
+            }
+        }
+        else if (top + 2 <= BVH_STACK_SIZE)
+        {
+            stack[top++] = node.right;
+            stack[top++] = index + 1;
+        }
+    }
+
+    return best;
+}
+
+
+int CapsuleBvh::OverlapCircle(const glm::vec2 &centre, float radius) const
+{
+    if (nodes_.empty()) return -1;
+
+    int stack[BVH_STACK_SIZE];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0)
+    {
+        int index = stack[--top];
+        const Node &node = nodes_[index];
+
+        // the closest point of the box to the centre
+        glm::vec2 closest = glm::max(node.min, glm::min(centre, node.max));
+        glm::vec2 offset = centre - closest;
+        if (glm::dot(offset, offset) > radius * radius) continue;
+
+        if (node.capsule >= 0)
+        {
+            float reach = radius + radius_[node.capsule];
+            if (PointSegmentDistanceSquared(centre, a_[node.capsule], b_[node.capsule]) <= reach * reach) return node.capsule;
+        }
+        else if (top + 2 <= BVH_STACK_SIZE)
+        {
+            stack[top++] = node.right;
+            stack[top++] = index + 1;
+        }
+    }
+
+    return -1;
+}
+
+
+void CapsuleBvh::CapsuleBox(int id, glm::vec2 &min, glm::vec2 &max) const
+{
+    glm::vec2 r(radius_[id], radius_[id]);
+    min = glm::min(a_[id], b_[id]) - r;
+    max = glm::max(a_[id], b_[id]) + r;
+}
+
+
+void CapsuleBvh::Save(Snapshot &snapshot) const
+{
+    snapshot.WriteVector(a_);
+    snapshot.WriteVector(b_);
+    snapshot.WriteVector(radius_);
+    snapshot.WriteVector(nodes_);
+}
+
+
+void CapsuleBvh::Load(Snapshot &snapshot)
+{
+    snapshot.ReadVector(a_);
+    snapshot.ReadVector(b_);
+    snapshot.ReadVector(radius_);
+    snapshot.ReadVector(nodes_);
+}
+
+} // namespace game
@@ -0,0 +1,87 @@
+#ifndef CAPSULE_BVH_H_
+#define CAPSULE_BVH_H_
+
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "snapshot.h"
+
+namespace game {
+
+    /*
+        A bounding volume hierarchy over a set of capsules (a segment with a radius), used to collide against
+        the pieces of an articulated object like the kraken: its head is a capsule with both ends in the same place
+        and each tentacle link is one from joint to joint
+        The tree is built once over the capsules as they are when Build() is called, after that only the boxes
+        are refit as the capsules move. The links of an arm stay next to each other however it bends so the
+        tree stays good enough, and a refit is one pass over the nodes with no allocation
+        A query only looks at the capsules whose boxes it touches, so the cost grows with the depth of the tree
+        rather than with the number of pieces
+    */
+    class CapsuleBvh {
+
+        public:
+            // Constructor
+            CapsuleBvh(void);
+
+            // Remove every capsule and the tree
+            void Clear(void);
+
+            // Add a capsule, returns its id (ids count up from 0 in the order they are added)
+            int AddCapsule(const glm::vec2 &a, const glm::vec2 &b, float radius);
+
+            // Move a capsule, the tree only sees it after the next Refit()
+            void SetCapsule(int id, const glm::vec2 &a, const glm::vec2 &b);
+
+            // Build the tree over the capsules where they are now
+            void Build(void);
+
+            // Fit the boxes back around the capsules after they moved
+            void Refit(void);
+
+            // Save or restore the capsules and the tree as it was built, a rebuild could come out a different shape
+            void Save(Snapshot &snapshot) const;
+            void Load(Snapshot &snapshot);
+
+            // The capsule the step from start to start + step runs into first, -1 if it misses them all
+            int Raycast(const glm::vec2 &start, const glm::vec2 &step) const;
+
+            // A capsule that overlaps the circle, -1 if none do
+            int OverlapCircle(const glm::vec2 &centre, float radius) const;
+
+            // Getters
+            inline int GetNumCapsules(void) const { return radius_.size(); }
+            inline bool IsBuilt(void) const { return !nodes_.empty(); }
+
+        private:
+            // A box in the tree, internal nodes have their left child right after them and the index of the right
+            // one in right, leaves hold the id of one capsule
+            struct Node {
+                glm::vec2 min;
+                glm::vec2 max;
+                int right;
+                int capsule;
+            };
+
+            // the capsules
+            std::vector<glm::vec2> a_;
+            std::vector<glm::vec2> b_;
+            std::vector<float> radius_;
+
+            // the tree, every child comes after its parent so refitting backwards does the children first
+            std::vector<Node> nodes_;
+
+            // scratch list of capsule ids the build sorts
+            std::vector<int> order_;
+
+            // Build the subtree over order_[first] to order_[first + count - 1], returns its node
+            int BuildNode(int first, int count);
+
+            // The box around one capsule
+            void CapsuleBox(int id, glm::vec2 &min, glm::vec2 &max) const;
+
+    }; // class CapsuleBvh
+
+} // namespace game
+
+#endif // CAPSULE_BVH_H_
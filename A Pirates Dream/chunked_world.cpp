@@ -0,0 +1,257 @@
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include "chunked_world.h"
+
+namespace game {
+
+ChunkedWorld::ChunkedWorld(void)
+{
+    chunk_width_ = 12.0f;
+    activate_radius_ = 1;
+    deactivate_radius_ = 2;
+}
+
+
+ChunkedWorld::~ChunkedWorld()
+{
+    if (file_.is_open()) file_.close();
+}
+
+
+void ChunkedWorld::Load(const std::string &filename)
+{
+    if (file_.is_open()) file_.close();
+    offsets_.clear();
+    cleared_.clear();
+    active_.clear();
+
+    // Open file
+    file_.open(filename.c_str(), std::ios::in | std::ios::binary);
+    if (file_.fail()) {
+        throw(std::ios_base::failure(std::string("Error opening file ") + filename));
+    }
+    filename_ = filename;
+
+    // walk the file once, remembering where every chunk starts
+    std::string line;
+    std::streamoff offset = file_.tellg();
+    while (std::getline(file_, line))
+    {
+        std::istringstream tokens(line);
+        std::string keyword;
+        tokens >> keyword;
+
+        if (keyword == "chunk_width")
+        {
+            tokens >> chunk_width_;
+            if (chunk_width_ <= 0.0f) {
+                throw(std::runtime_error(std::string("Bad chunk width in level file ") + filename));
+            }
+        }
+        else if (keyword == "chunk")
+        {
+            int index = -1;
+            tokens >> index;
+
+            // chunks have to be listed in order so their number is their place in the index
+            if (index != offsets_.size()) {
+                throw(std::runtime_error(std::string("Chunks out of order in level file ") + filename));
+            }
+            offsets_.push_back(offset);
+        }
+
+        offset = file_.tellg();
+    }
+
+    cleared_.resize(offsets_.size());
+    file_.clear();
+}
+
+
+int ChunkedWorld::GetChunkAt(float x) const
+{
+    return static_cast<int>(floor(x / chunk_width_));
+}
+
+
+void ChunkedWorld::ReadChunk(int index, std::vector<ChunkSpawn> &spawns)
+{
+    file_.clear();
+    file_.seekg(offsets_[index]);
+
+    std::string line;
+
+    // skip the chunk header
+    std::getline(file_, line);
+
+    int id = 0;
+    while (std::getline(file_, line))
+    {
+        std::istringstream tokens(line);
+        std::string keyword;
+        tokens >> keyword;
+
+        // we reached the next chunk
+        if (keyword == "chunk") break;
+
+        ChunkSpawn spawn;
+        spawn.chunk = index;
+        spawn.type = 0;
+        spawn.radius = 0.0f;
+
+        float x = 0.0f, y = 0.0f;
+        std::string type;
+
+        if (keyword == "enemy")
+        {
+            tokens >> x >> y >> type;
+            spawn.kind = CHUNK_ENEMY;
+            if (type == "monster") spawn.type = 1;
+        }
+        else if (keyword == "collectible")
+        {
+            tokens >> x >> y >> type;
+            spawn.kind = CHUNK_COLLECTIBLE;
+            if (type == "health") spawn.type = 1;
+            else if (type == "gold") spawn.type = 2;
+        }
+        else if (keyword == "island")
+        {
+            tokens >> x >> y >> spawn.radius;
+            spawn.kind = CHUNK_ISLAND;
+        }
+        else
+        {
+            // blank lines, comments and anything we dont know
+            continue;
+        }
+
+        spawn.id = id++;
+        spawn.position = glm::vec3(x, y, 0.0f);
+        spawns.push_back(spawn);
+    }
+}
+
+
+bool ChunkedWorld::IsCleared(int chunk, int id) const
+{
+    const std::vector<uint64_t> &bits = cleared_[chunk];
+    int word = id / 64;
+    if (word >= bits.size()) return false;
+    return (bits[word] >> (id % 64)) & 1;
+}
+
+
+void ChunkedWorld::MarkCleared(int chunk, int id)
+{
+    if (chunk < 0 || chunk >= cleared_.size()) return;
+
+    std::vector<uint64_t> &bits = cleared_[chunk];
+    int word = id / 64;
+    if (word >= bits.size()) bits.resize(word + 1, 0);
+    bits[word] |= static_cast<uint64_t>(1) << (id % 64);
+}
+
+
+void ChunkedWorld::Update(const glm::vec3 &player_position, std::vector<ChunkSpawn> &activated, std::vector<int> &deactivated)
+{
+    if (!IsLoaded()) return;
+
+    int current = GetChunkAt(player_position.x);
+
+    // drop the chunks weve moved far enough away from
+    for (int i = 0; i < active_.size(); i++)
+    {
+        if (abs(active_[i].index - current) > deactivate_radius_)
+        {
+            deactivated.push_back(active_[i].index);
+            active_.erase(active_.begin() + i);
+            i--;
+        }
+    }
+
+    // bring in the chunks around the player that arent in play yet
+    for (int c = current - activate_radius_; c <= current + activate_radius_; c++)
+    {
+        if (c < 0 || c >= offsets_.size()) continue;
+
+        bool is_active = false;
+        for (int i = 0; i < active_.size(); i++)
+        {
+            if (active_[i].index == c) is_active = true;
+        }
+        if (is_active) continue;
+
+        ActiveChunk chunk;
+        chunk.index = c;
+        ReadChunk(c, chunk.spawns);
+
+        for (int i = 0; i < chunk.spawns.size(); i++)
+        {
+            if (!IsCleared(c, chunk.spawns[i].id)) activated.push_back(chunk.spawns[i]);
+        }
+
+        active_.push_back(chunk);
+    }
+}
+
+
+void ChunkedWorld::GetActiveIslands(std::vector<glm::vec3> &islands) const
+{
+    for (int i = 0; i < active_.size(); i++)
+    {
+        for (int j = 0; j < active_[i].spawns.size(); j++)
+        {
+            const ChunkSpawn &spawn = active_[i].spawns[j];
+            if (spawn.kind == CHUNK_ISLAND) islands.push_back(glm::vec3(spawn.position.x, spawn.position.y, spawn.radius));
+        }
+    }
+}
+
+
+void ChunkedWorld::Save(Snapshot &snapshot) const
+{
+    snapshot.Write(static_cast<int>(cleared_.size()));
+    for (int i = 0; i < cleared_.size(); i++)
+    {
+        snapshot.WriteVector(cleared_[i]);
+    }
+
+    // the active chunks keep their spawns so nothing has to be read from the file again
+    snapshot.Write(static_cast<int>(active_.size()));
+    for (int i = 0; i < active_.size(); i++)
+    {
+        snapshot.Write(active_[i].index);
+        snapshot.WriteVector(active_[i].spawns);
+    }
+}
+
+
+void ChunkedWorld::Load(Snapshot &snapshot)
+{
+    int chunks;
+    snapshot.Read(chunks);
+    if (chunks != cleared_.size())
+    {
+        throw(std::runtime_error(std::string("Snapshot was saved with a different level than ") + filename_));
+    }
+    for (int i = 0; i < chunks; i++)
+    {
+        snapshot.ReadVector(cleared_[i]);
+    }
+
+    int active;
+    snapshot.Read(active);
+    active_.resize(active);
+    for (int i = 0; i < active; i++)
+    {
+        snapshot.Read(active_[i].index);
+        snapshot.ReadVector(active_[i].spawns);
+    }
+}
+
+} // namespace game
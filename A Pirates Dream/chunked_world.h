@@ -0,0 +1,113 @@
+#ifndef CHUNKED_WORLD_H_
+#define CHUNKED_WORLD_H_
+
+#include <glm/glm.hpp>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "snapshot.h"
+
+// the kinds of things a chunk can hold
+#define CHUNK_ENEMY 0
+#define CHUNK_COLLECTIBLE 1
+#define CHUNK_ISLAND 2
+
+namespace game {
+
+    // One thing placed in a chunk of the level file
+    struct ChunkSpawn {
+        // the chunk it belongs to and its index inside that chunk
+        int chunk;
+        int id;
+
+        // CHUNK_ENEMY, CHUNK_COLLECTIBLE or CHUNK_ISLAND
+        int kind;
+
+        // what sort of enemy or collectible it is
+        int type;
+
+        glm::vec3 position;
+
+        // only used by islands
+        float radius;
+    };
+
+    /*
+        ChunkedWorld streams a long level in pieces along the scroll direction (x)
+        Loading the level only indexes where each chunk starts in the file, the contents of a chunk
+        are read when the player comes close enough for it to activate and thrown away again when
+        they leave, so the cost of the level stays the same no matter how long it is
+        Anything the player destroyed or collected is remembered so it doesnt come back
+    */
+    class ChunkedWorld {
+
+        public:
+            // Constructor and destructor
+            ChunkedWorld(void);
+            ~ChunkedWorld();
+
+            // Index a level file, throws if the file cant be read
+            void Load(const std::string &filename);
+
+            // Activate chunks near the player and deactivate the ones left behind
+            // Newly activated spawns are appended to activated and chunks that went away to deactivated
+            void Update(const glm::vec3 &player_position, std::vector<ChunkSpawn> &activated, std::vector<int> &deactivated);
+
+            // Remember that a spawn was destroyed or collected so the chunk wont bring it back
+            void MarkCleared(int chunk, int id);
+
+            // All the islands in the active chunks
+            void GetActiveIslands(std::vector<glm::vec3> &islands) const;
+
+            // Save or restore which chunks are in play and what has been cleared, the level has to be loaded already
+            // Throws if the snapshot was saved with a different level
+            void Save(Snapshot &snapshot) const;
+            void Load(Snapshot &snapshot);
+
+            // Getters
+            inline bool IsLoaded(void) const { return !offsets_.empty(); }
+            inline int GetNumChunks(void) const { return offsets_.size(); }
+            inline int GetNumActiveChunks(void) const { return active_.size(); }
+            inline float GetChunkWidth(void) const { return chunk_width_; }
+            int GetChunkAt(float x) const;
+
+        private:
+            // A chunk that is currently in play
+            struct ActiveChunk {
+                int index;
+                std::vector<ChunkSpawn> spawns;
+            };
+
+            // the level file, kept open so chunks can be read as we reach them
+            std::ifstream file_;
+            std::string filename_;
+
+            // width of a chunk in world units
+            float chunk_width_;
+
+            // where each chunk starts in the file
+            std::vector<std::streamoff> offsets_;
+
+            // one bit per spawn of each chunk that has been cleared (empty until the chunk has been visited)
+            std::vector<std::vector<uint64_t> > cleared_;
+
+            // the chunks in play
+            std::vector<ActiveChunk> active_;
+
+            // how many chunks either side of the player are activated, and how far they can get before being dropped
+            int activate_radius_;
+            int deactivate_radius_;
+
+            // Read the contents of a chunk from the file
+            void ReadChunk(int index, std::vector<ChunkSpawn> &spawns);
+
+            // Check if a spawn was cleared
+            bool IsCleared(int chunk, int id) const;
+
+    }; // class ChunkedWorld
+
+} // namespace game
+
+#endif // CHUNKED_WORLD_H_
@@ -0,0 +1,102 @@
+#include <cmath>
+
+#include "collision.h"
+
+namespace game {
+
+bool SegmentInsideCircle(const glm::vec3 &start, const glm::vec3 &step, const glm::vec3 &centre, float radius_squared)
+{
+    glm::vec3 d = step;
+
+    // vector for the line between the start of the bullets path and the centre of the circle
+    glm::vec3 sc = start - centre;
+
+    double a = glm::dot(d, d);
+    double b = 2 * glm::dot(d, sc);
+    double c = glm::dot(sc, sc) - radius_squared;
+
+    float disc = pow(b, 2) - 4 * a * c;
+    if (disc < 0) return false;
+
+    disc = sqrt(disc);
+
+    float t1 = ((-b) - disc) / (2 * a);
+    float t2 = ((-b) + disc) / (2 * a);
+
+    return t1 <= 0 && t2 >= 1;
+}
+
+
+float PointSegmentDistanceSquared(const glm::vec2 &point, const glm::vec2 &a, const glm::vec2 &b)
+{
+    glm::vec2 ab = b - a;
+    float length_squared = glm::dot(ab, ab);
+
+    // a zero length segment is just a point
+    float t = 0.0f;
+    if (length_squared > 0.0f)
+    {
+        t = glm::clamp(glm::dot(point - a, ab) / length_squared, 0.0f, 1.0f);
+    }
+
+    glm::vec2 offset = point - (a + ab * t);
+    return glm::dot(offset, offset);
+}
+
+
+float SegmentSegmentDistanceSquared(const glm::vec2 &p0, const glm::vec2 &p1, const glm::vec2 &q0, const glm::vec2 &q1, float &s)
+{
+    glm::vec2 d1 = p1 - p0;
+    glm::vec2 d2 = q1 - q0;
+    glm::vec2 r = p0 - q0;
+    float a = glm::dot(d1, d1);
+    float e = glm::dot(d2, d2);
+    float f = glm::dot(d2, r);
+
+    // closest points of the two lines, clamped back onto the segments (Ericson, Real-Time Collision Detection 5.1.9)
+    float t;
+    if (a <= 1e-12f && e <= 1e-12f)
+    {
+        s = 0.0f;
+        t = 0.0f;
+    }
+    else if (a <= 1e-12f)
+    {
+        s = 0.0f;
+        t = glm::clamp(f / e, 0.0f, 1.0f);
+    }
+    else
+    {
+        float c = glm::dot(d1, r);
+        if (e <= 1e-12f)
+        {
+            t = 0.0f;
+            s = glm::clamp(-c / a, 0.0f, 1.0f);
+        }
+        else
+        {
+            float b = glm::dot(d1, d2);
+            float denominator = a * e - b * b;
+
+            // parallel segments can pick any s, the start is as good as any
+            s = denominator != 0.0f ? glm::clamp((b * f - c * e) / denominator, 0.0f, 1.0f) : 0.0f;
+            t = (b * s + f) / e;
+
+            if (t < 0.0f)
+            {
+                t = 0.0f;
+                s = glm::clamp(-c / a, 0.0f, 1.0f);
+            }
+            else if (t > 1.0f)
+            {
+                t = 1.0f;
+                s = glm::clamp((b - c) / a, 0.0f, 1.0f);
+            }
+        }
+    }
+
+    glm::vec2 offset = (p0 + d1 * s) - (q0 + d2 * t);
+    return glm::dot(offset, offset);
+}
+
+} // namespace game
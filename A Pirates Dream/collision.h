@@ -0,0 +1,22 @@
+#ifndef COLLISION_H_
+#define COLLISION_H_
+
+#include <glm/glm.hpp>
+
+namespace game {
+
+    // Check the step an object takes in one tick (from start to start + step) against a circle
+    // Solves for where the line enters and leaves the circle and counts it as a hit when the whole
+    // step lies inside, this is the test bullets use against enemies
+    bool SegmentInsideCircle(const glm::vec3 &start, const glm::vec3 &step, const glm::vec3 &centre, float radius_squared);
+
+    // The squared distance from a point to the segment a to b
+    float PointSegmentDistanceSquared(const glm::vec2 &point, const glm::vec2 &a, const glm::vec2 &b);
+
+    // The squared distance between the segments p0 to p1 and q0 to q1, s is set to how far along the first one
+    // (0 to 1) the closest point is, which is what orders the hits along a bullets path
+    float SegmentSegmentDistanceSquared(const glm::vec2 &p0, const glm::vec2 &p1, const glm::vec2 &q0, const glm::vec2 &q1, float &s);
+
+} // namespace game
+
+#endif // COLLISION_H_
@@ -0,0 +1,255 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <queue>
+#include <utility>
+#include <functional>
+
+#include "flow_field.h"
+
+namespace game {
+
+// how much more a cell costs for every agent that was standing in it
+const float density_weight_g = 0.5f;
+
+// the cost of a cell nobody can reach
+const float unreachable_g = 1e30f;
+
+// the length of a step to a diagonal neighbour
+const float diagonal_g = 1.41421356f;
+
+
+FlowField::FlowField(int size, float cell_size)
+{
+    size_ = size;
+    cell_size_ = cell_size;
+    origin_ = glm::vec2(0.0f, 0.0f);
+
+    int cells = size_ * size_;
+    cost_.assign(cells, unreachable_g);
+    dir_x_.assign(cells, 0.0f);
+    dir_y_.assign(cells, 0.0f);
+    blocked_.assign(cells, 0);
+    density_.assign(cells, 0);
+}
+
+
+int FlowField::CellAt(const glm::vec3 &position) const
+{
+    int x = static_cast<int>(floor((position.x - origin_.x) / cell_size_));
+    int y = static_cast<int>(floor((position.y - origin_.y) / cell_size_));
+
+    if (x < 0 || y < 0 || x >= size_ || y >= size_) return -1;
+
+    return y * size_ + x;
+}
+
+
+void FlowField::AddAgent(const glm::vec3 &position)
+{
+    // the grid may move before the next build, so we only remember where the agent was for now
+    agents_.push_back(glm::vec2(position.x, position.y));
+}
+
+
+void FlowField::AddObstacle(const glm::vec3 &centre, float radius)
+{
+    obstacles_.push_back(glm::vec3(centre.x, centre.y, radius));
+}
+
+
+void FlowField::ClearObstacles(void)
+{
+    obstacles_.clear();
+}
+
+
+void FlowField::Build(const glm::vec3 *goals, int count)
+{
+    if (count <= 0) return;
+    const glm::vec3 &goal = goals[0];
+
+    // snap the grid to whole cells so the field doesnt shimmer as the goal moves
+    float half = 0.5f * size_ * cell_size_;
+    origin_.x = floor((goal.x - half) / cell_size_) * cell_size_;
+    origin_.y = floor((goal.y - half) / cell_size_) * cell_size_;
+
+    int cells = size_ * size_;
+    std::fill(cost_.begin(), cost_.end(), unreachable_g);
+    std::fill(dir_x_.begin(), dir_x_.end(), 0.0f);
+    std::fill(dir_y_.begin(), dir_y_.end(), 0.0f);
+    std::fill(blocked_.begin(), blocked_.end(), 0);
+    std::fill(density_.begin(), density_.end(), 0);
+
+    // count the crowd in each cell of the new grid
+    for (int i = 0; i < agents_.size(); i++)
+    {
+        int cell = CellAt(glm::vec3(agents_[i].x, agents_[i].y, 0.0f));
+        if (cell >= 0 && density_[cell] < 0xffff) density_[cell]++;
+    }
+    agents_.clear();
+
+    // rasterize the obstacles that overlap the grid
+    for (int i = 0; i < obstacles_.size(); i++)
+    {
+        glm::vec3 o = obstacles_[i];
+        int x0 = static_cast<int>(floor((o.x - o.z - origin_.x) / cell_size_));
+        int x1 = static_cast<int>(floor((o.x + o.z - origin_.x) / cell_size_));
+        int y0 = static_cast<int>(floor((o.y - o.z - origin_.y) / cell_size_));
+        int y1 = static_cast<int>(floor((o.y + o.z - origin_.y) / cell_size_));
+
+        for (int y = std::max(y0, 0); y <= std::min(y1, size_ - 1); y++)
+        {
+            for (int x = std::max(x0, 0); x <= std::min(x1, size_ - 1); x++)
+            {
+                // test the centre of the cell against the circle
+                float cx = origin_.x + (x + 0.5f) * cell_size_ - o.x;
+                float cy = origin_.y + (y + 0.5f) * cell_size_ - o.y;
+                if (cx * cx + cy * cy <= o.z * o.z) blocked_[y * size_ + x] = 1;
+            }
+        }
+    }
+
+    // integrate the cost outwards from the goals (dijkstra over the 8 neighbours)
+    typedef std::pair<float, int> Node;
+    std::priority_queue<Node, std::vector<Node>, std::greater<Node> > open;
+
+    for (int i = 0; i < count; i++)
+    {
+        int goal_cell = CellAt(goals[i]);
+        if (goal_cell < 0 || cost_[goal_cell] == 0.0f) continue;
+        cost_[goal_cell] = 0.0f;
+        open.push(Node(0.0f, goal_cell));
+    }
+    if (open.empty()) return;
+
+    const int dx[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+    const int dy[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+    const float step[8] = { 1.0f, 1.0f, 1.0f, 1.0f, diagonal_g, diagonal_g, diagonal_g, diagonal_g };
+
+    while (!open.empty())
+    {
+        Node node = open.top();
+        open.pop();
+
+        // skip stale entries, we already found a cheaper way here
+        if (node.first > cost_[node.second]) continue;
+
+        int x = node.second % size_;
+        int y = node.second / size_;
+
+        for (int n = 0; n < 8; n++)
+        {
+            int nx = x + dx[n];
+            int ny = y + dy[n];
+            if (nx < 0 || ny < 0 || nx >= size_ || ny >= size_) continue;
+
+            int next = ny * size_ + nx;
+            if (blocked_[next]) continue;
+
+            // dont let diagonals cut the corner of a blocked cell
+            if (n >= 4 && (blocked_[y * size_ + nx] || blocked_[ny * size_ + x])) continue;
+
+            float cost = node.first + step[n] * (1.0f + density_weight_g * density_[next]);
+            if (cost < cost_[next])
+            {
+                cost_[next] = cost;
+                open.push(Node(cost, next));
+            }
+        }
+    }
+
+    // every cell points at its cheapest neighbour
+    for (int cell = 0; cell < cells; cell++)
+    {
+        // a goal is the only cell that costs nothing to reach
+        if (blocked_[cell] || cost_[cell] == 0.0f || cost_[cell] >= unreachable_g) continue;
+
+        int x = cell % size_;
+        int y = cell / size_;
+        float best = cost_[cell];
+        int best_n = -1;
+
+        for (int n = 0; n < 8; n++)
+        {
+            int nx = x + dx[n];
+            int ny = y + dy[n];
+            if (nx < 0 || ny < 0 || nx >= size_ || ny >= size_) continue;
+            if (n >= 4 && (blocked_[y * size_ + nx] || blocked_[ny * size_ + x])) continue;
+
+            float c = cost_[ny * size_ + nx];
+            if (c < best)
+            {
+                best = c;
+                best_n = n;
+            }
+        }
+
+        if (best_n >= 0)
+        {
+            float length = step[best_n];
+            dir_x_[cell] = dx[best_n] / length;
+            dir_y_[cell] = dy[best_n] / length;
+        }
+    }
+}
+
+
+bool FlowField::Sample(const glm::vec3 &position, glm::vec3 &direction) const
+{
+    int cell = CellAt(position);
+    if (cell < 0) return false;
+
+    if (dir_x_[cell] == 0.0f && dir_y_[cell] == 0.0f) return false;
+
+    direction = glm::vec3(dir_x_[cell], dir_y_[cell], 0.0f);
+    return true;
+}
+
+
+void FlowField::Save(Snapshot &snapshot) const
+{
+    snapshot.Write(origin_);
+
+    // every direction points at one of the 8 neighbours (or nowhere), so a cell fits in a byte as 3 * (dx + 1) + (dy + 1)
+    std::vector<unsigned char> cells(size_ * size_);
+    for (int cell = 0; cell < cells.size(); cell++)
+    {
+        int x = dir_x_[cell] > 0.0f ? 1 : (dir_x_[cell] < 0.0f ? -1 : 0);
+        int y = dir_y_[cell] > 0.0f ? 1 : (dir_y_[cell] < 0.0f ? -1 : 0);
+        cells[cell] = static_cast<unsigned char>(3 * (x + 1) + (y + 1));
+    }
+    snapshot.WriteVector(cells);
+
+    snapshot.WriteVector(agents_);
+    snapshot.WriteVector(obstacles_);
+}
+
+
+void FlowField::Load(Snapshot &snapshot)
+{
+    snapshot.Read(origin_);
+
+    std::vector<unsigned char> cells;
+    snapshot.ReadVector(cells);
+    if (cells.size() != size_ * size_)
+    {
+        throw(std::runtime_error(std::string("Snapshot has a flow field of a different size")));
+    }
+
+    // divided out the same way Build does it so the directions come back to the bit
+    for (int cell = 0; cell < cells.size(); cell++)
+    {
+        int x = cells[cell] / 3 - 1;
+        int y = cells[cell] % 3 - 1;
+        float length = (x != 0 && y != 0) ? diagonal_g : 1.0f;
+        dir_x_[cell] = x / length;
+        dir_y_[cell] = y / length;
+    }
+
+    snapshot.ReadVector(agents_);
+    snapshot.ReadVector(obstacles_);
+}
+
+} // namespace game
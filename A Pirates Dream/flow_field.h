@@ -0,0 +1,83 @@
+#ifndef FLOW_FIELD_H_
+#define FLOW_FIELD_H_
+
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "snapshot.h"
+
+namespace game {
+
+    /*
+        FlowField steers a whole crowd of enemies towards one goal (the player), or the nearest of a few
+        Build runs a single integration pass over a grid centred on the (first) goal, after which
+        any number of agents can look up their steering direction in constant time
+        Cells can be blocked by obstacles (islands) and crowded cells cost more to cross,
+        which spreads the agents out instead of letting them pile up on the same path
+    */
+    class FlowField {
+
+        public:
+            // Constructor, size is the number of cells along each side and cell_size their width in world units
+            FlowField(int size = 64, float cell_size = 0.25f);
+
+            // Integrate costs out from the goal and work out a direction for every cell
+            inline void Build(const glm::vec3 &goal) { Build(&goal, 1); }
+
+            // Same with several goals at once, every cell points towards whichever is cheapest to reach
+            void Build(const glm::vec3 *goals, int count);
+
+            // Look up the steering direction at a position, returns false when the position is off the grid
+            // or already at the goal so the caller can fall back to steering directly
+            bool Sample(const glm::vec3 &position, glm::vec3 &direction) const;
+
+            // Record an agent standing at a position, used to make crowded cells more expensive on the next build
+            void AddAgent(const glm::vec3 &position);
+
+            // Obstacles are kept in world space and rasterized into the grid on every build
+            void AddObstacle(const glm::vec3 &centre, float radius);
+            void ClearObstacles(void);
+
+            // Save or restore the field as it was last built along with the agents and obstacles for the next build
+            void Save(Snapshot &snapshot) const;
+            void Load(Snapshot &snapshot);
+
+            // Getters
+            inline int GetSize(void) const { return size_; }
+            inline float GetCellSize(void) const { return cell_size_; }
+
+        private:
+            // grid dimensions
+            int size_;
+            float cell_size_;
+
+            // world position of the corner of cell 0
+            glm::vec2 origin_;
+
+            // the integrated cost to reach the goal from each cell
+            std::vector<float> cost_;
+
+            // the steering direction of each cell, kept in two arrays so lookups touch as little memory as possible
+            std::vector<float> dir_x_;
+            std::vector<float> dir_y_;
+
+            // whether a cell is blocked
+            std::vector<unsigned char> blocked_;
+
+            // how many agents were standing in each cell when we last built
+            std::vector<unsigned short> density_;
+
+            // where the agents were standing since the last build
+            std::vector<glm::vec2> agents_;
+
+            // the obstacle circles (x, y, radius)
+            std::vector<glm::vec3> obstacles_;
+
+            // turn a world position into a cell index, -1 if its off the grid
+            int CellAt(const glm::vec3 &position) const;
+
+    }; // class FlowField
+
+} // namespace game
+
+#endif // FLOW_FIELD_H_
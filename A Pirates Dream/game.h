@@ -1,163 +1,188 @@
-#ifndef GAME_H_
-#define GAME_H_
-
-#define GLEW_STATIC
-#include <GL/glew.h>
-#include <GLFW/glfw3.h>
-#include <vector>
-#include <time.h>
-#include <stdlib.h>
-
-#include "shader.h"
-#include "game_object.h"
-#include "player_game_object.h"
-#include "enemy_game_object.h"
-#include "collectible_game_object.h"
-#include "projectile_game_object.h"
-#include "child_game_object.h"
-#include "timer.h"
-#include "audio_manager.h"
-
-#define PrintException(exception_object)\
-    std::cerr << exception_object.what() << std::endl
-
-namespace game {
-
-    // A class for holding the main game objects
-    class Game {
-
-        public:
-            // Constructor and destructor
-            Game(void);
-            ~Game();
-
-            // Call Init() before calling any other method
-            // Initialize graphics libraries and main window
-            void Init(void); 
-
-            // Set up the game (scene, game objects, etc.)
-            void Setup(void);
-
-            // Run the game (keep the game active)
-            void MainLoop(void); 
-
-        private:
-            // Main window: pointer to the GLFW window structure
-            GLFWwindow *window_;
-
-            // Sprite geometry
-            Geometry *sprite_;
-
-            // Particle geometry
-            Geometry *bullet_particles_;
-
-            Geometry *explosion_particles_;
-
-            // Shader for rendering sprites in the scene
-            Shader sprite_shader_;
-
-            // Shader for rendering particles
-            Shader particle_shader_;
-
-            // References to textures
-            // This needs to be a pointer
-            GLuint *tex_;
-
-            // The player object
-            PlayerGameObject* player_;
-
-            // blades
-            GameObject* blades_;
-
-            // The background
-            GameObject* background_tile_;
-            GameObject* end_screen_;
-
-            // ui objects
-            std::vector<GameObject*> health_objects_;
-            std::vector<GameObject*> ui_objects_;
-            std::vector<GameObject*> timer_objects_;
-
-            // A vector of enemy entities
-            std::vector<EnemyGameObject*> enemy_game_objects_;
-
-            // A vecotr of collectible objects
-            std::vector<CollectibleGameObject*> collectible_game_objects_;
-
-            // A vector of basic game objects used for the explosions
-            std::vector<GameObject*> explosions_;
-
-            // a collection of bullet objects
-            std::vector<ProjectileGameObject*> bullets_;
-            std::vector<ProjectileGameObject*> spikes_;
-
-            // particle object to render
-            std::vector<GameObject*> particle_game_objects_;
-
-            //
-            EnemyGameObject* boss_game_object_;
-            std::vector<ChildGameObject*> child_game_objects_;
-            
-            // Keep track of time
-            double current_time_;
-
-            // a tracker to determine the players health
-            int player_health_;
-
-            // 
-            int score_;
-
-            //
-            bool boss_;
-            
-
-            // a tracker to determine the number of collectibles the player has gathered
-            int buff_count_;
-
-            // the number of enemies on the map
-            int num_enemies_;
-
-            // the number of buffs on the map
-            int num_buffs_;
-
-            // a timer thatll help with spawning enemies over time
-            Timer* enemy_timer_;
-
-            // a timer for spawning buffs over time
-            Timer* buff_timer_;
-
-            // a timer to determine if it is appropriate to spawn another bullet
-            Timer* bullet_timer_;
-
-            // instance of audio manager that lets us play wav files.
-            audio_manager::AudioManager am;
-
-            // refrence index for the explosion sound
-            int explosion_index_;
-
-            // refrence index for the looping music
-            int background_index_;
-
-            // Callback for when the window is resized
-            static void ResizeCallback(GLFWwindow* window, int width, int height);
-
-            // Set a specific texture
-            void SetTexture(GLuint w, const char *fname);
-
-            // Load all textures
-            void SetAllTextures();
-
-            // Handle user input
-            void HandleControls(double delta_time);
-
-            // Update all the game objects
-            void Update(double delta_time);
- 
-            // Render the game world
-            void Render(void);
-
-    }; // class Game
-
-} // namespace game
-
-#endif // GAME_H_
\ No newline at end of file
+#ifndef GAME_H_
+#define GAME_H_
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <string>
+#include <vector>
+#include <time.h>
+#include <stdlib.h>
+
+#include "shader.h"
+#include "game_object.h"
+#include "simulation.h"
+#include "input_recorder.h"
+#include "stress_scenario.h"
+#include "audio_manager.h"
+#include "snapshot.h"
+#include "rollback_session.h"
+
+#define PrintException(exception_object)\
+    std::cerr << exception_object.what() << std::endl
+
+namespace game {
+
+    // A class for holding the main game objects
+    class Game {
+
+        public:
+            // Constructor and destructor
+            Game(void);
+            ~Game();
+
+            // Record the session to a file when the game closes, or replay one recorded earlier
+            // Call one of these before Init() since the recording decides the random seed
+            void RecordTo(const std::string &filename);
+            void ReplayFrom(const std::string &filename);
+
+            // Run a stress scenario instead of the game, also before Init()
+            void StressFrom(const std::string &filename);
+
+            // Write the profiling zones to a Chrome trace file when the game closes
+            void TraceTo(const std::string &filename);
+
+            // Play co-op with someone over UDP as player 0 or 1, also before Init() which waits for them to show up
+            void CoopWith(int player, int port, const NetAddress &remote, const NetConditions &conditions);
+
+            // Call Init() before calling any other method
+            // Initialize graphics libraries and main window
+            void Init(void); 
+
+            // Set up the game (scene, game objects, etc.)
+            void Setup(void);
+
+            // Run the game (keep the game active)
+            void MainLoop(void); 
+
+        private:
+            // Main window: pointer to the GLFW window structure
+            GLFWwindow *window_;
+
+            // Sprite geometry
+            Geometry *sprite_;
+
+            // Particle geometry
+            Geometry *bullet_particles_;
+
+            Geometry *explosion_particles_;
+
+            // Shader for rendering sprites in the scene
+            Shader sprite_shader_;
+
+            // Shader for rendering particles
+            Shader particle_shader_;
+
+            // References to textures
+            // This needs to be a pointer
+            GLuint *tex_;
+
+            // the collision shapes read out of the textures alpha as they load
+            SpriteShapes sprite_shapes_;
+
+            // blades
+            GameObject* blades_;
+
+            // The background
+            GameObject* background_tile_;
+            GameObject* end_screen_;
+
+            // ui objects
+            std::vector<GameObject*> health_objects_;
+            std::vector<GameObject*> ui_objects_;
+            std::vector<GameObject*> timer_objects_;
+
+            // the game world, the game only draws it, reads the controls for it and plays its sounds
+            Simulation simulation_;
+
+            // the world as it was right after setup, restored to start over, and the last checkpoint the player saved
+            Snapshot start_;
+            Snapshot checkpoint_;
+
+            // whether the restart and checkpoint keys were down last frame, they only act when they go down
+            bool restart_held_;
+            bool save_held_;
+            bool load_held_;
+
+            // Keep track of time
+            double current_time_;
+
+            // instance of audio manager that lets us play wav files.
+            audio_manager::AudioManager am;
+
+            // refrence index for the explosion sound
+            int explosion_index_;
+
+            // refrence index for the looping music
+            int background_index_;
+
+            // the sounds the simulation asked for this tick
+            std::vector<SimAudioEvent> audio_events_;
+
+            // the keys and delta time of every tick, recorded live or played back from a file
+            InputRecorder input_;
+
+            // where to save the recording, empty when not recording
+            std::string record_file_;
+
+            // the stress scenario to run, not loaded when playing normally
+            StressScenario stress_;
+
+            // where to write the profiling trace, empty when not tracing
+            std::string trace_file_;
+
+            // the co-op game, when there is one, and which of its players is ours (the camera follows it)
+            bool coop_;
+            int coop_port_;
+            NetAddress coop_remote_;
+            NetConditions coop_conditions_;
+            RollbackSession session_;
+            int local_player_;
+
+            // Callback for when the window is resized
+            static void ResizeCallback(GLFWwindow* window, int width, int height);
+
+            // Set a specific texture
+            void SetTexture(GLuint w, const char *fname);
+
+            // Load all textures
+            void SetAllTextures();
+
+            // Read the keyboard into a mask of INPUT_KEY_ bits
+            uint8_t PollKeys(void);
+
+            // Start over, save a checkpoint or go back to it if their keys were just pressed
+            void PollSnapshotKeys(void);
+
+            // Put the world back to a snapshot, the window, textures, shaders and sounds are all kept
+            void Restore(Snapshot &snapshot);
+
+            // Play back a recording as fast as possible and report where the time went
+            void ReplayLoop(void);
+
+            // Run the stress scenario frame by frame and report the frame times
+            void StressLoop(void);
+
+            // Run co-op frames at a fixed rate through the rollback session, which moves the world itself
+            void CoopLoop(void);
+
+            // Write the profiling trace if one was asked for
+            void WriteTrace(void);
+
+            // Update all the game objects
+            void Update(double delta_time);
+
+            // Play the sounds and move the hud along after the world moved
+            void Present(double delta_time);
+
+            // Keep the health, score and power up counters next to the player
+            void UpdateHud(void);
+ 
+            // Render the game world
+            void Render(void);
+
+    }; // class Game
+
+} // namespace game
+
+#endif // GAME_H_
@@ -0,0 +1,203 @@
+#include <stdexcept>
+#include <string>
+
+#include "game_client.h"
+
+namespace game {
+
+// how often we ask to join while waiting for the server, in seconds
+static const double join_interval_g = 0.1;
+
+
+void ClientStats::Report(std::ostream &out) const
+{
+    out << "  snapshots " << snapshots << " (" << bytes_received << " bytes), " << late << " late, " << missing_base << " without their base, "
+        << bad << " bad, input packets sent " << sent << " (" << dropped << " dropped on purpose)" << std::endl;
+}
+
+
+GameClient::GameClient(void)
+{
+    nonce_ = 0;
+    connected_ = false;
+    last_join_ = -1.0;
+    player_ = -1;
+    input_ = 0;
+    latest_ = -1;
+
+    for (int i = 0; i < SERVER_SNAPSHOT_RING; i++)
+    {
+        world_sequence_[i] = -1;
+    }
+}
+
+
+void GameClient::Open(int port, const NetAddress &server, uint64_t seed, const NetConditions &conditions)
+{
+    server_ = server;
+    link_.Open(port, seed, conditions);
+
+    // tells this game apart from an earlier one on the same port
+    Random random(seed ^ static_cast<uint64_t>(link_.GetPort()));
+    nonce_ = random.NextU32();
+}
+
+
+bool GameClient::Connect(double now)
+{
+    Receive(now);
+    if (connected_) return true;
+
+    if (now - last_join_ >= join_interval_g)
+    {
+        packet_.Clear();
+        packet_.Write(SERVER_PACKET_MAGIC);
+        packet_.Write(static_cast<uint8_t>(SERVER_PACKET_JOIN));
+        packet_.Write(nonce_);
+        stats_.sent++;
+        if (!link_.Send(server_, &packet_.GetData()[0], static_cast<int>(packet_.GetSize()), now)) stats_.dropped++;
+        last_join_ = now;
+    }
+    link_.Flush(now);
+    return connected_;
+}
+
+
+void GameClient::Update(uint8_t keys, double now)
+{
+    Receive(now);
+    if (!connected_) return;
+
+    // the keys go every tick, a lost one is made up for by the next
+    packet_.Clear();
+    packet_.Write(SERVER_PACKET_MAGIC);
+    packet_.Write(static_cast<uint8_t>(SERVER_PACKET_INPUT));
+    packet_.Write(input_++);
+    packet_.Write(keys);
+    packet_.Write(latest_);
+    Send(now);
+}
+
+
+void GameClient::Leave(double now)
+{
+    if (!connected_) return;
+
+    packet_.Clear();
+    packet_.Write(SERVER_PACKET_MAGIC);
+    packet_.Write(static_cast<uint8_t>(SERVER_PACKET_LEAVE));
+    Send(now);
+    connected_ = false;
+}
+
+
+void GameClient::Send(double now)
+{
+    stats_.sent++;
+    if (!link_.Send(server_, &packet_.GetData()[0], static_cast<int>(packet_.GetSize()), now)) stats_.dropped++;
+    link_.Flush(now);
+}
+
+
+void GameClient::Receive(double now)
+{
+    uint8_t buffer[UDP_MAX_PACKET];
+    NetAddress from;
+    int size;
+    while ((size = link_.Receive(from, buffer, sizeof(buffer), now)) >= 0)
+    {
+        if (from != server_) continue;
+
+        packet_.Clear();
+        packet_.WriteBytes(buffer, size);
+
+        bool full = false;
+        try
+        {
+            uint32_t magic;
+            uint8_t type;
+            packet_.Read(magic);
+            packet_.Read(type);
+            if (magic != SERVER_PACKET_MAGIC)
+            {
+                stats_.bad++;
+                continue;
+            }
+
+            if (type == SERVER_PACKET_WELCOME || type == SERVER_PACKET_FULL)
+            {
+                uint32_t nonce;
+                packet_.Read(nonce);
+                if (nonce != nonce_ || connected_) continue;
+
+                full = type == SERVER_PACKET_FULL;
+                if (!full)
+                {
+                    uint8_t player;
+                    packet_.Read(player);
+                    player_ = player;
+                    connected_ = true;
+                }
+            }
+            else if (type == SERVER_PACKET_SNAPSHOT)
+            {
+                stats_.bytes_received += size;
+                ReadSnapshot();
+            }
+            else
+            {
+                stats_.bad++;
+            }
+        }
+        catch (std::exception &e)
+        {
+            // cut short on the way
+            stats_.bad++;
+        }
+
+        if (full)
+        {
+            throw(std::runtime_error(std::string("The server at ") + server_.ToString() + std::string(" has no ship free")));
+        }
+    }
+}
+
+
+void GameClient::ReadSnapshot(void)
+{
+    int sequence, base;
+    packet_.Read(sequence);
+    packet_.Read(base);
+    if (sequence < 0 || !connected_) return;
+
+    // the one it was sent against has to be one we still have, and then it can be put back together
+    const NetWorld *base_world = &empty_;
+    if (base >= 0)
+    {
+        if (world_sequence_[base % SERVER_SNAPSHOT_RING] != base)
+        {
+            stats_.missing_base++;
+            return;
+        }
+        base_world = &worlds_[base % SERVER_SNAPSHOT_RING];
+    }
+
+    // an old one overtaken on the way is still worth keeping, something newer may be sent against it
+    int slot = sequence % SERVER_SNAPSHOT_RING;
+    if (world_sequence_[slot] == sequence) return;
+    if (sequence <= latest_ - SERVER_SNAPSHOT_RING) return;
+    if (slot == base % SERVER_SNAPSHOT_RING && base >= 0)
+    {
+        // cant happen with a server that keeps as many as we do
+        stats_.bad++;
+        return;
+    }
+
+    ReadDelta(packet_, *base_world, worlds_[slot]);
+    world_sequence_[slot] = sequence;
+    stats_.snapshots++;
+    if (sequence < latest_) stats_.late++;
+    else latest_ = sequence;
+}
+
+} // namespace game
@@ -0,0 +1,96 @@
+#ifndef GAME_CLIENT_H_
+#define GAME_CLIENT_H_
+
+#include <stdint.h>
+#include <ostream>
+
+#include "snapshot.h"
+#include "net_link.h"
+#include "net_delta.h"
+#include "game_server.h"
+
+namespace game {
+
+    // What a client has been up to
+    struct ClientStats {
+        long long snapshots;
+        long long bytes_received;
+        long long sent;
+        long long dropped;
+
+        // snapshots that came after a newer one, that were against a base we no longer had, and that made no sense
+        long long late;
+        long long missing_base;
+        long long bad;
+
+        ClientStats(void) : snapshots(0), bytes_received(0), sent(0), dropped(0), late(0), missing_base(0), bad(0) {}
+
+        void Report(std::ostream &out) const;
+    };
+
+    /*
+        GameClient is the far end of a GameServer without anything drawn: it joins, sends the keys it is
+        given every tick and puts the snapshots back together into the part of the world its ship can see
+        Every snapshot it reads is kept for a while, the server sends the next ones against the latest it
+        heard we got, and the latest one we have is the world
+    */
+    class GameClient {
+
+        public:
+            // Constructor
+            GameClient(void);
+
+            // Bind to a port (0 lets the system pick one) to talk to a server from, throws if it cant
+            void Open(int port, const NetAddress &server, uint64_t seed, const NetConditions &conditions = NetConditions());
+
+            // Ask to join until the server lets us in, now is the time in seconds on the callers clock
+            // Returns true once we have a ship, throws if the server is full
+            bool Connect(double now);
+
+            // Read the snapshots that arrived and send the keys we are holding
+            void Update(uint8_t keys, double now);
+
+            // Tell the server we are going, it isnt repeated so the server may have to time us out instead
+            void Leave(double now);
+
+            // Getters
+            inline bool IsConnected(void) const { return connected_; }
+            inline int GetPlayer(void) const { return player_; }
+            inline int GetPort(void) const { return link_.GetPort(); }
+            inline int GetSequence(void) const { return latest_; }
+            inline const NetWorld &GetWorld(void) const { return latest_ >= 0 ? worlds_[latest_ % SERVER_SNAPSHOT_RING] : empty_; }
+            inline const ClientStats &GetStats(void) const { return stats_; }
+
+        private:
+            NetLink link_;
+            NetAddress server_;
+            uint32_t nonce_;
+            bool connected_;
+            double last_join_;
+
+            // our ship, and how many input packets weve sent
+            int player_;
+            int input_;
+
+            // the recent snapshots by number, and the newest one
+            NetWorld worlds_[SERVER_SNAPSHOT_RING];
+            int world_sequence_[SERVER_SNAPSHOT_RING];
+            int latest_;
+            NetWorld empty_;
+
+            Snapshot packet_;
+            ClientStats stats_;
+
+            // Take in every packet that arrived
+            void Receive(double now);
+
+            // Put a snapshot together on top of the one it was sent against
+            void ReadSnapshot(void);
+
+            void Send(double now);
+
+    }; // class GameClient
+
+} // namespace game
+
+#endif // GAME_CLIENT_H_
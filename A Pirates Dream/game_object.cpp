@@ -1,108 +1,154 @@
-#define GLM_FORCE_RADIANS
-#include <glm/gtc/matrix_transform.hpp>
-#include <iostream>
-
-#include "game_object.h"
-
-namespace game {
-
-GameObject::GameObject(const glm::vec3 &position, Geometry *geom, Shader *shader, GLuint texture) 
-{
-
-    // Initialize all attributes
-    position_ = position;
-    velocity_ = glm::vec3(0.0f,0.0f,0.0f);
-    scale_ = 1.0;
-    angle_ = 0.0;
-    geometry_ = geom;
-    shader_ = shader;
-    texture_ = texture;
-    timer_ = new Timer();
-    time_ = 0.0;
-}
-
-
-GameObject::~GameObject()
-{ 
-    delete timer_; 
-}
-
-void GameObject::SetTimer(float end_time)
-{
-    timer_->Start(end_time);
-}
-
-
-glm::vec3 GameObject::GetBearing(void) const {
-
-    glm::vec3 dir(cos(angle_), sin(angle_), 0.0);
-    return dir;
-}
-
-glm::vec3 GameObject::GetRight(void) const {
-
-    float pi_over_two = glm::pi<float>() / 2.0f;
-    glm::vec3 dir(cos(angle_ - pi_over_two), sin(angle_ - pi_over_two), 0.0);
-    return dir;
-}
-
-
-void GameObject::SetRotation(float angle){ 
-
-    // Set rotation angle of the game object
-    // Make sure angle is in the range [0, 2*pi]
-    float two_pi = 2.0f*glm::pi<float>();
-    angle = fmod(angle, two_pi);
-    if (angle < 0.0){
-        angle += two_pi;
-    }
-    angle_ = angle;
-}
-
-
-void GameObject::SetVelocity(glm::vec3 &velocity)
-{
-    velocity_ = velocity;
-}
-
-
-void GameObject::Update(double delta_time) {
-    // increment the time
-    time_ += delta_time;
-}
-
-
-void GameObject::Render(glm::mat4 view_matrix, double current_time){
-
-    // Set up the shader
-    shader_->Enable();
-
-    // Set up the view matrix
-    shader_->SetUniformMat4("view_matrix", view_matrix);
-
-    // Setup the scaling matrix for the shader
-    glm::mat4 scaling_matrix = glm::scale(glm::mat4(1.0f), glm::vec3(scale_, scale_, 1.0));
-
-    // Setup the rotation matrix for the shader
-    glm::mat4 rotation_matrix = glm::rotate(glm::mat4(1.0f), angle_, glm::vec3(0.0, 0.0, 1.0));
-
-    // Set up the translation matrix for the shader
-    glm::mat4 translation_matrix = glm::translate(glm::mat4(1.0f), position_);
-
-    // Setup the transformation matrix for the shader
-    glm::mat4 transformation_matrix = translation_matrix * rotation_matrix * scaling_matrix;
-
-    // Set the transformation matrix in the shader
-    shader_->SetUniformMat4("transformation_matrix", transformation_matrix);
-
-    // Set up the geometry
-    geometry_->SetGeometry(shader_->GetShaderProgram());
-
-    // Bind the entity's texture
-    glBindTexture(GL_TEXTURE_2D, texture_);
-
-    // Draw the entity
-    glDrawElements(GL_TRIANGLES, geometry_->GetSize(), GL_UNSIGNED_INT, 0);
-}
-
-} // namespace game
+#define GLM_FORCE_RADIANS
+#include <glm/gtc/matrix_transform.hpp>
+#include <iostream>
+
+#include "game_object.h"
+
+namespace game {
+
+GameObject::GameObject(const glm::vec3 &position, Geometry *geom, Shader *shader, GLuint texture) 
+{
+
+    // Initialize all attributes
+    position_ = position;
+    velocity_ = glm::vec3(0.0f,0.0f,0.0f);
+    scale_ = 1.0;
+    angle_ = 0.0;
+    geometry_ = geom;
+    shader_ = shader;
+    texture_ = texture;
+    timer_ = new Timer();
+    time_ = 0.0;
+    chunk_ = -1;
+    chunk_id_ = -1;
+    net_id_ = 0;
+    transform_.SetLocal(position_, angle_, scale_);
+}
+
+
+GameObject::~GameObject()
+{ 
+    delete timer_; 
+}
+
+void GameObject::SetTimer(float end_time)
+{
+    timer_->Start(end_time);
+}
+
+
+glm::vec3 GameObject::GetBearing(void) const {
+
+    glm::vec3 dir(cos(angle_), sin(angle_), 0.0);
+    return dir;
+}
+
+glm::vec3 GameObject::GetRight(void) const {
+
+    float pi_over_two = glm::pi<float>() / 2.0f;
+    glm::vec3 dir(cos(angle_ - pi_over_two), sin(angle_ - pi_over_two), 0.0);
+    return dir;
+}
+
+
+void GameObject::SetRotation(float angle){ 
+
+    // Set rotation angle of the game object
+    // Make sure angle is in the range [0, 2*pi]
+    float two_pi = 2.0f*glm::pi<float>();
+    angle = fmod(angle, two_pi);
+    if (angle < 0.0){
+        angle += two_pi;
+    }
+    angle_ = angle;
+    SyncTransform();
+}
+
+
+void GameObject::SetVelocity(glm::vec3 &velocity)
+{
+    velocity_ = velocity;
+}
+
+
+void GameObject::Update(double delta_time) {
+    // increment the time
+    time_ += delta_time;
+
+    // the subclasses move the object before calling this, let the transform know
+    SyncTransform();
+}
+
+
+void GameObject::Save(Snapshot &snapshot) const
+{
+    snapshot.Write(position_);
+    snapshot.Write(velocity_);
+    snapshot.Write(scale_);
+    snapshot.Write(angle_);
+    snapshot.Write(time_);
+    snapshot.Write(texture_);
+    snapshot.Write(chunk_);
+    snapshot.Write(chunk_id_);
+    timer_->Save(snapshot);
+}
+
+
+void GameObject::Load(Snapshot &snapshot)
+{
+    snapshot.Read(position_);
+    snapshot.Read(velocity_);
+    snapshot.Read(scale_);
+    snapshot.Read(angle_);
+    snapshot.Read(time_);
+    snapshot.Read(texture_);
+    snapshot.Read(chunk_);
+    snapshot.Read(chunk_id_);
+    timer_->Load(snapshot);
+
+    SyncTransform();
+}
+
+
+void GameObject::GetTimers(std::vector<Timer*> &timers)
+{
+    timers.push_back(timer_);
+}
+
+
+void GameObject::SyncTransform(void)
+{
+    transform_.SetLocal(position_, angle_, scale_);
+}
+
+
+const glm::mat4 &GameObject::GetTransformMatrix(void)
+{
+    // catch anything that wrote the variables directly since the last update
+    SyncTransform();
+    return transform_.GetWorldMatrix();
+}
+
+
+void GameObject::Render(glm::mat4 view_matrix, double current_time){
+
+    // Set up the shader
+    shader_->Enable();
+
+    // Set up the view matrix
+    shader_->SetUniformMat4("view_matrix", view_matrix);
+
+    // Set the transformation matrix in the shader, the transform only rebuilds it if the object moved
+    shader_->SetUniformMat4("transformation_matrix", GetTransformMatrix());
+
+    // Set up the geometry
+    geometry_->SetGeometry(shader_->GetShaderProgram());
+
+    // Bind the entity's texture
+    glBindTexture(GL_TEXTURE_2D, texture_);
+
+    // Draw the entity
+    glDrawElements(GL_TRIANGLES, geometry_->GetSize(), GL_UNSIGNED_INT, 0);
+}
+
+} // namespace game
@@ -1,92 +1,135 @@
-#ifndef GAME_OBJECT_H_
-#define GAME_OBJECT_H_
-
-#include <glm/glm.hpp>
-#include <glm/gtc/matrix_transform.hpp> 
-#define GLEW_STATIC
-#include <GL/glew.h>
-#include <cmath>
-#include <iostream>
-
-
-#include "shader.h"
-#include "geometry.h"
-#include "timer.h"
-
-namespace game {
-
-    /*
-        GameObject is responsible for handling the rendering and updating of one object in the game world
-        The update and render methods are virtual, so you can inherit them from GameObject and override the update or render functionality (see PlayerGameObject for reference)
-    */
-    class GameObject {
-
-        public:
-            // Constructor
-            GameObject(const glm::vec3 &position, Geometry *geom, Shader *shader, GLuint texture);
-
-            // Destructor
-            ~GameObject();
-
-            // Update the GameObject's state. Can be overriden in children
-            virtual void Update(double delta_time);
-
-            // Renders the GameObject 
-            virtual void Render(glm::mat4 view_matrix, double current_time);
-
-            // Getters
-            inline glm::vec3 GetPosition(void) const { return position_; }
-            inline float GetScale(void) const { return scale_; }
-            inline float GetRotation(void) const { return angle_; }
-            int GetTimer(int i = 1) const { return timer_->Finished(i); }
-            inline double GetTimerTime(void) const { return timer_->GetTime(); }
-            glm::vec3 GetVelocity(void) const { return velocity_; }
-            inline double GetTime(void) const { return time_; }
-            //inline double 
-            virtual inline glm::vec3 GetStart(void) const { return glm::vec3(0.0f,0.0f,0.0f); }
-            // 
-            virtual inline void GetParent(GameObject **parent) {}
-
-            // Get bearing direction (direction in which the game object
-            // is facing)
-            glm::vec3 GetBearing(void) const;
-
-            // Get vector pointing to the right side of the game object
-            glm::vec3 GetRight(void) const;
-
-            // Setters
-            inline void SetPosition(const glm::vec3& position) { position_ = position; }
-            inline void SetScale(float scale) { scale_ = scale; }
-            virtual void SetRotation(float angle);
-            void SetTimer(float end_time);
-            void SetTexture(GLuint texture) { texture_ = texture;}
-            virtual void SetVelocity(glm::vec3 &velocity);
-
-
-        protected:
-            // Object's Transform Variables
-            glm::vec3 position_;
-            glm::vec3 velocity_;
-            float scale_;
-            float angle_;
-
-            // a total for the amount of time the object has been alive, helps us keep the enemy movement unique for now 
-            double time_;
-
-            // a timer for this objects explosion
-            Timer* timer_;
-
-            // Geometry
-            Geometry *geometry_;
- 
-            // Shader
-            Shader *shader_;
-
-            // Object's texture reference
-            GLuint texture_;
-
-    }; // class GameObject
-
-} // namespace game
-
-#endif // GAME_OBJECT_H_
+#ifndef GAME_OBJECT_H_
+#define GAME_OBJECT_H_
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp> 
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+
+#include "shader.h"
+#include "geometry.h"
+#include "timer.h"
+#include "snapshot.h"
+#include "transform.h"
+#include "alloc_tracker.h"
+
+namespace game {
+
+    /*
+        GameObject is responsible for handling the rendering and updating of one object in the game world
+        The update and render methods are virtual, so you can inherit them from GameObject and override the update or render functionality (see PlayerGameObject for reference)
+    */
+    class GameObject {
+
+        public:
+            // plain objects (explosion anchors, the hud) count as objects, each subclass tags itself the same way
+            ALLOC_TAGGED_NEW(ALLOC_TAG_OBJECT)
+
+            // Constructor
+            GameObject(const glm::vec3 &position, Geometry *geom, Shader *shader, GLuint texture);
+
+            // Destructor
+            ~GameObject();
+
+            // Update the GameObject's state. Can be overriden in children
+            virtual void Update(double delta_time);
+
+            // Renders the GameObject 
+            virtual void Render(glm::mat4 view_matrix, double current_time);
+
+            // Getters
+            inline glm::vec3 GetPosition(void) const { return position_; }
+            inline float GetScale(void) const { return scale_; }
+            inline float GetRotation(void) const { return angle_; }
+            inline GLuint GetTexture(void) const { return texture_; }
+            int GetTimer(int i = 1) const { return timer_->Finished(i); }
+            inline double GetTimerTime(void) const { return timer_->GetTime(); }
+            glm::vec3 GetVelocity(void) const { return velocity_; }
+            inline double GetTime(void) const { return time_; }
+            inline int GetChunk(void) const { return chunk_; }
+            inline int GetChunkId(void) const { return chunk_id_; }
+            inline uint32_t GetNetId(void) const { return net_id_; }
+            //inline double 
+            virtual inline glm::vec3 GetStart(void) const { return glm::vec3(0.0f,0.0f,0.0f); }
+            // 
+            virtual inline void GetParent(GameObject **parent) {}
+
+            // Get bearing direction (direction in which the game object
+            // is facing)
+            glm::vec3 GetBearing(void) const;
+
+            // Get vector pointing to the right side of the game object
+            glm::vec3 GetRight(void) const;
+
+            // The matrix that places the object in the world (translation * rotation * scale, under the parent if there is one)
+            // It is cached in the transform and only rebuilt when the object or its parent moved
+            const glm::mat4 &GetTransformMatrix(void);
+
+            // The transform other objects can hang off
+            inline Transform *GetTransform(void) { return &transform_; }
+
+            // Setters
+            inline void SetPosition(const glm::vec3& position) { position_ = position; SyncTransform(); }
+            inline void SetScale(float scale) { scale_ = scale; SyncTransform(); }
+            virtual void SetRotation(float angle);
+            void SetTimer(float end_time);
+            void SetTexture(GLuint texture) { texture_ = texture;}
+            virtual void SetVelocity(glm::vec3 &velocity);
+            inline void SetChunk(int chunk, int id) { chunk_ = chunk; chunk_id_ = id; }
+            inline void SetNetId(uint32_t id) { net_id_ = id; }
+
+            // Save or restore the state of the object, subclasses add theirs after ours
+            // The geometry and shader arent saved, the object being restored into was made with them already
+            virtual void Save(Snapshot &snapshot) const;
+            virtual void Load(Snapshot &snapshot);
+
+            // Every timer the object owns, so the simulation can put them back on its wheel
+            virtual void GetTimers(std::vector<Timer*> &timers);
+
+
+        protected:
+            // Object's Transform Variables
+            glm::vec3 position_;
+            glm::vec3 velocity_;
+            float scale_;
+            float angle_;
+
+            // the cached matrices, kept in step with the variables above by SyncTransform
+            Transform transform_;
+
+            // a total for the amount of time the object has been alive, helps us keep the enemy movement unique for now 
+            double time_;
+
+            // a timer for this objects explosion
+            Timer* timer_;
+
+            // the level chunk this object was streamed in from and its place in that chunk (-1 if it wasnt)
+            int chunk_;
+            int chunk_id_;
+
+            // the number a server tells its clients this object by, 0 until it has one
+            // it isnt saved, a restored object is a new one as far as the clients know
+            uint32_t net_id_;
+
+            // Geometry
+            Geometry *geometry_;
+ 
+            // Shader
+            Shader *shader_;
+
+            // Object's texture reference
+            GLuint texture_;
+
+            // Hand the position, rotation and scale to the transform, it only rebuilds if one changed
+            // Objects whose position isnt their local position (the boss arms) override this
+            virtual void SyncTransform(void);
+
+    }; // class GameObject
+
+} // namespace game
+
+#endif // GAME_OBJECT_H_
@@ -0,0 +1,450 @@
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+#include "game_server.h"
+#include "profiler.h"
+
+namespace game {
+
+static double Seconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+ServerStats::ServerStats(void)
+{
+    ticks = 0;
+    tick_seconds = 0.0;
+    max_tick_seconds = 0.0;
+    encode_seconds = 0.0;
+    late_ticks = 0;
+    for (int i = 0; i <= SERVER_TICK_BUCKETS; i++) tick_histogram[i] = 0;
+
+    snapshots = full_snapshots = 0;
+    bytes_sent = full_bytes = packets_sent = dropped = 0;
+    bytes_received = packets_received = bad = 0;
+    entities_total = entities_visible = entities_written = 0;
+    entities_unchanged = entities_held_back = entities_removed = 0;
+    joins = leaves = timeouts = turned_away = 0;
+}
+
+
+double ServerStats::TickPercentile(double percent) const
+{
+    long long wanted = static_cast<long long>(ticks * percent / 100.0);
+    long long seen = 0;
+    for (int i = 0; i < SERVER_TICK_BUCKETS; i++)
+    {
+        seen += tick_histogram[i];
+        if (seen > wanted) return (i + 1) * SERVER_TICK_BUCKET_SECONDS;
+    }
+    return max_tick_seconds;
+}
+
+
+void ServerStats::Report(std::ostream &out, double seconds) const
+{
+    double per_second = seconds > 0.0 ? 1.0 / seconds : 0.0;
+
+    out << "  ticks " << ticks << ", " << (ticks > 0 ? tick_seconds * 1000.0 / ticks : 0.0) << " ms on average, 50% under "
+        << TickPercentile(50.0) * 1000.0 << " ms, 99% under " << TickPercentile(99.0) * 1000.0 << " ms, slowest "
+        << max_tick_seconds * 1000.0 << " ms, " << late_ticks << " over " << SERVER_TICK * 1000.0 << " ms" << std::endl;
+    out << "  building and packing snapshots took " << encode_seconds * 1000.0 << " ms (" << (snapshots > 0 ? encode_seconds * 1000000.0 / snapshots : 0.0)
+        << " us per snapshot)" << std::endl;
+    out << "  snapshots " << snapshots << " (" << full_snapshots << " in full), " << bytes_sent << " bytes in " << packets_sent << " packets ("
+        << dropped << " dropped on purpose), " << bytes_sent * per_second / 1024.0 << " KB/s, "
+        << (snapshots > 0 ? static_cast<double>(bytes_sent) / snapshots : 0.0) << " bytes per snapshot" << std::endl;
+    out << "  without deltas the snapshots would have been " << full_bytes << " bytes ("
+        << (full_bytes > 0 ? 100.0 * bytes_sent / full_bytes : 0.0) << "% of that was sent)" << std::endl;
+    out << "  received " << bytes_received << " bytes in " << packets_received << " packets (" << bad << " bad), "
+        << bytes_received * per_second / 1024.0 << " KB/s" << std::endl;
+    out << "  per snapshot " << (snapshots > 0 ? static_cast<double>(entities_visible) / snapshots : 0.0) << " of "
+        << (snapshots > 0 ? static_cast<double>(entities_total) / snapshots : 0.0) << " entities near enough, "
+        << (snapshots > 0 ? static_cast<double>(entities_written) / snapshots : 0.0) << " sent, "
+        << (snapshots > 0 ? static_cast<double>(entities_unchanged) / snapshots : 0.0) << " unchanged, "
+        << (snapshots > 0 ? static_cast<double>(entities_held_back) / snapshots : 0.0) << " held back, "
+        << (snapshots > 0 ? static_cast<double>(entities_removed) / snapshots : 0.0) << " removed" << std::endl;
+    out << "  clients joined " << joins << ", left " << leaves << ", timed out " << timeouts << ", turned away " << turned_away << std::endl;
+}
+
+
+GameServer::GameServer(void)
+{
+    tick_ = 0;
+    next_net_id_ = 1;
+
+    for (int i = 0; i < SIM_MAX_PLAYERS; i++)
+    {
+        clients_[i].active = false;
+    }
+}
+
+
+void GameServer::Open(int port, int players, uint64_t seed, const NetConditions &conditions)
+{
+    link_.Open(port, seed ^ 0x2545f4914f6cdd1dULL, conditions);
+
+    // no textures here, their numbers stand in for them so the clients can tell what to draw
+    SimulationAssets assets;
+    for (int i = 0; i < SIM_NUM_TEXTURES; i++)
+    {
+        assets.tex[i] = i + 1;
+    }
+
+    simulation_.Seed(seed);
+    simulation_.SetNumPlayers(players);
+    simulation_.Setup(assets);
+    simulation_.Save(start_);
+}
+
+
+int GameServer::GetNumClients(void) const
+{
+    int count = 0;
+    for (int i = 0; i < simulation_.GetNumPlayers(); i++)
+    {
+        if (clients_[i].active) count++;
+    }
+    return count;
+}
+
+
+const NetWorld *GameServer::GetSent(int player, int sequence) const
+{
+    if (player < 0 || player >= SIM_MAX_PLAYERS || sequence < 0) return NULL;
+
+    const Client &client = clients_[player];
+    int slot = sequence % SERVER_SNAPSHOT_RING;
+    if (!client.active || client.sent_sequence[slot] != sequence) return NULL;
+    return &client.sent[slot];
+}
+
+
+void GameServer::Tick(double now)
+{
+    PROFILE_ZONE("GameServer::Tick");
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    Receive(now);
+    DropQuiet(now);
+
+    for (int p = 0; p < simulation_.GetNumPlayers(); p++)
+    {
+        simulation_.HandleControls(p, clients_[p].active ? clients_[p].keys : 0, SERVER_TICK);
+    }
+    simulation_.Update(SERVER_TICK);
+
+    // nobody hears anything on the server
+    std::vector<SimAudioEvent> sounds;
+    simulation_.TakeAudioEvents(sounds);
+
+    // everyone starts over together, the objects are new so the clients get told about all of them again
+    if (simulation_.IsOver()) simulation_.Restore(start_);
+
+    tick_++;
+    if (tick_ % SERVER_SEND_INTERVAL == 0) SendSnapshots(now);
+    link_.Flush(now);
+
+    double seconds = Seconds(start);
+    stats_.ticks++;
+    stats_.tick_seconds += seconds;
+    stats_.max_tick_seconds = std::max(stats_.max_tick_seconds, seconds);
+    if (seconds > SERVER_TICK) stats_.late_ticks++;
+    stats_.tick_histogram[std::min(static_cast<int>(seconds / SERVER_TICK_BUCKET_SECONDS), SERVER_TICK_BUCKETS)]++;
+}
+
+
+void GameServer::Receive(double now)
+{
+    uint8_t buffer[UDP_MAX_PACKET];
+    NetAddress from;
+    int size;
+    while ((size = link_.Receive(from, buffer, sizeof(buffer), now)) >= 0)
+    {
+        stats_.packets_received++;
+        stats_.bytes_received += size;
+
+        packet_.Clear();
+        packet_.WriteBytes(buffer, size);
+
+        try
+        {
+            uint32_t magic;
+            uint8_t type;
+            packet_.Read(magic);
+            packet_.Read(type);
+            if (magic != SERVER_PACKET_MAGIC)
+            {
+                stats_.bad++;
+                continue;
+            }
+
+            if (type == SERVER_PACKET_JOIN)
+            {
+                uint32_t nonce;
+                packet_.Read(nonce);
+                Join(from, nonce, now);
+                continue;
+            }
+
+            // everything else has to come from someone who joined
+            Client *client = NULL;
+            for (int p = 0; p < simulation_.GetNumPlayers(); p++)
+            {
+                if (clients_[p].active && clients_[p].address == from) client = &clients_[p];
+            }
+            if (!client)
+            {
+                stats_.bad++;
+                continue;
+            }
+            client->last_heard = now;
+
+            if (type == SERVER_PACKET_INPUT)
+            {
+                int input, ack;
+                uint8_t keys;
+                packet_.Read(input);
+                packet_.Read(keys);
+                packet_.Read(ack);
+
+                // one that got overtaken on the way is older news than what we have
+                if (input > client->input)
+                {
+                    client->input = input;
+                    client->keys = keys;
+                }
+                if (ack < client->sequence) client->acked = std::max(client->acked, ack);
+            }
+            else if (type == SERVER_PACKET_LEAVE)
+            {
+                client->active = false;
+                stats_.leaves++;
+            }
+            else
+            {
+                stats_.bad++;
+            }
+        }
+        catch (std::exception &e)
+        {
+            // cut short on the way
+            stats_.bad++;
+        }
+    }
+}
+
+
+void GameServer::Join(const NetAddress &from, uint32_t nonce, double now)
+{
+    // a join we already let in, they didnt hear the welcome. A new nonce is a new game on the same port
+    int player = -1;
+    for (int p = 0; p < simulation_.GetNumPlayers(); p++)
+    {
+        if (clients_[p].active && clients_[p].address == from) player = p;
+    }
+    bool again = player >= 0 && clients_[player].nonce == nonce;
+
+    for (int p = 0; p < simulation_.GetNumPlayers() && player < 0; p++)
+    {
+        if (!clients_[p].active) player = p;
+    }
+
+    packet_.Clear();
+    packet_.Write(SERVER_PACKET_MAGIC);
+    if (player < 0)
+    {
+        stats_.turned_away++;
+        packet_.Write(static_cast<uint8_t>(SERVER_PACKET_FULL));
+        packet_.Write(nonce);
+        SendPacket(from, now);
+        return;
+    }
+
+    Client &client = clients_[player];
+    if (!again)
+    {
+        client.active = true;
+        client.address = from;
+        client.nonce = nonce;
+        client.keys = 0;
+        client.input = -1;
+        client.acked = -1;
+        client.sequence = 0;
+        for (int i = 0; i < SERVER_SNAPSHOT_RING; i++)
+        {
+            client.sent[i].Clear();
+            client.sent_sequence[i] = -1;
+        }
+        stats_.joins++;
+    }
+    client.last_heard = now;
+
+    packet_.Write(static_cast<uint8_t>(SERVER_PACKET_WELCOME));
+    packet_.Write(nonce);
+    packet_.Write(static_cast<uint8_t>(player));
+    packet_.Write(static_cast<uint8_t>(simulation_.GetNumPlayers()));
+    SendPacket(from, now);
+}
+
+
+void GameServer::DropQuiet(double now)
+{
+    for (int p = 0; p < simulation_.GetNumPlayers(); p++)
+    {
+        if (clients_[p].active && now - clients_[p].last_heard > SERVER_TIMEOUT)
+        {
+            clients_[p].active = false;
+            stats_.timeouts++;
+        }
+    }
+}
+
+
+void GameServer::Add(GameObject *object, int kind)
+{
+    Add(object, object, kind);
+}
+
+
+void GameServer::Add(GameObject *object, GameObject *anchor, int kind)
+{
+    if (object->GetNetId() == 0) object->SetNetId(next_net_id_++);
+    entities_.push_back(NetEntity(object->GetNetId(), kind, object->GetTexture(), anchor->GetPosition(), object->GetRotation(), object->GetScale()));
+}
+
+
+void GameServer::Gather(void)
+{
+    entities_.clear();
+
+    for (int p = 0; p < simulation_.GetNumPlayers(); p++)
+    {
+        Add(simulation_.GetPlayer(p), NET_KIND_PLAYER);
+    }
+    for (int i = 0; i < simulation_.GetEnemies().size(); i++)
+    {
+        Add(simulation_.GetEnemies()[i], NET_KIND_ENEMY);
+    }
+    for (int i = 0; i < simulation_.GetCollectibles().size(); i++)
+    {
+        Add(simulation_.GetCollectibles()[i], NET_KIND_COLLECTIBLE);
+    }
+    for (int i = 0; i < simulation_.GetBullets().size(); i++)
+    {
+        Add(simulation_.GetBullets()[i], NET_KIND_BULLET);
+    }
+    for (int i = 0; i < simulation_.GetSpikes().size(); i++)
+    {
+        Add(simulation_.GetSpikes()[i], NET_KIND_SPIKE);
+    }
+    for (int i = 0; i < simulation_.GetTentacles().size(); i++)
+    {
+        Add(simulation_.GetTentacles()[i], NET_KIND_TENTACLE);
+    }
+
+    // particles are left to the clients, only where the explosions and emitters are goes out
+    for (int i = 0; i < simulation_.GetExplosions().size(); i++)
+    {
+        GameObject *anchor;
+        simulation_.GetExplosions()[i]->GetParent(&anchor);
+        Add(simulation_.GetExplosions()[i], anchor, NET_KIND_EXPLOSION);
+    }
+    for (int i = 0; i < simulation_.GetEmitters().size(); i++)
+    {
+        GameObject *anchor;
+        simulation_.GetEmitters()[i]->GetParent(&anchor);
+        Add(simulation_.GetEmitters()[i], anchor, NET_KIND_EMITTER);
+    }
+
+    // the new ones were numbered after the old ones, but restoring a snapshot can leave the lists in any order
+    std::sort(entities_.begin(), entities_.end(), [](const NetEntity &a, const NetEntity &b) { return a.id < b.id; });
+}
+
+
+void GameServer::SendSnapshots(double now)
+{
+    PROFILE_ZONE("GameServer::SendSnapshots");
+    if (GetNumClients() == 0) return;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    Gather();
+
+    world_.tick = tick_;
+    world_.health = simulation_.GetPlayerHealth();
+    world_.score = simulation_.GetScore();
+    world_.flags = (simulation_.IsOver() ? NET_WORLD_OVER : 0) | (simulation_.IsWon() ? NET_WORLD_WON : 0);
+
+    for (int p = 0; p < simulation_.GetNumPlayers(); p++)
+    {
+        Client &client = clients_[p];
+        if (!client.active) continue;
+
+        // only what is close to this ship, the ships themselves always, the nearest first
+        glm::vec3 centre = simulation_.GetPlayer(p)->GetPosition();
+        float radius = SERVER_INTEREST_RADIUS * NET_POSITION_STEPS;
+        world_.entities.clear();
+        distances_.clear();
+        for (int i = 0; i < entities_.size(); i++)
+        {
+            float dx = entities_[i].x - centre.x * NET_POSITION_STEPS;
+            float dy = entities_[i].y - centre.y * NET_POSITION_STEPS;
+            float distance = dx * dx + dy * dy;
+            if (entities_[i].kind == NET_KIND_PLAYER) distance = -1.0f;
+            else if (distance > radius * radius) continue;
+
+            world_.entities.push_back(entities_[i]);
+            distances_.push_back(distance);
+        }
+        priority_.resize(world_.entities.size());
+        for (int i = 0; i < priority_.size(); i++) priority_[i] = i;
+        std::sort(priority_.begin(), priority_.end(), [this](int a, int b) { return distances_[a] < distances_[b]; });
+
+        // against the last one they told us they got, if we still have it and it isnt the one this is about to take the place of
+        int sequence = client.sequence++;
+        int slot = sequence % SERVER_SNAPSHOT_RING;
+        int base = -1;
+        if (client.acked >= 0 && sequence - client.acked < SERVER_SNAPSHOT_RING && client.sent_sequence[client.acked % SERVER_SNAPSHOT_RING] == client.acked)
+        {
+            base = client.acked;
+        }
+        const NetWorld &base_world = base >= 0 ? client.sent[base % SERVER_SNAPSHOT_RING] : empty_;
+        packet_.Clear();
+        packet_.Write(SERVER_PACKET_MAGIC);
+        packet_.Write(static_cast<uint8_t>(SERVER_PACKET_SNAPSHOT));
+        packet_.Write(sequence);
+        packet_.Write(base);
+        size_t header = packet_.GetSize();
+
+        DeltaCounts counts;
+        WriteDelta(packet_, base_world, world_, priority_, UDP_MAX_PACKET - header, client.sent[slot], counts);
+        client.sent_sequence[slot] = sequence;
+
+        stats_.snapshots++;
+        if (base < 0) stats_.full_snapshots++;
+        stats_.full_bytes += header + counts.full_bytes;
+        stats_.entities_total += entities_.size();
+        stats_.entities_visible += world_.entities.size();
+        stats_.entities_written += counts.written;
+        stats_.entities_unchanged += counts.unchanged;
+        stats_.entities_held_back += counts.held_back;
+        stats_.entities_removed += counts.removed;
+
+        SendPacket(client.address, now);
+    }
+
+    stats_.encode_seconds += Seconds(start);
+}
+
+
+void GameServer::SendPacket(const NetAddress &to, double now)
+{
+    stats_.packets_sent++;
+    stats_.bytes_sent += packet_.GetSize();
+    if (!link_.Send(to, &packet_.GetData()[0], static_cast<int>(packet_.GetSize()), now)) stats_.dropped++;
+}
+
+} // namespace game
@@ -0,0 +1,188 @@
+#ifndef GAME_SERVER_H_
+#define GAME_SERVER_H_
+
+#include <stdint.h>
+#include <ostream>
+#include <vector>
+
+#include "simulation.h"
+#include "snapshot.h"
+#include "net_link.h"
+#include "net_delta.h"
+
+// the server runs the world at a fixed 60 ticks a second and sends every client a snapshot every few ticks
+#define SERVER_TICK (1.0 / 60.0)
+#define SERVER_SEND_INTERVAL 3
+
+// a client is told about everything this close to its ship (a little past the corners of the screen), and
+// every ship wherever it is
+#define SERVER_INTEREST_RADIUS 9.0f
+
+// how many snapshots back a client can still ack and have the next one sent against it
+#define SERVER_SNAPSHOT_RING 32
+
+// seconds without a word from a client before its ship is given up
+#define SERVER_TIMEOUT 5.0
+
+// the tick time histogram, in buckets of 50 microseconds up to 20 ms
+#define SERVER_TICK_BUCKETS 400
+#define SERVER_TICK_BUCKET_SECONDS 0.00005
+
+// what the first byte after the magic says a packet is
+#define SERVER_PACKET_JOIN 0
+#define SERVER_PACKET_INPUT 1
+#define SERVER_PACKET_LEAVE 2
+#define SERVER_PACKET_WELCOME 3
+#define SERVER_PACKET_FULL 4
+#define SERVER_PACKET_SNAPSHOT 5
+
+// the first bytes of every packet between a server and its clients, anything else is ignored
+#define SERVER_PACKET_MAGIC 0x53445250u
+
+namespace game {
+
+    // What the server has been up to
+    struct ServerStats {
+        long long ticks;
+        double tick_seconds;
+        double max_tick_seconds;
+        double encode_seconds;
+
+        // ticks that took longer than a tick has, and how many took how long
+        long long late_ticks;
+        long long tick_histogram[SERVER_TICK_BUCKETS + 1];
+
+        long long snapshots;
+        long long full_snapshots;
+        long long bytes_sent;
+        long long full_bytes;
+        long long packets_sent;
+        long long dropped;
+        long long bytes_received;
+        long long packets_received;
+        long long bad;
+
+        // entities in the world each time a snapshot went out, summed over the clients, how many of those were
+        // near enough to the client to count, and what became of them
+        long long entities_total;
+        long long entities_visible;
+        long long entities_written;
+        long long entities_unchanged;
+        long long entities_held_back;
+        long long entities_removed;
+
+        long long joins;
+        long long leaves;
+        long long timeouts;
+        long long turned_away;
+
+        ServerStats(void);
+
+        // The tick time that many percent of the ticks came in under, from the histogram
+        double TickPercentile(double percent) const;
+
+        // Print it all out, with bandwidth worked out over a number of seconds
+        void Report(std::ostream &out, double seconds) const;
+    };
+
+    /*
+        GameServer runs the one true copy of the world for a number of players who join over UDP, nothing is
+        drawn or played. Clients send the keys they are holding and the server runs the simulation with them
+        at a fixed rate, starting over when the game is over, so nobody can get out of step with anybody
+        Every client gets its own snapshots: only the entities near its ship (interest management), and each
+        one as a delta against the last snapshot the client told us it got, so an enemy that only moved costs a
+        few bytes and one that didnt costs nothing. What doesnt fit in a packet goes out next time, nearest first
+        Objects are known to the clients by a net id the server hands out the first time it sees them, and the
+        textures by their number in SimulationAssets (the server has no real ones)
+    */
+    class GameServer {
+
+        public:
+            // Constructor
+            GameServer(void);
+
+            // Open the port and set the world up with a ship for each of up to players clients, throws if the
+            // port cant be opened. A ship with nobody on it stays where it is
+            void Open(int port, int players, uint64_t seed, const NetConditions &conditions = NetConditions());
+
+            // Take in every packet, run one tick with the keys the clients last sent, and send the snapshots
+            // that are due, now is the time in seconds on the callers clock
+            void Tick(double now);
+
+            // What we sent a player in a snapshot, for checking against what the client made of it
+            // NULL if the snapshot is too old or the player isnt there
+            const NetWorld *GetSent(int player, int sequence) const;
+
+            // Getters
+            inline int GetPort(void) const { return link_.GetPort(); }
+            inline int GetTick(void) const { return tick_; }
+            inline int GetNumPlayers(void) const { return simulation_.GetNumPlayers(); }
+            int GetNumClients(void) const;
+            inline const Simulation &GetSimulation(void) const { return simulation_; }
+            inline const ServerStats &GetStats(void) const { return stats_; }
+
+        private:
+            // one client and everything we remember sending it
+            struct Client {
+                bool active;
+                NetAddress address;
+                uint32_t nonce;
+                double last_heard;
+
+                // the keys they are holding, the latest input packet they took from, and the latest snapshot they acked
+                uint8_t keys;
+                int input;
+                int acked;
+
+                // the next snapshot number, and the world as we left it after each recent one
+                int sequence;
+                NetWorld sent[SERVER_SNAPSHOT_RING];
+                int sent_sequence[SERVER_SNAPSHOT_RING];
+            };
+
+            NetLink link_;
+            Simulation simulation_;
+            Snapshot start_;
+            int tick_;
+
+            // the clients by the ship they fly
+            Client clients_[SIM_MAX_PLAYERS];
+
+            // the net id the next new object gets
+            uint32_t next_net_id_;
+
+            // every object in the world this tick and where it is, and the part of it one client gets
+            std::vector<NetEntity> entities_;
+            NetWorld world_;
+            std::vector<int> priority_;
+            std::vector<float> distances_;
+            NetWorld empty_;
+
+            Snapshot packet_;
+            ServerStats stats_;
+
+            // Handle every packet that arrived
+            void Receive(double now);
+
+            // Let a client in on the first free ship, or tell them there isnt one
+            void Join(const NetAddress &from, uint32_t nonce, double now);
+
+            // Give up the clients we havent heard from
+            void DropQuiet(double now);
+
+            // List everything in the world as net entities, giving new objects their ids
+            void Gather(void);
+            void Add(GameObject *object, int kind);
+            void Add(GameObject *object, GameObject *anchor, int kind);
+
+            // Send each client the part of the world it can see, as a delta
+            void SendSnapshots(double now);
+
+            // Send whatever is in packet_ to an address
+            void SendPacket(const NetAddress &to, double now);
+
+    }; // class GameServer
+
+} // namespace game
+
+#endif // GAME_SERVER_H_
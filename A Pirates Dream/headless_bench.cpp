@@ -0,0 +1,476 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <path_config.h>
+
+#include "simulation.h"
+#include "input_recorder.h"
+#include "stress_scenario.h"
+#include "profiler.h"
+#include "alloc_tracker.h"
+#include "audio_manager.h"
+#include "software_mixer.h"
+#include "rollback_session.h"
+#include "session_runner.h"
+
+// Macro for printing exceptions
+#define PrintException(exception_object)\
+    std::cerr << exception_object.what() << std::endl
+
+/*
+    Runs the game simulation with no window, no OpenGL and no sound card and reports how long a tick takes
+    The player sails in a circle shooting, can't be hurt, and the enemies and collectibles are topped back
+    up to the requested counts before every tick so the load stays the same the whole run
+
+    usage: HeadlessBench [--ticks N] [--enemies E1,E2,...] [--collectibles C] [--seed S]
+
+    With --scenario <file> it runs a stress scenario instead and reports its frame times, see scenarios/ramp.scn
+    With --trace <file> the profiling zones are written out for a trace viewer (build with -DPROFILE=ON)
+    With --audio <file> the sounds are mixed in software and the last run is written out as a wav, the same
+    seed always gives the same file
+    With --snapshot <tick> the world is saved at that tick and restored once the run is over, and the ticks
+    after it are run again, the end of both runs has to come out byte for byte the same
+    With --coop <port> two co-op games play each other over UDP on this machine (on port and port + 1) with
+    scripted keys, through --latency <ms>, --jitter <ms> and --loss <percent> of bad network, then both have
+    to end up byte for byte the same as a game that had both players keys all along
+    With --sessions <n> that many whole games are played by a bot on seeds counting up from --seed, each for
+    at most --ticks, across --threads <t> threads (one per core by default) and on --level <file> if given,
+    then how fast they went all together and how they turned out is reported. The first few are played again
+    one at a time and have to end the same as they did next to the others
+*/
+
+namespace {
+
+struct BenchOptions {
+    int ticks;
+    std::vector<int> enemies;
+    int collectibles;
+    unsigned long long seed;
+    std::string scenario;
+    std::string trace;
+    std::string audio;
+    int snapshot;
+    int coop;
+    double latency;
+    double jitter;
+    double loss;
+    int sessions;
+    int threads;
+    std::string level;
+};
+
+
+void ParseOptions(int argc, char *argv[], BenchOptions &options)
+{
+    for (int i = 1; i < argc; i++){
+        std::string arg(argv[i]);
+        if (i + 1 >= argc){
+            throw(std::runtime_error(std::string("Missing value for ") + arg));
+        }
+        std::string value(argv[++i]);
+
+        if (arg == "--ticks"){
+            options.ticks = atoi(value.c_str());
+        } else if (arg == "--enemies"){
+            // a list of counts runs one scenario per count
+            options.enemies.clear();
+            std::istringstream list(value);
+            std::string count;
+            while (std::getline(list, count, ',')){
+                options.enemies.push_back(atoi(count.c_str()));
+            }
+        } else if (arg == "--collectibles"){
+            options.collectibles = atoi(value.c_str());
+        } else if (arg == "--seed"){
+            options.seed = strtoull(value.c_str(), NULL, 10);
+        } else if (arg == "--scenario"){
+            options.scenario = value;
+        } else if (arg == "--trace"){
+            options.trace = value;
+        } else if (arg == "--audio"){
+            options.audio = value;
+        } else if (arg == "--snapshot"){
+            options.snapshot = atoi(value.c_str());
+        } else if (arg == "--coop"){
+            options.coop = atoi(value.c_str());
+        } else if (arg == "--latency"){
+            options.latency = atof(value.c_str()) / 1000.0;
+        } else if (arg == "--jitter"){
+            options.jitter = atof(value.c_str()) / 1000.0;
+        } else if (arg == "--loss"){
+            options.loss = atof(value.c_str()) / 100.0;
+        } else if (arg == "--sessions"){
+            options.sessions = atoi(value.c_str());
+        } else if (arg == "--threads"){
+            options.threads = atoi(value.c_str());
+        } else if (arg == "--level"){
+            options.level = value;
+        } else {
+            throw(std::runtime_error(std::string("Unknown argument ") + arg));
+        }
+    }
+
+    if (options.ticks <= 0 || options.enemies.empty()){
+        throw(std::runtime_error(std::string("Need at least one tick and one enemy count")));
+    }
+}
+
+
+// A point in a ring around the player, far enough out that things dont spawn on top of it
+glm::vec3 RingPosition(game::Random &random, const glm::vec3 &centre)
+{
+    float angle = random.Range(0.0f, 2.0f * glm::pi<float>());
+    float radius = random.Range(2.0f, 6.0f);
+    return glm::vec3(centre.x + radius * cos(angle), centre.y + radius * sin(angle), 0.0f);
+}
+
+
+// Top the enemies and collectibles back up for a tick and pick the keys for it
+uint8_t PrepareTick(game::Simulation &simulation, game::Random &random, const BenchOptions &options, int num_enemies, int t)
+{
+    glm::vec3 centre = simulation.GetPlayer()->GetPosition();
+    while (simulation.GetEnemies().size() < num_enemies){
+        simulation.AddEnemy(random.NextInt(2) == 0 ? SPAWN_NAVY : SPAWN_MONSTER, RingPosition(random, centre));
+    }
+    while (simulation.GetCollectibles().size() < options.collectibles){
+        simulation.AddCollectible(random.NextInt(3), RingPosition(random, centre));
+    }
+
+    // full speed ahead, turning and firing, with a mine every few seconds
+    uint8_t keys = INPUT_KEY_W | INPUT_KEY_A | INPUT_KEY_SPACE;
+    if (t % 300 == 150) keys = INPUT_KEY_W | INPUT_KEY_A | INPUT_KEY_LEFT_SHIFT;
+    return keys;
+}
+
+
+void RunScenario(const BenchOptions &options, int num_enemies)
+{
+    const double delta_time = 1.0 / 60.0;
+
+    game::Simulation simulation;
+    simulation.Seed(options.seed);
+    simulation.Setup(game::SimulationAssets());
+    simulation.SetInvulnerable(true);
+
+    // the top ups get their own stream so they dont disturb the games
+    game::Random random(options.seed ^ 0x5bd1e995ULL);
+    std::vector<game::SimAudioEvent> sounds;
+
+    // the mixer has to outlive the manager playing through it
+    audio_manager::SoftwareMixer mixer;
+    audio_manager::AudioManager am;
+    std::vector<int16_t> audio;
+    int explosion = -1;
+    if (!options.audio.empty()){
+        am.InitWithBackend(&mixer);
+        explosion = am.AddSound((std::string(RESOURCES_DIRECTORY) + std::string("/audio/frog.wav")).c_str());
+    }
+
+    typedef std::chrono::steady_clock Clock;
+    Clock::duration elapsed = Clock::duration::zero();
+    long long entity_ticks = 0;
+
+    // the world partway through, and the top up stream as it was then
+    game::Snapshot snapshot;
+    uint32_t random_state[4];
+    double save_us = 0.0;
+
+    for (int t = 0; t < options.ticks; t++){
+        if (t == options.snapshot){
+            Clock::time_point start = Clock::now();
+            simulation.Save(snapshot);
+            save_us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+            random.GetState(random_state);
+        }
+
+        uint8_t keys = PrepareTick(simulation, random, options, num_enemies, t);
+
+        entity_ticks += simulation.GetNumEntities();
+
+        Clock::time_point start = Clock::now();
+        simulation.HandleControls(keys, delta_time);
+        simulation.Update(delta_time);
+        elapsed += Clock::now() - start;
+
+        // nobody is listening, unless were writing it out
+        sounds.clear();
+        simulation.TakeAudioEvents(sounds);
+        if (explosion >= 0){
+            for (int i = 0; i < sounds.size(); i++){
+                am.PlaySound(explosion, sounds[i].position.x, sounds[i].position.y, 0.0);
+            }
+            glm::vec3 listener = simulation.GetPlayer()->GetPosition();
+            am.SetListenerPosition(listener.x, listener.y, 0.0);
+            am.Update(delta_time);
+
+            // counted from the start so the ticks dont drift from the sample rate
+            long long from = static_cast<long long>(t * delta_time * mixer.GetSampleRate() + 0.5);
+            long long to = static_cast<long long>((t + 1) * delta_time * mixer.GetSampleRate() + 0.5);
+            int frames = static_cast<int>(to - from);
+            audio.resize(audio.size() + frames * 2);
+            mixer.Render(&audio[audio.size() - frames * 2], frames);
+        }
+
+        game::AllocTracker::EndFrame();
+    }
+
+    double total_ns = std::chrono::duration<double, std::nano>(elapsed).count();
+    double average_entities = static_cast<double>(entity_ticks) / options.ticks;
+
+    std::cout << "enemies " << num_enemies << ", collectibles " << options.collectibles << ", ticks " << options.ticks << std::endl;
+    std::cout << "  total " << total_ns / 1.0e6 << " ms, " << total_ns / options.ticks << " ns/tick, "
+              << (entity_ticks > 0 ? total_ns / entity_ticks : 0.0) << " ns/entity (" << average_entities << " entities on average)" << std::endl;
+    std::cout << "  final score " << simulation.GetScore() << std::endl;
+
+    if (!snapshot.IsEmpty()){
+        game::Snapshot end;
+        simulation.Save(end);
+
+        Clock::time_point start = Clock::now();
+        simulation.Restore(snapshot);
+        double restore_us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+        random.SetState(random_state);
+
+        for (int t = options.snapshot; t < options.ticks; t++){
+            uint8_t keys = PrepareTick(simulation, random, options, num_enemies, t);
+            simulation.HandleControls(keys, delta_time);
+            simulation.Update(delta_time);
+            sounds.clear();
+            simulation.TakeAudioEvents(sounds);
+        }
+
+        game::Snapshot again;
+        simulation.Save(again);
+        std::cout << "  snapshot at tick " << options.snapshot << ": " << snapshot.GetSize() << " bytes, saved in " << save_us << " us, restored in "
+                  << restore_us << " us, the run from it came out " << (again.GetData() == end.GetData() ? "the same" : "DIFFERENT") << std::endl;
+    }
+
+    if (explosion >= 0){
+        audio_manager::SoftwareMixer::WriteWav(options.audio.c_str(), audio, mixer.GetSampleRate());
+        std::cout << "  audio " << audio.size() / 2 << " frames written to " << options.audio << std::endl;
+    }
+}
+
+
+// What a co-op player presses on a frame, each sticks with something for a while and changes at its own pace
+// so the other side guesses right most of the time but not always
+uint8_t CoopKeys(int player, int frame)
+{
+    const uint8_t keys[] = {
+        INPUT_KEY_W | INPUT_KEY_A | INPUT_KEY_SPACE,
+        INPUT_KEY_W | INPUT_KEY_D | INPUT_KEY_SPACE,
+        INPUT_KEY_W | INPUT_KEY_SPACE,
+        INPUT_KEY_S | INPUT_KEY_Q,
+        INPUT_KEY_E | INPUT_KEY_LEFT_SHIFT,
+        0
+    };
+    game::Random random(static_cast<uint64_t>(frame / (20 + 7 * player)) * 2 + player);
+    return keys[random.NextInt(sizeof(keys))];
+}
+
+
+// Run a two player game with every key known, the same way a rollback session runs a frame
+void RunCoopReference(game::Simulation &simulation, game::Snapshot &start, int ticks)
+{
+    for (int t = 0; t < ticks; t++){
+        for (int p = 0; p < 2; p++){
+            simulation.HandleControls(p, t < ROLLBACK_INPUT_DELAY ? 0 : CoopKeys(p, t - ROLLBACK_INPUT_DELAY), ROLLBACK_TICK);
+        }
+        simulation.Update(ROLLBACK_TICK);
+        if (simulation.IsOver()) simulation.Restore(start);
+    }
+}
+
+
+void RunCoop(const BenchOptions &options)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    game::NetConditions conditions;
+    conditions.latency = options.latency;
+    conditions.jitter = options.jitter;
+    conditions.loss = options.loss;
+
+    // the second player starts off with another seed, the hello has to sort that out
+    game::Simulation simulations[2];
+    game::RollbackSession sessions[2];
+    for (int p = 0; p < 2; p++){
+        sessions[p].Open(p, options.coop + p, game::NetAddress::Loopback(options.coop + 1 - p), options.seed + p, conditions);
+    }
+
+    // the bench keeps its own clock, a tick of it per pass so the pretend latency is in game time
+    int t = 0;
+    bool connected = false;
+    while (!connected){
+        if (t++ > 600) throw(std::runtime_error(std::string("The co-op players never heard from each other")));
+        bool first = sessions[0].Connect(t * ROLLBACK_TICK);
+        bool second = sessions[1].Connect(t * ROLLBACK_TICK);
+        connected = first && second;
+    }
+
+    for (int p = 0; p < 2; p++){
+        simulations[p].Seed(sessions[p].GetSeed());
+        simulations[p].SetNumPlayers(2);
+        simulations[p].Setup(game::SimulationAssets());
+        sessions[p].Begin(&simulations[p]);
+    }
+
+    std::vector<game::SimAudioEvent> sounds;
+    Clock::time_point start = Clock::now();
+
+    // the peers run their frames and then keep talking until each has the others keys for all of them
+    int limit = t + options.ticks * 4 + 600;
+    while (sessions[0].GetConfirmedFrame() < options.ticks || sessions[1].GetConfirmedFrame() < options.ticks ||
+           sessions[0].GetFrame() < options.ticks || sessions[1].GetFrame() < options.ticks){
+        if (t++ > limit) throw(std::runtime_error(std::string("The co-op game got stuck")));
+
+        for (int p = 0; p < 2; p++){
+            if (sessions[p].GetFrame() < options.ticks) sessions[p].AdvanceFrame(CoopKeys(p, sessions[p].GetFrame()), t * ROLLBACK_TICK);
+            else sessions[p].Poll(t * ROLLBACK_TICK);
+
+            sounds.clear();
+            simulations[p].TakeAudioEvents(sounds);
+        }
+    }
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    game::Simulation reference;
+    game::Snapshot reference_start;
+    reference.Seed(sessions[0].GetSeed());
+    reference.SetNumPlayers(2);
+    reference.Setup(game::SimulationAssets());
+    reference.Save(reference_start);
+    RunCoopReference(reference, reference_start, options.ticks);
+
+    game::Snapshot ends[3];
+    simulations[0].Save(ends[0]);
+    simulations[1].Save(ends[1]);
+    reference.Save(ends[2]);
+
+    std::cout << "co-op, ticks " << options.ticks << ", latency " << options.latency * 1000.0 << " ms, jitter " << options.jitter * 1000.0
+              << " ms, loss " << options.loss * 100.0 << "%" << std::endl;
+    std::cout << "  both players took " << elapsed * 1000.0 << " ms, final score " << simulations[0].GetScore() << std::endl;
+    for (int p = 0; p < 2; p++){
+        std::cout << "player " << p << std::endl;
+        sessions[p].GetStats().Report(std::cout);
+    }
+    std::cout << "  the two games came out " << (ends[0].GetData() == ends[1].GetData() ? "the same" : "DIFFERENT") << ", and "
+              << (ends[0].GetData() == ends[2].GetData() ? "the same" : "DIFFERENT") << " as the game without a network" << std::endl;
+}
+
+
+void RunStress(const std::string &filename)
+{
+    game::StressScenario scenario;
+    scenario.Load(filename);
+
+    game::Simulation simulation;
+    simulation.Seed(scenario.GetSeed());
+    simulation.Setup(game::SimulationAssets());
+    simulation.SetInvulnerable(true);
+
+    typedef std::chrono::steady_clock Clock;
+    std::vector<game::SimAudioEvent> sounds;
+    double delta_time = scenario.GetDeltaTime();
+
+    // theres nothing to draw so a frame is just the controls and the update
+    for (int t = 0; t < scenario.GetTicks(); t++){
+        scenario.Populate(simulation, t);
+
+        Clock::time_point start = Clock::now();
+        simulation.HandleControls(scenario.GetKeys(t), delta_time);
+        simulation.Update(delta_time);
+        scenario.RecordFrame(t, std::chrono::duration<double>(Clock::now() - start).count(), simulation);
+
+        sounds.clear();
+        simulation.TakeAudioEvents(sounds);
+
+        game::AllocTracker::EndFrame();
+    }
+
+    scenario.Report(std::cout);
+}
+
+
+void RunSessions(const BenchOptions &options)
+{
+    game::SessionRunner runner;
+    runner.Setup(options.sessions, options.seed, options.ticks, options.level);
+    runner.Run(options.threads);
+    runner.Report(std::cout);
+
+    // a session has nothing to do with the ones beside it, so on its own it has to end exactly the same
+    // and how fast it goes alone is what the threads are up against
+    int reruns = std::min(options.sessions, 4);
+    int same = 0;
+    long long ticks = 0;
+    double seconds = 0.0;
+    for (int i = 0; i < reruns; i++){
+        const game::SessionResult &result = runner.GetResults()[i];
+        game::SessionResult alone = game::SessionRunner::RunSession(result.seed, options.ticks, options.level);
+        if (alone.checksum == result.checksum) same++;
+        ticks += alone.ticks;
+        seconds += alone.seconds;
+    }
+    double single = seconds > 0.0 ? ticks / seconds : 0.0;
+    std::cout << "  " << same << " of " << reruns << " sessions played again alone came out " << (same == reruns ? "the same" : "DIFFERENT")
+              << ", at " << static_cast<long long>(single) << " ticks/s, "
+              << (single > 0.0 ? runner.GetTotalTicks() / runner.GetSeconds() / single : 0.0) << "x that all together" << std::endl;
+}
+
+} // namespace
+
+
+int main(int argc, char *argv[]){
+
+    BenchOptions options;
+    options.ticks = 3600;
+    options.enemies.push_back(50);
+    options.collectibles = 20;
+    options.seed = 1;
+    options.snapshot = -1;
+    options.coop = 0;
+    options.latency = 0.0;
+    options.jitter = 0.0;
+    options.loss = 0.0;
+    options.sessions = 0;
+    options.threads = 0;
+
+    try {
+        ParseOptions(argc, argv, options);
+        PROFILE_THREAD("Main");
+
+        if (!options.scenario.empty()){
+            RunStress(options.scenario);
+        } else if (options.coop > 0){
+            RunCoop(options);
+        } else if (options.sessions > 0){
+            RunSessions(options);
+        } else {
+            std::cout << "Headless simulation benchmark, seed " << options.seed << std::endl;
+            for (int i = 0; i < options.enemies.size(); i++){
+                RunScenario(options, options.enemies[i]);
+            }
+        }
+
+        if (!options.trace.empty()){
+            game::Profiler::WriteChromeTrace(options.trace);
+        }
+
+        if (game::AllocTracker::IsEnabled()) game::AllocTracker::Report(std::cout);
+    }
+    catch (std::exception &e){
+        // Catch and print any errors
+        PrintException(e);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,268 @@
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "game_server.h"
+#include "game_client.h"
+#include "input_recorder.h"
+#include "profiler.h"
+
+// Macro for printing exceptions
+#define PrintException(exception_object)\
+    std::cerr << exception_object.what() << std::endl
+
+/*
+    Hosts a game for clients over UDP with no window, no OpenGL and no sound card, the world runs at a fixed
+    60 ticks a second and every client gets delta snapshots of what is near its ship, see GameServer
+
+    usage: HeadlessServer [--port P] [--players N] [--seed S] [--seconds T]
+
+    It runs for T seconds (forever if 0) and prints how its going every 10 seconds, then the tick times and
+    bandwidth at the end
+    With --harness <clients> it plays that many scripted clients against itself on this machine instead, as
+    fast as it can on a clock of its own, through --latency <ms>, --jitter <ms> and --loss <percent> of bad
+    network for --ticks ticks, and checks every snapshot a client puts together is what the server sent it
+*/
+
+namespace {
+
+struct ServerOptions {
+    int port;
+    int players;
+    unsigned long long seed;
+    double seconds;
+    int harness;
+    int ticks;
+    double latency;
+    double jitter;
+    double loss;
+};
+
+
+void ParseOptions(int argc, char *argv[], ServerOptions &options)
+{
+    for (int i = 1; i < argc; i++){
+        std::string arg(argv[i]);
+        if (i + 1 >= argc){
+            throw(std::runtime_error(std::string("Missing value for ") + arg));
+        }
+        std::string value(argv[++i]);
+
+        if (arg == "--port"){
+            options.port = atoi(value.c_str());
+        } else if (arg == "--players"){
+            options.players = atoi(value.c_str());
+        } else if (arg == "--seed"){
+            options.seed = strtoull(value.c_str(), NULL, 10);
+        } else if (arg == "--seconds"){
+            options.seconds = atof(value.c_str());
+        } else if (arg == "--harness"){
+            options.harness = atoi(value.c_str());
+        } else if (arg == "--ticks"){
+            options.ticks = atoi(value.c_str());
+        } else if (arg == "--latency"){
+            options.latency = atof(value.c_str()) / 1000.0;
+        } else if (arg == "--jitter"){
+            options.jitter = atof(value.c_str()) / 1000.0;
+        } else if (arg == "--loss"){
+            options.loss = atof(value.c_str()) / 100.0;
+        } else {
+            throw(std::runtime_error(std::string("Unknown argument ") + arg));
+        }
+    }
+
+    // the harness fills every ship unless told otherwise
+    if (options.players <= 0) options.players = options.harness > 0 ? options.harness : 2;
+    if (options.harness > options.players){
+        throw(std::runtime_error(std::string("The harness cant have more clients than there are ships")));
+    }
+}
+
+
+// What a scripted client presses on a tick, each sticks with something for a while and changes at its own pace
+uint8_t BotKeys(int client, int tick)
+{
+    const uint8_t keys[] = {
+        INPUT_KEY_W | INPUT_KEY_A | INPUT_KEY_SPACE,
+        INPUT_KEY_W | INPUT_KEY_D | INPUT_KEY_SPACE,
+        INPUT_KEY_W | INPUT_KEY_SPACE,
+        INPUT_KEY_W,
+        INPUT_KEY_E | INPUT_KEY_LEFT_SHIFT,
+        0
+    };
+    game::Random random(static_cast<uint64_t>(tick / (30 + 11 * client)) * 16 + client);
+    return keys[random.NextInt(sizeof(keys))];
+}
+
+
+void RunServer(const ServerOptions &options)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    game::GameServer server;
+    server.Open(options.port, options.players, options.seed);
+    std::cout << "Serving " << options.players << " ships on port " << server.GetPort() << ", seed " << options.seed << std::endl;
+
+    Clock::time_point start = Clock::now();
+    double next = 0.0;
+    double report = 10.0;
+    long long bytes = 0;
+    while (true){
+        double now = std::chrono::duration<double>(Clock::now() - start).count();
+        if (options.seconds > 0.0 && now >= options.seconds) break;
+
+        if (now < next){
+            std::this_thread::sleep_for(std::chrono::duration<double>(next - now));
+            continue;
+        }
+
+        server.Tick(now);
+        next += SERVER_TICK;
+
+        // too far behind to catch up, the missed ticks are let go rather than run back to back
+        if (now - next > 0.25) next = now;
+
+        if (now >= report){
+            const game::ServerStats &stats = server.GetStats();
+            std::cout << "  " << static_cast<int>(now) << " s: " << server.GetNumClients() << " clients, tick " << server.GetTick() << ", "
+                      << (stats.bytes_sent - bytes) / 10.0 / 1024.0 << " KB/s out, slowest tick " << stats.max_tick_seconds * 1000.0 << " ms" << std::endl;
+            bytes = stats.bytes_sent;
+            report += 10.0;
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::cout << "Served for " << seconds << " s" << std::endl;
+    server.GetStats().Report(std::cout, seconds);
+}
+
+
+void RunHarness(const ServerOptions &options)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    game::NetConditions conditions;
+    conditions.latency = options.latency;
+    conditions.jitter = options.jitter;
+    conditions.loss = options.loss;
+
+    // the bad weather goes both ways
+    game::GameServer server;
+    server.Open(options.port, options.players, options.seed, conditions);
+
+    std::vector<game::GameClient> clients(options.harness);
+    for (int c = 0; c < clients.size(); c++){
+        clients[c].Open(0, game::NetAddress::Loopback(server.GetPort()), options.seed + 1 + c, conditions);
+    }
+
+    // a tick of the harness clock per pass, so the pretend latency is in game time
+    int t = 0;
+    bool connected = false;
+    while (!connected){
+        if (t++ > 600) throw(std::runtime_error(std::string("The clients never got in")));
+        double now = t * SERVER_TICK;
+        server.Tick(now);
+        connected = true;
+        for (int c = 0; c < clients.size(); c++){
+            if (!clients[c].Connect(now)) connected = false;
+        }
+    }
+
+    // every time a client puts a new snapshot together it has to be what the server meant it to have
+    std::vector<int> checked(clients.size(), -1);
+    long long compared = 0;
+    long long different = 0;
+    long long unknown = 0;
+    long long entities = 0;
+
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < options.ticks; i++){
+        double now = ++t * SERVER_TICK;
+        server.Tick(now);
+
+        for (int c = 0; c < clients.size(); c++){
+            clients[c].Update(BotKeys(c, i), now);
+
+            int sequence = clients[c].GetSequence();
+            if (sequence == checked[c]) continue;
+            checked[c] = sequence;
+
+            const game::NetWorld *sent = server.GetSent(clients[c].GetPlayer(), sequence);
+            if (!sent){
+                unknown++;
+                continue;
+            }
+            compared++;
+            entities += sent->entities.size();
+            if (*sent != clients[c].GetWorld()){
+                if (different == 0) std::cerr << "Client " << c << " put snapshot " << sequence << " together wrong" << std::endl;
+                different++;
+            }
+        }
+    }
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    // the goodbyes have to get through the pretend network too, the ones that dont are timed out
+    for (int c = 0; c < clients.size(); c++){
+        clients[c].Leave(t * SERVER_TICK);
+    }
+    for (int i = 0; i < 600 && server.GetNumClients() > 0; i++){
+        double now = ++t * SERVER_TICK;
+        server.Tick(now);
+        for (int c = 0; c < clients.size(); c++){
+            clients[c].Update(0, now);
+        }
+    }
+
+    std::cout << "server harness, " << clients.size() << " clients on " << options.players << " ships, ticks " << options.ticks << ", latency "
+              << options.latency * 1000.0 << " ms, jitter " << options.jitter * 1000.0 << " ms, loss " << options.loss * 100.0 << "%" << std::endl;
+    std::cout << "  took " << elapsed * 1000.0 << " ms for " << options.ticks * SERVER_TICK << " s of game, final score " << server.GetSimulation().GetScore() << std::endl;
+    std::cout << "server" << std::endl;
+    server.GetStats().Report(std::cout, options.ticks * SERVER_TICK);
+    for (int c = 0; c < clients.size(); c++){
+        std::cout << "client " << c << " (ship " << clients[c].GetPlayer() << ")" << std::endl;
+        clients[c].GetStats().Report(std::cout);
+    }
+    std::cout << "  snapshots checked " << compared << " (" << (compared > 0 ? static_cast<double>(entities) / compared : 0.0) << " entities each), "
+              << different << " put together wrong, " << unknown << " too old to check" << std::endl;
+}
+
+} // namespace
+
+
+int main(int argc, char *argv[]){
+
+    ServerOptions options;
+    options.port = 40500;
+    options.players = 0;
+    options.seed = 1;
+    options.seconds = 0.0;
+    options.harness = 0;
+    options.ticks = 3600;
+    options.latency = 0.0;
+    options.jitter = 0.0;
+    options.loss = 0.0;
+
+    try {
+        ParseOptions(argc, argv, options);
+        PROFILE_THREAD("Main");
+
+        if (options.harness > 0){
+            RunHarness(options);
+        } else {
+            RunServer(options);
+        }
+    }
+    catch (std::exception &e){
+        // Catch and print any errors
+        PrintException(e);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,15 @@
+#include "hud.h"
+
+namespace game {
+
+void SplitDigits(int value, int *digits, int count)
+{
+    // peel the digits off one at a time instead of dividing by a power of ten for each
+    for (int i = 0; i < count; i++)
+    {
+        digits[i] = value % 10;
+        value /= 10;
+    }
+}
+
+} // namespace game
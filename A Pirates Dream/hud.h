@@ -0,0 +1,12 @@
+#ifndef HUD_H_
+#define HUD_H_
+
+namespace game {
+
+    // Split a value into its last count decimal digits, ones first
+    // Used to pick the number textures for the score and the power up timer
+    void SplitDigits(int value, int *digits, int count);
+
+} // namespace game
+
+#endif // HUD_H_
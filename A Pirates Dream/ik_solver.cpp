@@ -0,0 +1,183 @@
+#include <cmath>
+
+#include "ik_solver.h"
+
+namespace game {
+
+IkSolver::IkSolver(void)
+{
+    tolerance_ = 0.01f;
+}
+
+
+int IkSolver::AddChain(const glm::vec2 &base, const glm::vec2 &direction, int segments, float segment_length)
+{
+    first_.push_back(joint_x_.size());
+    count_.push_back(segments + 1);
+    budget_.push_back(4);
+    reach_.push_back(segments * segment_length);
+
+    base_x_.push_back(base.x);
+    base_y_.push_back(base.y);
+
+    glm::vec2 dir = glm::normalize(direction);
+    for (int i = 0; i <= segments; i++)
+    {
+        joint_x_.push_back(base.x + dir.x * segment_length * i);
+        joint_y_.push_back(base.y + dir.y * segment_length * i);
+        length_.push_back(i == 0 ? 0.0f : segment_length);
+    }
+
+    // start out reaching straight ahead
+    target_x_.push_back(joint_x_.back());
+    target_y_.push_back(joint_y_.back());
+
+    return first_.size() - 1;
+}
+
+
+void IkSolver::Clear(void)
+{
+    joint_x_.clear();
+    joint_y_.clear();
+    length_.clear();
+    first_.clear();
+    count_.clear();
+    budget_.clear();
+    reach_.clear();
+    base_x_.clear();
+    base_y_.clear();
+    target_x_.clear();
+    target_y_.clear();
+}
+
+
+void IkSolver::SetBase(int chain, const glm::vec2 &base)
+{
+    base_x_[chain] = base.x;
+    base_y_[chain] = base.y;
+}
+
+
+void IkSolver::SetTarget(int chain, const glm::vec2 &target)
+{
+    target_x_[chain] = target.x;
+    target_y_[chain] = target.y;
+}
+
+
+int IkSolver::Solve(void)
+{
+    int passes = 0;
+    for (int c = 0; c < first_.size(); c++)
+    {
+        passes += SolveChain(c);
+    }
+    return passes;
+}
+
+
+int IkSolver::SolveChain(int chain)
+{
+    float *x = &joint_x_[first_[chain]];
+    float *y = &joint_y_[first_[chain]];
+    const float *length = &length_[first_[chain]];
+    int n = count_[chain];
+
+    float bx = base_x_[chain];
+    float by = base_y_[chain];
+    float tx = target_x_[chain];
+    float ty = target_y_[chain];
+
+    // out of reach, just point the chain straight at the target
+    float dx = tx - bx;
+    float dy = ty - by;
+    if (dx * dx + dy * dy >= reach_[chain] * reach_[chain])
+    {
+        x[0] = bx;
+        y[0] = by;
+        for (int i = 1; i < n; i++)
+        {
+            float ex = tx - x[i - 1];
+            float ey = ty - y[i - 1];
+            float scale = length[i] / sqrt(ex * ex + ey * ey + 1e-12f);
+            x[i] = x[i - 1] + ex * scale;
+            y[i] = y[i - 1] + ey * scale;
+        }
+        return 1;
+    }
+
+    float tolerance_squared = tolerance_ * tolerance_;
+    int pass = 0;
+    for (; pass < budget_[chain]; pass++)
+    {
+        // a pass is only needed while the tip is off the target or the base has moved off its anchor
+        float tip_x = tx - x[n - 1];
+        float tip_y = ty - y[n - 1];
+        float root_x = bx - x[0];
+        float root_y = by - y[0];
+        if (tip_x * tip_x + tip_y * tip_y <= tolerance_squared && root_x * root_x + root_y * root_y <= tolerance_squared) break;
+
+        // backwards: pin the tip on the target and pull each joint after the one past it
+        x[n - 1] = tx;
+        y[n - 1] = ty;
+        for (int i = n - 2; i >= 0; i--)
+        {
+            float ex = x[i] - x[i + 1];
+            float ey = y[i] - y[i + 1];
+            float scale = length[i + 1] / sqrt(ex * ex + ey * ey + 1e-12f);
+            x[i] = x[i + 1] + ex * scale;
+            y[i] = y[i + 1] + ey * scale;
+        }
+
+        // forwards: pin the base back on its anchor and push each joint out after the one before it
+        x[0] = bx;
+        y[0] = by;
+        for (int i = 1; i < n; i++)
+        {
+            float ex = x[i] - x[i - 1];
+            float ey = y[i] - y[i - 1];
+            float scale = length[i] / sqrt(ex * ex + ey * ey + 1e-12f);
+            x[i] = x[i - 1] + ex * scale;
+            y[i] = y[i - 1] + ey * scale;
+        }
+    }
+
+    return pass;
+}
+
+
+void IkSolver::Save(Snapshot &snapshot) const
+{
+    snapshot.WriteVector(joint_x_);
+    snapshot.WriteVector(joint_y_);
+    snapshot.WriteVector(length_);
+    snapshot.WriteVector(first_);
+    snapshot.WriteVector(count_);
+    snapshot.WriteVector(budget_);
+    snapshot.WriteVector(reach_);
+    snapshot.WriteVector(base_x_);
+    snapshot.WriteVector(base_y_);
+    snapshot.WriteVector(target_x_);
+    snapshot.WriteVector(target_y_);
+    snapshot.Write(tolerance_);
+}
+
+
+void IkSolver::Load(Snapshot &snapshot)
+{
+    snapshot.ReadVector(joint_x_);
+    snapshot.ReadVector(joint_y_);
+    snapshot.ReadVector(length_);
+    snapshot.ReadVector(first_);
+    snapshot.ReadVector(count_);
+    snapshot.ReadVector(budget_);
+    snapshot.ReadVector(reach_);
+    snapshot.ReadVector(base_x_);
+    snapshot.ReadVector(base_y_);
+    snapshot.ReadVector(target_x_);
+    snapshot.ReadVector(target_y_);
+    snapshot.Read(tolerance_);
+}
+
+} // namespace game
@@ -0,0 +1,83 @@
+#ifndef IK_SOLVER_H_
+#define IK_SOLVER_H_
+
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "snapshot.h"
+
+namespace game {
+
+    /*
+        IkSolver bends chains of segments (the krakens tentacles) so their tips reach for a target, using FABRIK
+        Each pass drags the chain from the tip to the target and then back from the base to where it is anchored,
+        which keeps every segment its own length and settles in a handful of passes
+        The joints of every chain live in one set of flat arrays (x, y and segment length side by side), and
+        Solve() works through all the chains in one go, each stopping once its tip is close enough or it has
+        used up its own budget of passes, so the arms that matter can be given more time than the ones idling
+    */
+    class IkSolver {
+
+        public:
+            // Constructor
+            IkSolver(void);
+
+            // Add a chain of equal segments laid out straight from the base along a direction, returns its index
+            int AddChain(const glm::vec2 &base, const glm::vec2 &direction, int segments, float segment_length);
+
+            // Remove every chain
+            void Clear(void);
+
+            // Move where a chain is anchored and what it reaches for
+            void SetBase(int chain, const glm::vec2 &base);
+            void SetTarget(int chain, const glm::vec2 &target);
+
+            // How many passes a chain may use per solve
+            inline void SetBudget(int chain, int iterations) { budget_[chain] = iterations; }
+
+            // How close the tip has to get before a chain stops early
+            inline void SetTolerance(float tolerance) { tolerance_ = tolerance; }
+
+            // Solve every chain, returns the number of passes used over all of them
+            int Solve(void);
+
+            // Save or restore every chain as it is posed now, each solve starts from the last pose
+            void Save(Snapshot &snapshot) const;
+            void Load(Snapshot &snapshot);
+
+            // Getters
+            inline int GetNumChains(void) const { return first_.size(); }
+            inline int GetNumJoints(int chain) const { return count_[chain]; }
+            inline float GetReach(int chain) const { return reach_[chain]; }
+            inline glm::vec2 GetJoint(int chain, int joint) const { return glm::vec2(joint_x_[first_[chain] + joint], joint_y_[first_[chain] + joint]); }
+
+        private:
+            // every joint of every chain, chain c owns joints first_[c] to first_[c] + count_[c] - 1
+            std::vector<float> joint_x_;
+            std::vector<float> joint_y_;
+
+            // the length of the segment that ends at each joint (0 for the base joint)
+            std::vector<float> length_;
+
+            // per chain: where its joints start, how many there are, its budget and its total length
+            std::vector<int> first_;
+            std::vector<int> count_;
+            std::vector<int> budget_;
+            std::vector<float> reach_;
+
+            // per chain anchors and targets
+            std::vector<float> base_x_;
+            std::vector<float> base_y_;
+            std::vector<float> target_x_;
+            std::vector<float> target_y_;
+
+            float tolerance_;
+
+            // Solve one chain, returns the passes it took
+            int SolveChain(int chain);
+
+    }; // class IkSolver
+
+} // namespace game
+
+#endif // IK_SOLVER_H_
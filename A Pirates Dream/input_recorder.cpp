@@ -0,0 +1,165 @@
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "input_recorder.h"
+
+// marks the start of a recording file, followed by the format version
+#define INPUT_FILE_MAGIC "APDI"
+#define INPUT_FILE_VERSION 1
+
+namespace game {
+
+// everything in the file is little endian so recordings move between machines
+static void WriteU32(std::ofstream &f, uint32_t value)
+{
+    unsigned char bytes[4];
+    for (int i = 0; i < 4; i++) bytes[i] = (value >> (8 * i)) & 0xff;
+    f.write(reinterpret_cast<const char *>(bytes), 4);
+}
+
+
+static uint32_t ReadU32(std::ifstream &f)
+{
+    unsigned char bytes[4] = { 0, 0, 0, 0 };
+    f.read(reinterpret_cast<char *>(bytes), 4);
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) value |= static_cast<uint32_t>(bytes[i]) << (8 * i);
+    return value;
+}
+
+
+InputRecorder::InputRecorder(void)
+{
+    seed_ = 0;
+    cursor_ = 0;
+    recording_ = false;
+    replaying_ = false;
+}
+
+
+void InputRecorder::StartRecording(uint64_t seed)
+{
+    seed_ = seed;
+    keys_.clear();
+    delta_times_.clear();
+    cursor_ = 0;
+    recording_ = true;
+    replaying_ = false;
+}
+
+
+double InputRecorder::Record(uint8_t keys, double delta_time)
+{
+    float stored = static_cast<float>(delta_time);
+    keys_.push_back(keys);
+    delta_times_.push_back(stored);
+    return stored;
+}
+
+
+void InputRecorder::Save(const std::string &filename) const
+{
+    std::ofstream f(filename.c_str(), std::ios::out | std::ios::binary);
+    if (f.fail()) {
+        throw(std::ios_base::failure(std::string("Error opening file ") + filename));
+    }
+
+    f.write(INPUT_FILE_MAGIC, 4);
+    WriteU32(f, INPUT_FILE_VERSION);
+    WriteU32(f, static_cast<uint32_t>(seed_));
+    WriteU32(f, static_cast<uint32_t>(seed_ >> 32));
+    WriteU32(f, keys_.size());
+
+    // key states as runs of (state, count), a run ends when the keys change or the count would overflow
+    int i = 0;
+    while (i < keys_.size())
+    {
+        int run = 1;
+        while (i + run < keys_.size() && keys_[i + run] == keys_[i] && run < 0xffff) run++;
+
+        unsigned char bytes[3] = { keys_[i], static_cast<unsigned char>(run & 0xff), static_cast<unsigned char>(run >> 8) };
+        f.write(reinterpret_cast<const char *>(bytes), 3);
+        i += run;
+    }
+
+    // then the delta times, bit for bit
+    for (int t = 0; t < delta_times_.size(); t++)
+    {
+        uint32_t bits;
+        memcpy(&bits, &delta_times_[t], 4);
+        WriteU32(f, bits);
+    }
+
+    if (f.fail()) {
+        throw(std::ios_base::failure(std::string("Error writing file ") + filename));
+    }
+}
+
+
+void InputRecorder::Load(const std::string &filename)
+{
+    std::ifstream f(filename.c_str(), std::ios::in | std::ios::binary);
+    if (f.fail()) {
+        throw(std::ios_base::failure(std::string("Error opening file ") + filename));
+    }
+
+    char magic[4];
+    f.read(magic, 4);
+    if (f.fail() || memcmp(magic, INPUT_FILE_MAGIC, 4) != 0) {
+        throw(std::runtime_error(std::string("Not an input recording: ") + filename));
+    }
+    if (ReadU32(f) != INPUT_FILE_VERSION) {
+        throw(std::runtime_error(std::string("Unsupported input recording version in ") + filename));
+    }
+
+    uint64_t low = ReadU32(f);
+    uint64_t high = ReadU32(f);
+    seed_ = low | (high << 32);
+    int num_ticks = ReadU32(f);
+
+    keys_.clear();
+    delta_times_.clear();
+    keys_.reserve(num_ticks);
+    delta_times_.reserve(num_ticks);
+
+    while (keys_.size() < num_ticks)
+    {
+        unsigned char bytes[3];
+        f.read(reinterpret_cast<char *>(bytes), 3);
+        int run = bytes[1] | (bytes[2] << 8);
+        if (f.fail() || run == 0 || keys_.size() + run > num_ticks) {
+            throw(std::runtime_error(std::string("Corrupt input recording ") + filename));
+        }
+        keys_.insert(keys_.end(), run, bytes[0]);
+    }
+
+    for (int i = 0; i < num_ticks; i++)
+    {
+        uint32_t bits = ReadU32(f);
+        float delta_time;
+        memcpy(&delta_time, &bits, 4);
+        delta_times_.push_back(delta_time);
+    }
+
+    if (f.fail()) {
+        throw(std::runtime_error(std::string("Corrupt input recording ") + filename));
+    }
+
+    cursor_ = 0;
+    recording_ = false;
+    replaying_ = true;
+}
+
+
+bool InputRecorder::Next(uint8_t &keys, double &delta_time)
+{
+    if (cursor_ >= keys_.size()) return false;
+
+    keys = keys_[cursor_];
+    delta_time = delta_times_[cursor_];
+    cursor_++;
+    return true;
+}
+
+} // namespace game
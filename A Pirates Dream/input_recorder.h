@@ -0,0 +1,72 @@
+#ifndef INPUT_RECORDER_H_
+#define INPUT_RECORDER_H_
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+// one bit per key the game reads, a tick of input fits in a single byte
+#define INPUT_KEY_W (1 << 0)
+#define INPUT_KEY_S (1 << 1)
+#define INPUT_KEY_Q (1 << 2)
+#define INPUT_KEY_E (1 << 3)
+#define INPUT_KEY_A (1 << 4)
+#define INPUT_KEY_D (1 << 5)
+#define INPUT_KEY_SPACE (1 << 6)
+#define INPUT_KEY_LEFT_SHIFT (1 << 7)
+
+namespace game {
+
+    /*
+        InputRecorder keeps the key state and delta time of every tick together with the seed of
+        the random streams, which is everything the game needs to play a session out the same way again
+        In the file the key states are run length encoded (they hardly ever change from one tick to
+        the next) and followed by the delta times
+    */
+    class InputRecorder {
+
+        public:
+            // Constructor
+            InputRecorder(void);
+
+            // Start a new recording for a game seeded with seed
+            void StartRecording(uint64_t seed);
+
+            // Add one tick, returns the delta time as it was stored so the live game can use exactly
+            // the value a replay will see
+            double Record(uint8_t keys, double delta_time);
+
+            // Write the recording to a file, throws if the file cant be written
+            void Save(const std::string &filename) const;
+
+            // Read a recording and get ready to replay it, throws if the file cant be read
+            void Load(const std::string &filename);
+
+            // Get the next tick of a replay, returns false once the recording has run out
+            bool Next(uint8_t &keys, double &delta_time);
+
+            // Getters
+            inline bool IsRecording(void) const { return recording_; }
+            inline bool IsReplaying(void) const { return replaying_; }
+            inline uint64_t GetSeed(void) const { return seed_; }
+            inline int GetNumTicks(void) const { return keys_.size(); }
+
+        private:
+            // the seed of the game the recording belongs to
+            uint64_t seed_;
+
+            // key state and delta time of every tick
+            std::vector<uint8_t> keys_;
+            std::vector<float> delta_times_;
+
+            // the next tick to hand out when replaying
+            int cursor_;
+
+            bool recording_;
+            bool replaying_;
+
+    }; // class InputRecorder
+
+} // namespace game
+
+#endif // INPUT_RECORDER_H_
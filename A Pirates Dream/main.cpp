@@ -1,42 +1,89 @@
-/*
- *
- * A skeleton (mini-engine) for a 2D game
- *
- * Copyright (c) 2020-2024 Oliver van Kaick <Oliver.vanKaick@carleton.ca>, David Mould <mould@scs.carleton.ca>
- * under the MIT License.
- * 
- * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
- * 
- * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
- * 
- * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
- *
- */
-
-#include <iostream>
-#include <exception>
-#include "game.h"
-
-// Macro for printing exceptions
-#define PrintException(exception_object)\
-    std::cerr << exception_object.what() << std::endl
-
-// Main function that builds and runs the game
-int main(void){
-    game::Game the_game;
-
-    try {
-        // Initialize graphics libraries and main window
-        the_game.Init();
-        // Setup the game (game world, game objects, etc.)
-        the_game.Setup();
-        // Run the game
-        the_game.MainLoop();
-    }
-    catch (std::exception &e){
-        // Catch and print any errors
-        PrintException(e);
-    }
-
-    return 0;
-}
+/*
+ *
+ * A skeleton (mini-engine) for a 2D game
+ *
+ * Copyright (c) 2020-2024 Oliver van Kaick <Oliver.vanKaick@carleton.ca>, David Mould <mould@scs.carleton.ca>
+ * under the MIT License.
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include "game.h"
+#include "alloc_tracker.h"
+
+// Macro for printing exceptions
+#define PrintException(exception_object)\
+    std::cerr << exception_object.what() << std::endl
+
+// Main function that builds and runs the game
+int main(int argc, char *argv[]){
+    game::Game the_game;
+
+    try {
+        // --record <file> saves the session when the game closes, --replay <file> plays one back as fast as possible
+        // --stress <file> runs a stress scenario and reports the frame times
+        // --trace <file> writes the profiling zones out for a trace viewer when the game closes
+        // --coop <player> <port> <remote port> plays co-op over UDP with the game on --peer <address> (this machine
+        // by default), --latency <ms>, --jitter <ms> and --loss <percent> make the network worse for testing
+        int coop_player = -1;
+        int coop_port = 0;
+        int coop_remote_port = 0;
+        std::string coop_peer("127.0.0.1");
+        game::NetConditions conditions;
+        for (int i = 1; i < argc; i++){
+            std::string arg(argv[i]);
+            if (arg == "--record" && i + 1 < argc){
+                the_game.RecordTo(argv[++i]);
+            } else if (arg == "--replay" && i + 1 < argc){
+                the_game.ReplayFrom(argv[++i]);
+            } else if (arg == "--stress" && i + 1 < argc){
+                the_game.StressFrom(argv[++i]);
+            } else if (arg == "--trace" && i + 1 < argc){
+                the_game.TraceTo(argv[++i]);
+            } else if (arg == "--coop" && i + 3 < argc){
+                coop_player = atoi(argv[++i]);
+                coop_port = atoi(argv[++i]);
+                coop_remote_port = atoi(argv[++i]);
+            } else if (arg == "--peer" && i + 1 < argc){
+                coop_peer = argv[++i];
+            } else if (arg == "--latency" && i + 1 < argc){
+                conditions.latency = atof(argv[++i]) / 1000.0;
+            } else if (arg == "--jitter" && i + 1 < argc){
+                conditions.jitter = atof(argv[++i]) / 1000.0;
+            } else if (arg == "--loss" && i + 1 < argc){
+                conditions.loss = atof(argv[++i]) / 100.0;
+            } else {
+                throw(std::runtime_error(std::string("Unknown argument ") + arg + std::string(", use --record <file>, --replay <file>, --stress <file>, --trace <file> or --coop <player> <port> <remote port>")));
+            }
+        }
+        if (coop_player >= 0){
+            the_game.CoopWith(coop_player, coop_port, game::NetAddress::Parse(coop_peer, coop_remote_port), conditions);
+        }
+
+        // Initialize graphics libraries and main window
+        the_game.Init();
+        // Setup the game (game world, game objects, etc.)
+        the_game.Setup();
+        // Run the game
+        the_game.MainLoop();
+
+        // where the memory went, when the tracking is compiled in
+        if (game::AllocTracker::IsEnabled()) game::AllocTracker::Report(std::cout);
+    }
+    catch (std::exception &e){
+        // Catch and print any errors
+        PrintException(e);
+    }
+
+    return 0;
+}
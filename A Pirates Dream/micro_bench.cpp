@@ -0,0 +1,463 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include <path_config.h>
+
+#include "game_object.h"
+#include "player_game_object.h"
+#include "enemy_game_object.h"
+#include "particles.h"
+#include "timer_wheel.h"
+#include "collision.h"
+#include "file_utils.h"
+#include "random.h"
+#include "hud.h"
+#include "transform.h"
+#include "ik_solver.h"
+#include "capsule_bvh.h"
+#include "software_mixer.h"
+
+// Macro for printing exceptions
+#define PrintException(exception_object)\
+    std::cerr << exception_object.what() << std::endl
+
+/*
+    Microbenchmarks for the engine hot paths, in the style of Google Benchmark
+    Every benchmark is run with a growing number of iterations until it takes long enough to time
+    reliably, then the time per iteration is printed and can be written out as JSON to diff between commits
+
+    usage: MicroBench [--filter <text>] [--min_time <seconds>] [--json <file>]
+*/
+
+namespace {
+
+// Keep the compiler from throwing away a value we computed only to time it
+template <class T>
+inline void DoNotOptimize(const T &value)
+{
+#if defined(_MSC_VER)
+    const volatile char sink = *reinterpret_cast<const volatile char *>(&value);
+    (void) sink;
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+
+// Handed to each benchmark, loop on KeepRunning() around the code being timed
+class BenchState {
+
+    public:
+        BenchState(long long iterations) : iterations_(iterations), remaining_(iterations) {}
+
+        inline bool KeepRunning(void) { return remaining_-- > 0; }
+        inline long long GetIterations(void) const { return iterations_; }
+
+    private:
+        long long iterations_;
+        long long remaining_;
+};
+
+
+typedef void (*BenchFunction)(BenchState &state);
+
+struct BenchEntry {
+    const char *name;
+    BenchFunction function;
+};
+
+struct BenchResult {
+    std::string name;
+    long long iterations;
+    double real_time;
+    double cpu_time;
+};
+
+
+// the wheel the enemies timers run on
+game::TimerWheel timer_wheel_g;
+
+
+void BM_TransformMatrix(BenchState &state)
+{
+    game::GameObject object(glm::vec3(1.0f, 2.0f, 0.0f), NULL, NULL, 0);
+    object.SetScale(0.5f);
+    float angle = 0.0f;
+    while (state.KeepRunning()){
+        angle += 0.01f;
+        object.SetRotation(angle);
+        glm::mat4 transform = object.GetTransformMatrix();
+        DoNotOptimize(transform);
+    }
+}
+
+
+void BM_TransformMatrixStatic(BenchState &state)
+{
+    // most of the scene doesnt move from one frame to the next
+    game::GameObject object(glm::vec3(1.0f, 2.0f, 0.0f), NULL, NULL, 0);
+    object.SetScale(0.5f);
+    object.SetRotation(0.3f);
+    while (state.KeepRunning()){
+        const glm::mat4 &transform = object.GetTransformMatrix();
+        DoNotOptimize(transform);
+    }
+}
+
+
+void BM_TransformChain(BenchState &state)
+{
+    // an arm eight links long where only the root moves
+    const int links = 8;
+    game::Transform chain[links];
+    for (int i = 1; i < links; i++){
+        chain[i].SetParent(&chain[i - 1]);
+        chain[i].SetLocal(glm::vec3(0.5f, 0.0f, 0.0f), 0.2f, 0.5f);
+    }
+
+    float x = 0.0f;
+    while (state.KeepRunning()){
+        x += 0.01f;
+        chain[0].SetLocal(glm::vec3(x, 0.0f, 0.0f), 0.0f, 1.0f);
+        for (int i = 0; i < links; i++){
+            DoNotOptimize(chain[i].GetWorldMatrix());
+        }
+    }
+}
+
+
+void BM_KrakenIk(BenchState &state)
+{
+    // the whole kraken, eight arms chasing targets that move every tick
+    game::IkSolver solver;
+    for (int a = 0; a < 8; a++){
+        float angle = 6.2831853f * a / 8;
+        solver.AddChain(glm::vec2(0.0f), glm::vec2(cos(angle), sin(angle)), 6, 0.3f);
+        solver.SetBudget(a, a < 2 ? 8 : 2);
+    }
+
+    float t = 0.0f;
+    int passes = 0;
+    while (state.KeepRunning()){
+        t += 0.016f;
+        for (int a = 0; a < 8; a++){
+            float angle = 6.2831853f * a / 8 + 0.5f * sin(2.0f * t + a);
+            solver.SetTarget(a, glm::vec2(cos(angle), sin(angle)) * 1.3f);
+        }
+        passes += solver.Solve();
+    }
+    DoNotOptimize(passes);
+}
+
+
+void BM_KrakenBvhRaycast(BenchState &state)
+{
+    // bullet steps fired through a head and eight arms of six links, refit every 64 steps like a tick would
+    game::CapsuleBvh bvh;
+    bvh.AddCapsule(glm::vec2(0.0f), glm::vec2(0.0f), 0.4f);
+    for (int a = 0; a < 8; a++){
+        glm::vec2 out(cos(0.785f * a), sin(0.785f * a));
+        for (int j = 0; j < 6; j++){
+            bvh.AddCapsule(out * (0.35f + 0.3f * j), out * (0.35f + 0.3f * (j + 1)), 0.08f);
+        }
+    }
+    bvh.Build();
+
+    const int count = 1024;
+    game::Random random(11);
+    std::vector<glm::vec2> starts, steps;
+    for (int i = 0; i < count; i++){
+        starts.push_back(glm::vec2(random.Range(-2.5f, 2.5f), random.Range(-2.5f, 2.5f)));
+        steps.push_back(glm::vec2(random.Range(-0.2f, 0.2f), random.Range(-0.2f, 0.2f)));
+    }
+
+    int i = 0;
+    int hits = 0;
+    while (state.KeepRunning()){
+        if ((i & 63) == 0) bvh.Refit();
+        hits += bvh.Raycast(starts[i], steps[i]) >= 0;
+        i = (i + 1) & (count - 1);
+    }
+    DoNotOptimize(hits);
+}
+
+
+// Mix a block with some number of looping voices, the difference between the two runs is the cost of a voice
+void MixVoices(BenchState &state, int count)
+{
+    // a second of noise at half the output rate so every voice gets resampled, spread out around the listener
+    std::vector<int16_t> samples(22050);
+    game::Random random(13);
+    for (int i = 0; i < samples.size(); i++){
+        samples[i] = static_cast<int16_t>(random.NextInt(65536) - 32768);
+    }
+
+    audio_manager::SoftwareMixer mixer;
+    unsigned int buffer = mixer.CreateBuffer();
+    mixer.SetBufferData(buffer, &samples[0], samples.size(), 1, 22050);
+    for (int i = 0; i < count; i++){
+        unsigned int source = mixer.CreateSource();
+        mixer.SetSourceBuffer(source, buffer);
+        mixer.SetSourceLooping(source, true);
+        mixer.SetSourcePosition(source, random.Range(-10.0f, 10.0f), random.Range(-10.0f, 10.0f), 0.0f);
+        mixer.SetSourceOffset(source, random.Range(0.0f, 1.0f));
+        mixer.PlaySource(source);
+    }
+
+    std::vector<int16_t> out(MIXER_BLOCK_FRAMES * 2);
+    while (state.KeepRunning()){
+        mixer.Render(&out[0], MIXER_BLOCK_FRAMES);
+    }
+    DoNotOptimize(out[0]);
+}
+
+
+void BM_MixerOneVoice(BenchState &state)
+{
+    MixVoices(state, 1);
+}
+
+
+void BM_MixerSixteenVoices(BenchState &state)
+{
+    MixVoices(state, 16);
+}
+
+
+void BM_BulletCircleTest(BenchState &state)
+{
+    // a spread of bullets and enemies so the branch goes both ways
+    const int count = 1024;
+    game::Random random(7);
+    std::vector<glm::vec3> starts, steps, centres;
+    for (int i = 0; i < count; i++){
+        starts.push_back(glm::vec3(random.Range(-1.0f, 1.0f), random.Range(-1.0f, 1.0f), 0.0f));
+        steps.push_back(glm::vec3(random.Range(-0.03f, 0.03f), random.Range(-0.03f, 0.03f), 0.0f));
+        centres.push_back(glm::vec3(random.Range(-1.0f, 1.0f), random.Range(-1.0f, 1.0f), 0.0f));
+    }
+
+    int i = 0;
+    int hits = 0;
+    while (state.KeepRunning()){
+        hits += game::SegmentInsideCircle(starts[i], steps[i], centres[i], 0.1f);
+        i = (i + 1) & (count - 1);
+    }
+    DoNotOptimize(hits);
+}
+
+
+void BM_PlayerSetVelocity(BenchState &state)
+{
+    game::PlayerGameObject player(glm::vec3(0.0f), NULL, NULL, 0);
+    glm::vec3 push(0.001f, 0.0005f, 0.0f);
+    while (state.KeepRunning()){
+        player.SetVelocity(push);
+        push.y = -push.y;
+        glm::vec3 velocity = player.GetVelocity();
+        DoNotOptimize(velocity);
+    }
+}
+
+
+void BM_EnemyPatrolUpdate(BenchState &state)
+{
+    // one enemy update per iteration, spread over a small fleet
+    const int count = 64;
+    std::vector<game::EnemyGameObject*> enemies;
+    for (int i = 0; i < count; i++){
+        enemies.push_back(new game::EnemyGameObject(glm::vec3(i * 0.5f - 16.0f, (i % 8) - 4.0f, 0.0f), NULL, NULL, 0));
+    }
+
+    int i = 0;
+    while (state.KeepRunning()){
+        enemies[i]->Update(1.0 / 60.0);
+        i = (i + 1) & (count - 1);
+    }
+    DoNotOptimize(enemies[0]->GetPosition());
+
+    for (int i = 0; i < count; i++){
+        delete enemies[i];
+    }
+}
+
+
+void BM_ParticleFillBuffers(BenchState &state)
+{
+    game::Random random(3);
+    game::Particles particles(glm::vec3(0.8f, 0.4f, 0.01f), 3.14f, 0.4f, 15.0f);
+    particles.SetRandom(&random);
+
+    std::vector<GLfloat> vertices(NUM_PARTICLES * PARTICLE_VERTEX_ATTR);
+    std::vector<GLuint> faces(NUM_PARTICLES * 6);
+    while (state.KeepRunning()){
+        particles.FillBuffers(&vertices[0], &faces[0]);
+        DoNotOptimize(vertices[0]);
+    }
+}
+
+
+void BM_LoadTextFile(BenchState &state)
+{
+    std::string filename = std::string(RESOURCES_DIRECTORY) + std::string("/sprite_vertex_shader.glsl");
+    while (state.KeepRunning()){
+        std::string content = game::LoadTextFile(filename.c_str());
+        DoNotOptimize(content.size());
+    }
+}
+
+
+void BM_HudDigits(BenchState &state)
+{
+    int digits[3];
+    int score = 0;
+    while (state.KeepRunning()){
+        game::SplitDigits(score, digits, 3);
+        score = (score + 7) % 1000;
+        DoNotOptimize(digits[0] + digits[1] + digits[2]);
+    }
+}
+
+
+const BenchEntry benchmarks_g[] = {
+    { "BM_TransformMatrix", BM_TransformMatrix },
+    { "BM_TransformMatrixStatic", BM_TransformMatrixStatic },
+    { "BM_TransformChain", BM_TransformChain },
+    { "BM_KrakenIk", BM_KrakenIk },
+    { "BM_KrakenBvhRaycast", BM_KrakenBvhRaycast },
+    { "BM_MixerOneVoice", BM_MixerOneVoice },
+    { "BM_MixerSixteenVoices", BM_MixerSixteenVoices },
+    { "BM_BulletCircleTest", BM_BulletCircleTest },
+    { "BM_PlayerSetVelocity", BM_PlayerSetVelocity },
+    { "BM_EnemyPatrolUpdate", BM_EnemyPatrolUpdate },
+    { "BM_ParticleFillBuffers", BM_ParticleFillBuffers },
+    { "BM_LoadTextFile", BM_LoadTextFile },
+    { "BM_HudDigits", BM_HudDigits },
+};
+
+
+BenchResult RunBenchmark(const BenchEntry &entry, double min_time)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    // keep growing the iteration count until a run takes at least min_time
+    long long iterations = 1;
+    while (true){
+        BenchState state(iterations);
+
+        std::clock_t cpu_start = std::clock();
+        Clock::time_point start = Clock::now();
+        entry.function(state);
+        double real = std::chrono::duration<double>(Clock::now() - start).count();
+        double cpu = static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+
+        if (real >= min_time || iterations >= 1000000000LL){
+            BenchResult result;
+            result.name = entry.name;
+            result.iterations = iterations;
+            result.real_time = real * 1.0e9 / iterations;
+            result.cpu_time = cpu * 1.0e9 / iterations;
+            return result;
+        }
+
+        // aim a little past min_time, but never grow by more than 10x at once
+        double scale = real > 0.0 ? 1.4 * min_time / real : 10.0;
+        if (scale > 10.0) scale = 10.0;
+        if (scale < 2.0) scale = 2.0;
+        iterations = static_cast<long long>(iterations * scale);
+    }
+}
+
+
+// Write the results in the same layout Google Benchmark uses for --benchmark_format=json
+void WriteJson(const std::string &filename, const std::vector<BenchResult> &results)
+{
+    std::ofstream f(filename.c_str());
+    if (f.fail()) {
+        throw(std::ios_base::failure(std::string("Error opening file ") + filename));
+    }
+
+    char date[64];
+    std::time_t now = std::time(NULL);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+    f << "{\n";
+    f << "  \"context\": {\n";
+    f << "    \"date\": \"" << date << "\",\n";
+    f << "    \"executable\": \"MicroBench\",\n";
+#ifdef NDEBUG
+    f << "    \"library_build_type\": \"release\"\n";
+#else
+    f << "    \"library_build_type\": \"debug\"\n";
+#endif
+    f << "  },\n";
+    f << "  \"benchmarks\": [\n";
+    for (int i = 0; i < results.size(); i++){
+        f << "    {\n";
+        f << "      \"name\": \"" << results[i].name << "\",\n";
+        f << "      \"run_type\": \"iteration\",\n";
+        f << "      \"iterations\": " << results[i].iterations << ",\n";
+        f << "      \"real_time\": " << results[i].real_time << ",\n";
+        f << "      \"cpu_time\": " << results[i].cpu_time << ",\n";
+        f << "      \"time_unit\": \"ns\"\n";
+        f << "    }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    f << "  ]\n";
+    f << "}\n";
+}
+
+} // namespace
+
+
+int main(int argc, char *argv[]){
+
+    std::string filter;
+    std::string json_file;
+    double min_time = 0.5;
+
+    try {
+        for (int i = 1; i < argc; i++){
+            std::string arg(argv[i]);
+            if (i + 1 >= argc){
+                throw(std::runtime_error(std::string("Missing value for ") + arg));
+            }
+            if (arg == "--filter") filter = argv[++i];
+            else if (arg == "--json") json_file = argv[++i];
+            else if (arg == "--min_time") min_time = atof(argv[++i]);
+            else throw(std::runtime_error(std::string("Unknown argument ") + arg));
+        }
+
+        // objects with timers need a wheel to belong to
+        game::TimerWheel::SetActive(&timer_wheel_g);
+
+        std::vector<BenchResult> results;
+        printf("%-28s %15s %15s %12s\n", "Benchmark", "Time (ns)", "CPU (ns)", "Iterations");
+        for (int i = 0; i < sizeof(benchmarks_g) / sizeof(BenchEntry); i++){
+            if (!filter.empty() && std::string(benchmarks_g[i].name).find(filter) == std::string::npos) continue;
+
+            BenchResult result = RunBenchmark(benchmarks_g[i], min_time);
+            printf("%-28s %15.2f %15.2f %12lld\n", result.name.c_str(), result.real_time, result.cpu_time, result.iterations);
+            results.push_back(result);
+        }
+
+        if (!json_file.empty()) WriteJson(json_file, results);
+    }
+    catch (std::exception &e){
+        // Catch and print any errors
+        PrintException(e);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,226 @@
+#include <chrono>
+
+#include "music_stream.h"
+#include "audio_manager.h"
+
+namespace audio_manager {
+
+MusicStream::MusicStream(void)
+{
+    backend_ = NULL;
+    source_ = 0;
+    for (int i = 0; i < STREAM_NUM_BUFFERS; i++)
+    {
+        buffers_[i] = 0;
+    }
+
+    write_ = 0;
+    read_ = 0;
+    running_ = false;
+    loop_ = false;
+    finished_ = false;
+    open_ = false;
+    playing_ = false;
+}
+
+
+MusicStream::~MusicStream()
+{
+    Close();
+}
+
+
+void MusicStream::Open(AudioBackend *backend, const char *filename, bool loop)
+{
+    Close();
+
+    // throws if the file is no good, before we have made anything that would need cleaning up
+    decoder_.Open(filename);
+    backend_ = backend;
+
+    ring_.assign(STREAM_RING_FRAMES * decoder_.GetChannels(), 0);
+    scratch_.assign(STREAM_BUFFER_FRAMES * decoder_.GetChannels(), 0);
+    write_ = 0;
+    read_ = 0;
+    loop_ = loop;
+    finished_ = false;
+
+    source_ = backend_->CreateSource();
+    for (int i = 0; i < STREAM_NUM_BUFFERS; i++)
+    {
+        buffers_[i] = backend_->CreateBuffer();
+    }
+    if (backend_->HasError())
+    {
+        decoder_.Close();
+        throw(AudioManagerException(std::string("Failed to generate stream source")));
+    }
+
+    // the queue manages the source, it cant loop by itself
+    backend_->SetSourceLooping(source_, false);
+
+    free_buffers_.clear();
+    for (int i = 0; i < STREAM_NUM_BUFFERS; i++)
+    {
+        free_buffers_.push_back(buffers_[i]);
+    }
+
+    open_ = true;
+    running_ = true;
+    thread_ = std::thread(&MusicStream::Decode, this);
+}
+
+
+void MusicStream::Close(void)
+{
+    if (!open_) return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    wake_.notify_one();
+    if (thread_.joinable()) thread_.join();
+
+    Stop();
+    backend_->DeleteSource(source_);
+    for (int i = 0; i < STREAM_NUM_BUFFERS; i++)
+    {
+        backend_->DeleteBuffer(buffers_[i]);
+    }
+    decoder_.Close();
+
+    open_ = false;
+}
+
+
+void MusicStream::Play(void)
+{
+    if (!open_) return;
+    playing_ = true;
+    Update();
+}
+
+
+void MusicStream::Stop(void)
+{
+    if (!open_) return;
+
+    backend_->StopSource(source_);
+
+    // a stopped source has finished with every buffer
+    int queued = backend_->GetQueuedBuffers(source_);
+    while (queued-- > 0)
+    {
+        free_buffers_.push_back(backend_->UnqueueBuffer(source_));
+    }
+
+    playing_ = false;
+}
+
+
+void MusicStream::Update(void)
+{
+    if (!playing_) return;
+
+    // take back what the backend has played
+    int processed = backend_->GetProcessedBuffers(source_);
+    while (processed-- > 0)
+    {
+        free_buffers_.push_back(backend_->UnqueueBuffer(source_));
+    }
+
+    // and give it back full
+    while (!free_buffers_.empty() && QueueBuffer(free_buffers_.back()))
+    {
+        free_buffers_.pop_back();
+    }
+
+    int queued = backend_->GetQueuedBuffers(source_);
+    int state = backend_->GetSourceState(source_);
+
+    if (queued == 0)
+    {
+        // played to the end of a file that doesnt loop
+        if (finished_ && write_ == read_) playing_ = false;
+        return;
+    }
+
+    // the source stops if it ran dry before we got back to it, or hasnt been started yet
+    if (state != AUDIO_SOURCE_PLAYING) backend_->PlaySource(source_);
+}
+
+
+bool MusicStream::QueueBuffer(unsigned int buffer)
+{
+    long long read = read_.load(std::memory_order_relaxed);
+    long long available = write_.load(std::memory_order_acquire) - read;
+
+    // a short buffer is fine at the end of the file, otherwise wait until a whole one is ready
+    int frames = available < STREAM_BUFFER_FRAMES ? static_cast<int>(available) : STREAM_BUFFER_FRAMES;
+    if (frames == 0 || (frames < STREAM_BUFFER_FRAMES && !finished_)) return false;
+
+    int channels = decoder_.GetChannels();
+    for (int i = 0; i < frames; i++)
+    {
+        int slot = static_cast<int>((read + i) % STREAM_RING_FRAMES) * channels;
+        for (int c = 0; c < channels; c++)
+        {
+            scratch_[i * channels + c] = ring_[slot + c];
+        }
+    }
+    read_.store(read + frames, std::memory_order_release);
+    wake_.notify_one();
+
+    backend_->SetBufferData(buffer, &scratch_[0], frames, channels, decoder_.GetSampleRate());
+    backend_->QueueBuffer(source_, buffer);
+    return true;
+}
+
+
+void MusicStream::Decode(void)
+{
+    int channels = decoder_.GetChannels();
+    std::vector<int16_t> chunk(STREAM_DECODE_FRAMES * channels);
+
+    while (running_)
+    {
+        long long write = write_.load(std::memory_order_relaxed);
+        long long space = STREAM_RING_FRAMES - (write - read_.load(std::memory_order_acquire));
+
+        // the ring is full, sleep until Update takes some out (or every so often, in case it never does)
+        if (space < STREAM_DECODE_FRAMES)
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait_for(lock, std::chrono::milliseconds(20));
+            continue;
+        }
+
+        int got = decoder_.Read(&chunk[0], STREAM_DECODE_FRAMES);
+        for (int i = 0; i < got; i++)
+        {
+            int slot = static_cast<int>((write + i) % STREAM_RING_FRAMES) * channels;
+            for (int c = 0; c < channels; c++)
+            {
+                ring_[slot + c] = chunk[i * channels + c];
+            }
+        }
+        write_.store(write + got, std::memory_order_release);
+
+        if (got < STREAM_DECODE_FRAMES)
+        {
+            // a file with nothing in it would spin forever if we looped it
+            if (loop_ && decoder_.GetFrames() > 0)
+            {
+                decoder_.Rewind();
+            }
+            else
+            {
+                finished_ = true;
+                break;
+            }
+        }
+    }
+}
+
+} // namespace audio_manager
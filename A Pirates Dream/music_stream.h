@@ -0,0 +1,99 @@
+#ifndef MUSIC_STREAM_H_
+#define MUSIC_STREAM_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "audio_backend.h"
+#include "wav_decoder.h"
+
+// how much decoded audio waits between the decoding thread and the backend, in frames
+#define STREAM_RING_FRAMES 32768
+
+// how much the decoding thread reads at once
+#define STREAM_DECODE_FRAMES 4096
+
+// the buffers kept queued on the source and how many frames go in each
+#define STREAM_NUM_BUFFERS 4
+#define STREAM_BUFFER_FRAMES 4096
+
+namespace audio_manager {
+
+    /*
+        A long piece of audio (the music) that is played while it is being read instead of loaded up front
+        A thread decodes the file a chunk at a time into a ring of samples, and Update() moves what it has
+        decoded into whichever of the sources queued buffers the backend has finished playing
+        However long the track is it only ever holds the ring and the few queued buffers, a few hundred KB
+        The ring only has one writer (the thread) and one reader (Update) so the two just chase each other
+        round it, nothing is locked while samples move
+    */
+    class MusicStream {
+
+        public:
+            // Constructor and destructor
+            MusicStream(void);
+            ~MusicStream();
+
+            // Open a file and start decoding it, throws an AudioManagerException if it cant be played
+            // The source and buffers are made on backend, which has to outlive the stream
+            void Open(AudioBackend *backend, const char *filename, bool loop = false);
+
+            // Stop decoding and free the source and buffers
+            void Close(void);
+
+            // Start over at the end of the file instead of stopping
+            inline void SetLoop(bool loop) { loop_ = loop; }
+
+            // Start or stop playing, a stream that has to wait for the thread starts as soon as there is audio
+            void Play(void);
+            void Stop(void);
+
+            // Hand the backend more audio, call this every frame while the stream plays
+            void Update(void);
+
+            // Getters
+            inline unsigned int GetSource(void) const { return source_; }
+            inline bool IsPlaying(void) const { return playing_; }
+
+        private:
+            WavDecoder decoder_;
+
+            // the source the buffers queue up on, the buffers, and the ones not queued right now
+            AudioBackend *backend_;
+            unsigned int source_;
+            unsigned int buffers_[STREAM_NUM_BUFFERS];
+            std::vector<unsigned int> free_buffers_;
+
+            // the decoded samples, write_ and read_ count frames ever written and read
+            std::vector<int16_t> ring_;
+            std::atomic<long long> write_;
+            std::atomic<long long> read_;
+
+            // one buffers worth of samples on their way to the backend
+            std::vector<int16_t> scratch_;
+
+            // the decoding thread and what it and Update tell each other
+            std::thread thread_;
+            std::mutex mutex_;
+            std::condition_variable wake_;
+            std::atomic<bool> running_;
+            std::atomic<bool> loop_;
+            std::atomic<bool> finished_;
+
+            bool open_;
+            bool playing_;
+
+            // What the decoding thread runs
+            void Decode(void);
+
+            // Fill a buffer from the ring and queue it, false if there wasnt anything to put in it
+            bool QueueBuffer(unsigned int buffer);
+
+    }; // class MusicStream
+
+} // namespace audio_manager
+
+#endif // MUSIC_STREAM_H_
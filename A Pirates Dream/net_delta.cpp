@@ -0,0 +1,337 @@
+#include <algorithm>
+#include <cmath>
+#define GLM_FORCE_RADIANS
+#include <glm/gtc/constants.hpp>
+
+#include "net_delta.h"
+
+namespace game {
+
+// which fields of an entity follow its id in a delta
+static const uint8_t field_look_g = 1 << 0;
+static const uint8_t field_x_g = 1 << 1;
+static const uint8_t field_y_g = 1 << 2;
+static const uint8_t field_angle_g = 1 << 3;
+static const uint8_t field_scale_g = 1 << 4;
+
+
+static int VarintSize(uint32_t value)
+{
+    int size = 1;
+    while (value >= 0x80)
+    {
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
+
+
+static int SignedSize(int32_t value)
+{
+    return VarintSize((static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31));
+}
+
+
+// the way round the circle that is shortest, so turning past 0 is a small step
+static int32_t AngleStep(uint16_t from, uint16_t to)
+{
+    return static_cast<int16_t>(static_cast<uint16_t>(to - from));
+}
+
+
+// The fields that changed since base (everything that isnt zero if there was no base)
+static uint8_t Changes(const NetEntity *base, const NetEntity &entity)
+{
+    static const NetEntity zero;
+    if (!base) base = &zero;
+
+    uint8_t mask = 0;
+    if (base == &zero || entity.kind != base->kind || entity.texture != base->texture) mask |= field_look_g;
+    if (entity.x != base->x) mask |= field_x_g;
+    if (entity.y != base->y) mask |= field_y_g;
+    if (entity.angle != base->angle) mask |= field_angle_g;
+    if (entity.scale != base->scale) mask |= field_scale_g;
+    return mask;
+}
+
+
+// How many bytes the mask and fields of an entity take, not counting its id
+static int FieldsSize(const NetEntity *base, const NetEntity &entity, uint8_t mask)
+{
+    static const NetEntity zero;
+    if (!base) base = &zero;
+
+    int size = 1;
+    if (mask & field_look_g) size += 2;
+    if (mask & field_x_g) size += SignedSize(entity.x - base->x);
+    if (mask & field_y_g) size += SignedSize(entity.y - base->y);
+    if (mask & field_angle_g) size += SignedSize(AngleStep(base->angle, entity.angle));
+    if (mask & field_scale_g) size += VarintSize(entity.scale);
+    return size;
+}
+
+
+NetEntity::NetEntity(uint32_t id, int kind, int texture, const glm::vec3 &position, float angle, float scale)
+    : id(id), kind(static_cast<uint8_t>(kind)), texture(static_cast<uint8_t>(texture))
+{
+    float turn = angle / (2.0f * glm::pi<float>());
+    this->angle = static_cast<uint16_t>(static_cast<int32_t>(std::lround(turn * 65536.0f)) & 0xffff);
+    this->scale = static_cast<uint16_t>(std::min(std::lround(std::max(scale, 0.0f) * NET_SCALE_STEPS), 65535L));
+    x = static_cast<int32_t>(std::lround(position.x * NET_POSITION_STEPS));
+    y = static_cast<int32_t>(std::lround(position.y * NET_POSITION_STEPS));
+}
+
+
+const NetEntity *NetWorld::Find(uint32_t id) const
+{
+    std::vector<NetEntity>::const_iterator it = std::lower_bound(entities.begin(), entities.end(), id,
+        [](const NetEntity &entity, uint32_t id) { return entity.id < id; });
+    if (it == entities.end() || it->id != id) return NULL;
+    return &*it;
+}
+
+
+void NetWorld::Clear(void)
+{
+    tick = 0;
+    health = 0;
+    score = 0;
+    flags = 0;
+    entities.clear();
+}
+
+
+bool NetWorld::operator==(const NetWorld &other) const
+{
+    return tick == other.tick && health == other.health && score == other.score && flags == other.flags && entities == other.entities;
+}
+
+
+void WriteDelta(Snapshot &packet, const NetWorld &base, const NetWorld &world, const std::vector<int> &priority,
+                size_t budget, NetWorld &sent, DeltaCounts &counts)
+{
+    size_t start = packet.GetSize();
+
+    packet.WriteVarint(static_cast<uint32_t>(world.tick));
+    packet.WriteSigned(world.health);
+    packet.WriteSigned(world.score);
+    packet.Write(world.flags);
+
+    // what it would have been with nothing to go on, the same header and every entity in full
+    counts.full_bytes = packet.GetSize() - start + 2;
+    uint32_t previous = 0;
+    for (int i = 0; i < world.entities.size(); i++)
+    {
+        const NetEntity &entity = world.entities[i];
+        counts.full_bytes += VarintSize(entity.id - previous) + FieldsSize(NULL, entity, Changes(NULL, entity));
+        previous = entity.id;
+    }
+
+    // the ids the client has that it shouldnt any more, both lists are sorted so one pass finds them
+    std::vector<uint32_t> removed;
+    for (int i = 0, j = 0; i < base.entities.size(); i++)
+    {
+        while (j < world.entities.size() && world.entities[j].id < base.entities[i].id) j++;
+        if (j == world.entities.size() || world.entities[j].id != base.entities[i].id) removed.push_back(base.entities[i].id);
+    }
+
+    // room for the two counts, then the removals and the entities as long as they fit, by their biggest size
+    // (their id in full) since the real one depends on which other ids make it in
+    size_t used = packet.GetSize() - start + 10;
+    int num_removed = 0;
+    while (num_removed < removed.size() && used + VarintSize(removed[num_removed]) <= budget)
+    {
+        used += VarintSize(removed[num_removed]);
+        num_removed++;
+    }
+
+    std::vector<char> chosen(world.entities.size(), 0);
+    std::vector<int> written;
+    for (int i = 0; i < priority.size(); i++)
+    {
+        const NetEntity &entity = world.entities[priority[i]];
+        const NetEntity *before = base.Find(entity.id);
+        if (before && *before == entity)
+        {
+            counts.unchanged++;
+            continue;
+        }
+
+        size_t size = VarintSize(entity.id) + FieldsSize(before, entity, Changes(before, entity));
+        if (used + size > budget)
+        {
+            counts.held_back++;
+            continue;
+        }
+        used += size;
+        chosen[priority[i]] = 1;
+        written.push_back(priority[i]);
+    }
+    counts.held_back += static_cast<int>(removed.size()) - num_removed;
+    counts.removed = num_removed;
+    counts.written = static_cast<int>(written.size());
+
+    // in order of id they take less room, each is only as far from the last as it needs
+    std::sort(written.begin(), written.end());
+
+    packet.WriteVarint(static_cast<uint32_t>(num_removed));
+    previous = 0;
+    for (int i = 0; i < num_removed; i++)
+    {
+        packet.WriteVarint(removed[i] - previous);
+        previous = removed[i];
+    }
+
+    packet.WriteVarint(static_cast<uint32_t>(written.size()));
+    previous = 0;
+    for (int i = 0; i < written.size(); i++)
+    {
+        const NetEntity &entity = world.entities[written[i]];
+        const NetEntity *before = base.Find(entity.id);
+        static const NetEntity zero;
+        const NetEntity &from = before ? *before : zero;
+        uint8_t mask = Changes(before, entity);
+
+        packet.WriteVarint(entity.id - previous);
+        previous = entity.id;
+        packet.Write(mask);
+        if (mask & field_look_g)
+        {
+            packet.Write(entity.kind);
+            packet.Write(entity.texture);
+        }
+        if (mask & field_x_g) packet.WriteSigned(entity.x - from.x);
+        if (mask & field_y_g) packet.WriteSigned(entity.y - from.y);
+        if (mask & field_angle_g) packet.WriteSigned(AngleStep(from.angle, entity.angle));
+        if (mask & field_scale_g) packet.WriteVarint(entity.scale);
+    }
+
+    // what the client ends up with: the new copy of what went out, the old copy of what had to wait
+    sent.Clear();
+    sent.tick = world.tick;
+    sent.health = world.health;
+    sent.score = world.score;
+    sent.flags = world.flags;
+    int i = 0, j = 0, k = 0;
+    while (i < base.entities.size() || j < world.entities.size())
+    {
+        uint32_t id_base = i < base.entities.size() ? base.entities[i].id : UINT32_MAX;
+        uint32_t id_world = j < world.entities.size() ? world.entities[j].id : UINT32_MAX;
+
+        if (id_base < id_world)
+        {
+            // gone, unless there wasnt room to say so
+            if (k < num_removed && removed[k] == id_base) k++;
+            else sent.entities.push_back(base.entities[i]);
+            i++;
+        }
+        else if (id_world < id_base)
+        {
+            if (chosen[j]) sent.entities.push_back(world.entities[j]);
+            j++;
+        }
+        else
+        {
+            sent.entities.push_back(chosen[j] ? world.entities[j] : base.entities[i]);
+            i++;
+            j++;
+        }
+    }
+}
+
+
+void ReadDelta(Snapshot &packet, const NetWorld &base, NetWorld &world)
+{
+    uint32_t tick;
+    int32_t health, score;
+    uint8_t flags;
+    packet.ReadVarint(tick);
+    packet.ReadSigned(health);
+    packet.ReadSigned(score);
+    packet.Read(flags);
+
+    uint32_t count;
+    uint32_t id = 0;
+    std::vector<uint32_t> removed;
+    packet.ReadVarint(count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t step;
+        packet.ReadVarint(step);
+        id += step;
+        removed.push_back(id);
+    }
+
+    std::vector<NetEntity> changed;
+    id = 0;
+    packet.ReadVarint(count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t step;
+        uint8_t mask;
+        packet.ReadVarint(step);
+        packet.Read(mask);
+        id += step;
+
+        const NetEntity *before = base.Find(id);
+        NetEntity entity = before ? *before : NetEntity();
+        entity.id = id;
+
+        int32_t value;
+        if (mask & field_look_g)
+        {
+            packet.Read(entity.kind);
+            packet.Read(entity.texture);
+        }
+        if (mask & field_x_g)
+        {
+            packet.ReadSigned(value);
+            entity.x += value;
+        }
+        if (mask & field_y_g)
+        {
+            packet.ReadSigned(value);
+            entity.y += value;
+        }
+        if (mask & field_angle_g)
+        {
+            packet.ReadSigned(value);
+            entity.angle = static_cast<uint16_t>(entity.angle + value);
+        }
+        if (mask & field_scale_g)
+        {
+            uint32_t scale;
+            packet.ReadVarint(scale);
+            entity.scale = static_cast<uint16_t>(scale);
+        }
+        changed.push_back(entity);
+    }
+
+    // the base without what was removed, with what changed put over it, all three are in order of id
+    world.Clear();
+    world.tick = static_cast<int>(tick);
+    world.health = health;
+    world.score = score;
+    world.flags = flags;
+    int i = 0, j = 0, k = 0;
+    while (i < base.entities.size() || j < changed.size())
+    {
+        uint32_t id_base = i < base.entities.size() ? base.entities[i].id : UINT32_MAX;
+        uint32_t id_changed = j < changed.size() ? changed[j].id : UINT32_MAX;
+
+        if (id_changed <= id_base)
+        {
+            world.entities.push_back(changed[j]);
+            if (id_changed == id_base) i++;
+            j++;
+            continue;
+        }
+
+        while (k < removed.size() && removed[k] < id_base) k++;
+        if (k == removed.size() || removed[k] != id_base) world.entities.push_back(base.entities[i]);
+        i++;
+    }
+}
+
+} // namespace game
@@ -0,0 +1,110 @@
+#ifndef NET_DELTA_H_
+#define NET_DELTA_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "snapshot.h"
+
+// which list of the simulation an entity came from, so a client knows what it is looking at
+#define NET_KIND_PLAYER 0
+#define NET_KIND_ENEMY 1
+#define NET_KIND_COLLECTIBLE 2
+#define NET_KIND_BULLET 3
+#define NET_KIND_SPIKE 4
+#define NET_KIND_EXPLOSION 5
+#define NET_KIND_EMITTER 6
+#define NET_KIND_TENTACLE 7
+
+// positions go out in 1/256ths of a unit, angles in 1/65536ths of a turn and scales in 1/64ths
+#define NET_POSITION_STEPS 256.0f
+#define NET_SCALE_STEPS 64.0f
+
+// the flags of a NetWorld
+#define NET_WORLD_OVER (1 << 0)
+#define NET_WORLD_WON (1 << 1)
+
+namespace game {
+
+    // One thing in the world as the network sees it, rounded to what is sent so the two ends agree exactly
+    struct NetEntity {
+        uint32_t id;
+        uint8_t kind;
+
+        // the simulations texture number for it (see GameServer), 0 for none
+        uint8_t texture;
+
+        uint16_t angle;
+        uint16_t scale;
+        int32_t x;
+        int32_t y;
+
+        NetEntity(void) : id(0), kind(0), texture(0), angle(0), scale(0), x(0), y(0) {}
+
+        // Round an objects position, rotation and scale to what is sent
+        NetEntity(uint32_t id, int kind, int texture, const glm::vec3 &position, float angle, float scale);
+
+        inline glm::vec3 GetPosition(void) const { return glm::vec3(x / NET_POSITION_STEPS, y / NET_POSITION_STEPS, 0.0f); }
+
+        inline bool operator==(const NetEntity &other) const
+        {
+            return id == other.id && kind == other.kind && texture == other.texture && angle == other.angle &&
+                   scale == other.scale && x == other.x && y == other.y;
+        }
+        inline bool operator!=(const NetEntity &other) const { return !(*this == other); }
+    };
+
+    // Everything one client knows about the world at a tick, the entities sorted by id
+    struct NetWorld {
+        int tick;
+        int health;
+        int score;
+        uint8_t flags;
+        std::vector<NetEntity> entities;
+
+        NetWorld(void) : tick(0), health(0), score(0), flags(0) {}
+
+        // The entity with an id, NULL if it isnt there
+        const NetEntity *Find(uint32_t id) const;
+
+        // Forget everything, the memory is kept
+        void Clear(void);
+
+        bool operator==(const NetWorld &other) const;
+        inline bool operator!=(const NetWorld &other) const { return !(*this == other); }
+    };
+
+    // How a delta went, for the statistics
+    struct DeltaCounts {
+        // entities that went out, were the same as last time, had to wait for the next packet, and were taken away
+        int written;
+        int unchanged;
+        int held_back;
+        int removed;
+
+        // what the same world would have taken with no delta at all
+        size_t full_bytes;
+
+        DeltaCounts(void) : written(0), unchanged(0), held_back(0), removed(0), full_bytes(0) {}
+    };
+
+    /*
+        Write the difference between what a client already has (base, empty for a full update) and what it
+        should see now (world) into a packet, the ids that are gone and for every entity that changed only
+        the fields that did, as differences from before packed into as few bytes as they need
+        At most budget bytes are used, the entities go in the order of priority (indices into world.entities,
+        most important first) and whatever doesnt fit waits, the client keeps its old copy of those until the
+        next packet. Sent gets exactly what the client will have once it reads the packet, to be the base
+        of a later delta
+    */
+    void WriteDelta(Snapshot &packet, const NetWorld &base, const NetWorld &world, const std::vector<int> &priority,
+                    size_t budget, NetWorld &sent, DeltaCounts &counts);
+
+    // Read a delta back on top of the same base it was written against, throws if the packet is cut short
+    void ReadDelta(Snapshot &packet, const NetWorld &base, NetWorld &world);
+
+} // namespace game
+
+#endif // NET_DELTA_H_
@@ -0,0 +1,69 @@
+#include "net_link.h"
+
+namespace game {
+
+NetLink::NetLink(void)
+{
+}
+
+
+void NetLink::Open(int port, uint64_t seed, const NetConditions &conditions)
+{
+    conditions_ = conditions;
+    random_.Seed(seed);
+    delayed_.clear();
+    socket_.Open(port);
+}
+
+
+void NetLink::Close(void)
+{
+    socket_.Close();
+    delayed_.clear();
+}
+
+
+bool NetLink::Send(const NetAddress &to, const void *data, int size, double now)
+{
+    if (conditions_.loss > 0.0 && random_.NextFloat() < conditions_.loss)
+    {
+        return false;
+    }
+
+    if (conditions_.latency <= 0.0 && conditions_.jitter <= 0.0)
+    {
+        socket_.Send(to, data, size);
+        return true;
+    }
+
+    // held back until its time comes, with jitter they can overtake each other like on a real network
+    const uint8_t *bytes = static_cast<const uint8_t*>(data);
+    Delayed delayed;
+    delayed.time = now + conditions_.latency + conditions_.jitter * (2.0 * random_.NextFloat() - 1.0);
+    delayed.to = to;
+    delayed.data.assign(bytes, bytes + size);
+    delayed_.push_back(delayed);
+    return true;
+}
+
+
+void NetLink::Flush(double now)
+{
+    for (int i = 0; i < delayed_.size(); i++)
+    {
+        if (delayed_[i].time > now) continue;
+
+        socket_.Send(delayed_[i].to, &delayed_[i].data[0], static_cast<int>(delayed_[i].data.size()));
+        delayed_.erase(delayed_.begin() + i);
+        i--;
+    }
+}
+
+
+int NetLink::Receive(NetAddress &from, void *data, int size, double now)
+{
+    Flush(now);
+    return socket_.Receive(from, data, size);
+}
+
+} // namespace game
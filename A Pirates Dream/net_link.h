@@ -0,0 +1,72 @@
+#ifndef NET_LINK_H_
+#define NET_LINK_H_
+
+#include <stdint.h>
+#include <vector>
+
+#include "random.h"
+#include "udp_socket.h"
+
+namespace game {
+
+    // Bad weather for testing on one machine, applied to every packet we send
+    struct NetConditions {
+        // seconds a packet takes on top of the real network, give or take up to jitter
+        double latency;
+        double jitter;
+
+        // the chance a packet never arrives, 0 to 1
+        double loss;
+
+        NetConditions(void) : latency(0.0), jitter(0.0), loss(0.0) {}
+    };
+
+    /*
+        NetLink is a UDP socket with a pretend bad network in front of what it sends, so co-op and the server
+        can be tried out with latency, jitter and loss on one machine
+        Packets that are held back sit in a queue until their time comes, times are in seconds on the callers
+        clock and only move when it says so, which keeps a run on a scripted clock the same every time
+        The pretend network draws from its own random stream so it never disturbs the games
+    */
+    class NetLink {
+
+        public:
+            // Constructor
+            NetLink(void);
+
+            // Bind to a port (0 lets the system pick one), throws if it cant
+            void Open(int port, uint64_t seed, const NetConditions &conditions = NetConditions());
+            void Close(void);
+
+            // Send a packet through the bad weather, false if it was dropped on purpose
+            bool Send(const NetAddress &to, const void *data, int size, double now);
+
+            // Send on the held back packets whose time has come
+            void Flush(double now);
+
+            // Flush, then take the next waiting packet, returns its size or -1 if there isnt one
+            int Receive(NetAddress &from, void *data, int size, double now);
+
+            // Getters
+            inline bool IsOpen(void) const { return socket_.IsOpen(); }
+            inline int GetPort(void) const { return socket_.GetPort(); }
+            inline const NetConditions &GetConditions(void) const { return conditions_; }
+
+        private:
+            // a packet waiting out its pretend latency
+            struct Delayed {
+                double time;
+                NetAddress to;
+                std::vector<uint8_t> data;
+            };
+
+            UdpSocket socket_;
+            NetConditions conditions_;
+            Random random_;
+            std::vector<Delayed> delayed_;
+
+    }; // class NetLink
+
+} // namespace game
+
+#endif // NET_LINK_H_
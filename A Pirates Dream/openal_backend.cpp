@@ -0,0 +1,228 @@
+#include <iostream>
+
+#include "openal_backend.h"
+#include "audio_manager.h"
+
+/* Based on the example in http://ffainelli.github.io/openal-example/ */
+
+namespace audio_manager {
+
+OpenAlBackend::OpenAlBackend(void)
+{
+    context_ = NULL;
+}
+
+
+OpenAlBackend::~OpenAlBackend()
+{
+    Close();
+}
+
+
+void OpenAlBackend::Open(const char *device_name)
+{
+    if (context_) return;
+
+    ALCdevice *device = NULL;
+
+    // Initialize audio device, if no device name specified use default device
+    if (device_name)
+    {
+        device = alcOpenDevice(device_name);
+    }
+    else
+    {
+        const char *name = alcGetString(NULL, ALC_DEFAULT_DEVICE_SPECIFIER);
+        device = alcOpenDevice(name);
+    }
+
+    if (!device)
+    {
+        throw(AudioManagerException(std::string("Unable to open device")));
+    }
+
+    // Create audio context
+    context_ = alcCreateContext(device, NULL);
+    if (!alcMakeContextCurrent(context_))
+    {
+        throw(AudioManagerException(std::string("Failed to create default context")));
+    }
+    if (HasError())
+    {
+        throw(AudioManagerException(std::string("Failed to create default context")));
+    }
+}
+
+
+void OpenAlBackend::Close(void)
+{
+    if (!context_) return;
+
+    ALCdevice *device = alcGetContextsDevice(context_);
+    alcMakeContextCurrent(NULL);
+    alcDestroyContext(context_);
+    alcCloseDevice(device);
+    context_ = NULL;
+}
+
+
+void OpenAlBackend::ListDevices(void)
+{
+    std::cout << "Audio devices:" << std::endl;
+    const ALCchar *devices = alcGetString(NULL, ALC_DEVICE_SPECIFIER);
+    while (((*devices) != 0) && ((*(devices+1)) != 0))
+    {
+        std::cout << (*devices);
+        devices++;
+    }
+}
+
+
+unsigned int OpenAlBackend::CreateBuffer(void)
+{
+    ALuint buffer = 0;
+    alGenBuffers(1, &buffer);
+    return buffer;
+}
+
+
+void OpenAlBackend::DeleteBuffer(unsigned int buffer)
+{
+    ALuint b = buffer;
+    alDeleteBuffers(1, &b);
+}
+
+
+void OpenAlBackend::SetBufferData(unsigned int buffer, const int16_t *samples, int frames, int channels, int sample_rate)
+{
+    ALenum format = channels == 2 ? AL_FORMAT_STEREO16 : AL_FORMAT_MONO16;
+    alBufferData(buffer, format, samples, frames * channels * sizeof(int16_t), sample_rate);
+}
+
+
+unsigned int OpenAlBackend::CreateSource(void)
+{
+    ALuint source = 0;
+    alGenSources(1, &source);
+    return source;
+}
+
+
+void OpenAlBackend::DeleteSource(unsigned int source)
+{
+    ALuint s = source;
+    alDeleteSources(1, &s);
+}
+
+
+void OpenAlBackend::SetSourceBuffer(unsigned int source, unsigned int buffer)
+{
+    alSourcei(source, AL_BUFFER, buffer);
+}
+
+
+void OpenAlBackend::SetSourceLooping(unsigned int source, bool loop)
+{
+    alSourcei(source, AL_LOOPING, loop ? AL_TRUE : AL_FALSE);
+}
+
+
+void OpenAlBackend::SetSourceGain(unsigned int source, float gain)
+{
+    alSourcef(source, AL_GAIN, gain);
+}
+
+
+void OpenAlBackend::SetSourcePosition(unsigned int source, float x, float y, float z)
+{
+    alSource3f(source, AL_POSITION, x, y, z);
+}
+
+
+void OpenAlBackend::SetSourceRelative(unsigned int source, bool relative)
+{
+    alSourcei(source, AL_SOURCE_RELATIVE, relative ? AL_TRUE : AL_FALSE);
+}
+
+
+void OpenAlBackend::SetSourceDistance(unsigned int source, float reference, float max, float rolloff)
+{
+    alSourcef(source, AL_REFERENCE_DISTANCE, reference);
+    alSourcef(source, AL_MAX_DISTANCE, max);
+    alSourcef(source, AL_ROLLOFF_FACTOR, rolloff);
+}
+
+
+void OpenAlBackend::SetSourceOffset(unsigned int source, float seconds)
+{
+    alSourcef(source, AL_SEC_OFFSET, seconds);
+}
+
+
+void OpenAlBackend::PlaySource(unsigned int source)
+{
+    alSourcePlay(source);
+}
+
+
+void OpenAlBackend::StopSource(unsigned int source)
+{
+    alSourceStop(source);
+}
+
+
+int OpenAlBackend::GetSourceState(unsigned int source)
+{
+    ALint state = AL_INITIAL;
+    alGetSourcei(source, AL_SOURCE_STATE, &state);
+    if (state == AL_PLAYING || state == AL_PAUSED) return AUDIO_SOURCE_PLAYING;
+    if (state == AL_STOPPED) return AUDIO_SOURCE_STOPPED;
+    return AUDIO_SOURCE_INITIAL;
+}
+
+
+void OpenAlBackend::QueueBuffer(unsigned int source, unsigned int buffer)
+{
+    ALuint b = buffer;
+    alSourceQueueBuffers(source, 1, &b);
+}
+
+
+unsigned int OpenAlBackend::UnqueueBuffer(unsigned int source)
+{
+    if (GetProcessedBuffers(source) == 0) return 0;
+
+    ALuint buffer = 0;
+    alSourceUnqueueBuffers(source, 1, &buffer);
+    return buffer;
+}
+
+
+int OpenAlBackend::GetQueuedBuffers(unsigned int source)
+{
+    ALint queued = 0;
+    alGetSourcei(source, AL_BUFFERS_QUEUED, &queued);
+    return queued;
+}
+
+
+int OpenAlBackend::GetProcessedBuffers(unsigned int source)
+{
+    ALint processed = 0;
+    alGetSourcei(source, AL_BUFFERS_PROCESSED, &processed);
+    return processed;
+}
+
+
+void OpenAlBackend::SetListenerPosition(float x, float y, float z)
+{
+    alListener3f(AL_POSITION, x, y, z);
+}
+
+
+bool OpenAlBackend::HasError(void)
+{
+    return alGetError() != AL_NO_ERROR;
+}
+
+} // namespace audio_manager
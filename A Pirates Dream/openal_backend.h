@@ -0,0 +1,60 @@
+#ifndef OPENAL_BACKEND_H_
+#define OPENAL_BACKEND_H_
+
+#include <AL/al.h>
+#include <AL/alc.h>
+
+#include "audio_backend.h"
+
+namespace audio_manager {
+
+    // The backend the game plays through, every call goes straight to OpenAL
+    class OpenAlBackend : public AudioBackend {
+
+        public:
+            // Constructor and destructor
+            OpenAlBackend(void);
+            ~OpenAlBackend();
+
+            // Open a device (NULL for the default one) and make a context on it, throws an AudioManagerException if it cant
+            void Open(const char *device_name);
+            void Close(void);
+
+            // List the devices OpenAL can open to standard output
+            static void ListDevices(void);
+
+            unsigned int CreateBuffer(void);
+            void DeleteBuffer(unsigned int buffer);
+            void SetBufferData(unsigned int buffer, const int16_t *samples, int frames, int channels, int sample_rate);
+
+            unsigned int CreateSource(void);
+            void DeleteSource(unsigned int source);
+            void SetSourceBuffer(unsigned int source, unsigned int buffer);
+            void SetSourceLooping(unsigned int source, bool loop);
+            void SetSourceGain(unsigned int source, float gain);
+            void SetSourcePosition(unsigned int source, float x, float y, float z);
+            void SetSourceRelative(unsigned int source, bool relative);
+            void SetSourceDistance(unsigned int source, float reference, float max, float rolloff);
+            void SetSourceOffset(unsigned int source, float seconds);
+            void PlaySource(unsigned int source);
+            void StopSource(unsigned int source);
+            int GetSourceState(unsigned int source);
+
+            void QueueBuffer(unsigned int source, unsigned int buffer);
+            unsigned int UnqueueBuffer(unsigned int source);
+            int GetQueuedBuffers(unsigned int source);
+            int GetProcessedBuffers(unsigned int source);
+
+            void SetListenerPosition(float x, float y, float z);
+
+            bool HasError(void);
+
+        private:
+            // Audio context used by OpenAl
+            ALCcontext *context_;
+
+    }; // class OpenAlBackend
+
+} // namespace audio_manager
+
+#endif // OPENAL_BACKEND_H_
@@ -1,26 +1,26 @@
-// Source code of fragment shader
-#version 130
-
-// Attributes passed from the vertex shader
-in vec4 color_interp;
-in vec2 uv_interp;
-in vec3 color_value_out;
-
-// Texture sampler
-uniform sampler2D onetex;
-
-void main()
-{
-    // Sample texture
-    vec4 color = texture2D(onetex, uv_interp);
-    color.rgb = color_value_out * color_interp.r;
-
-    // Assign color to fragment
-    gl_FragColor = vec4(color.r, color.g, color.b, color.a);
-
-    // Check for transparency
-    if(color.a < 1.0)
-    {
-         discard;
-    }
+// Source code of fragment shader
+#version 130
+
+// Attributes passed from the vertex shader
+in vec4 color_interp;
+in vec2 uv_interp;
+in vec3 color_value_out;
+
+// Texture sampler
+uniform sampler2D onetex;
+
+void main()
+{
+    // Sample texture
+    vec4 color = texture2D(onetex, uv_interp);
+    color.rgb = color_value_out * color_interp.r;
+
+    // Assign color to fragment
+    gl_FragColor = vec4(color.r, color.g, color.b, color.a);
+
+    // Check for transparency
+    if(color.a < 1.0)
+    {
+         discard;
+    }
 }
\ No newline at end of file
@@ -1,32 +1,46 @@
-#ifndef PARTICLES_H_
-#define PARTICLES_H_
-
-#include "geometry.h"
-
-#define NUM_PARTICLES 4000
-
-namespace game {
-
-    // A set of particles that can be rendered
-    class Particles : public Geometry {
-
-        public:
-            Particles(const glm::vec3 &color_value = glm::vec3(0.8f, 0.4f, 0.01f), float spread = 0.13f, float length = 0.8f, float t = 1.0f );
-
-            // Create the geometry (called once)
-            void CreateGeometry(void);
-
-            // Use the geometry
-            void SetGeometry(GLuint shader_program);
-
-        private:
-
-            glm::vec3 color_value_;
-            float spread_;
-            float length_;
-            float t_;
-
-    }; // class Particles
-} // namespace game
-
-#endif // PARTICLES_H_
+#ifndef PARTICLES_H_
+#define PARTICLES_H_
+
+#include "geometry.h"
+#include "random.h"
+
+#define NUM_PARTICLES 4000
+
+// floats per particle vertex: position (2), direction (2), phase (1), texture coordinates (2), color (3)
+#define PARTICLE_VERTEX_ATTR 10
+
+namespace game {
+
+    // A set of particles that can be rendered
+    class Particles : public Geometry {
+
+        public:
+            Particles(const glm::vec3 &color_value = glm::vec3(0.8f, 0.4f, 0.01f), float spread = 0.13f, float length = 0.8f, float t = 1.0f );
+
+            // Create the geometry (called once)
+            void CreateGeometry(void);
+
+            // Fill in the vertices (NUM_PARTICLES * PARTICLE_VERTEX_ATTR floats) and faces (NUM_PARTICLES * 6 indices)
+            // without touching OpenGL, CreateGeometry uploads what this produces
+            void FillBuffers(GLfloat *particles, GLuint *manyfaces);
+
+            // Use the geometry
+            void SetGeometry(GLuint shader_program);
+
+            // Set the random stream used to scatter the particles (call before CreateGeometry)
+            inline void SetRandom(Random *random) { random_ = random; }
+
+        private:
+
+            glm::vec3 color_value_;
+            float spread_;
+            float length_;
+            float t_;
+
+            // where the random directions and phases come from
+            Random *random_;
+
+    }; // class Particles
+} // namespace game
+
+#endif // PARTICLES_H_
@@ -1,23 +1,25 @@
-#ifndef PLAYER_GAME_OBJECT_H_
-#define PLAYER_GAME_OBJECT_H_
-
-#include "game_object.h"
-
-namespace game {
-
-    // Inherits from GameObject
-    class PlayerGameObject : public GameObject {
-
-        public:
-            PlayerGameObject(const glm::vec3 &position, Geometry *geom, Shader *shader, GLuint texture);
-
-            void SetVelocity(glm::vec3 &velocity) override;
-
-            // Update function for moving the player object around
-            void Update(double delta_time) override;
-
-    }; // class PlayerGameObject
-
-} // namespace game
-
-#endif // PLAYER_GAME_OBJECT_H_
+#ifndef PLAYER_GAME_OBJECT_H_
+#define PLAYER_GAME_OBJECT_H_
+
+#include "game_object.h"
+
+namespace game {
+
+    // Inherits from GameObject
+    class PlayerGameObject : public GameObject {
+
+        public:
+            ALLOC_TAGGED_NEW(ALLOC_TAG_PLAYER)
+
+            PlayerGameObject(const glm::vec3 &position, Geometry *geom, Shader *shader, GLuint texture);
+
+            void SetVelocity(glm::vec3 &velocity) override;
+
+            // Update function for moving the player object around
+            void Update(double delta_time) override;
+
+    }; // class PlayerGameObject
+
+} // namespace game
+
+#endif // PLAYER_GAME_OBJECT_H_
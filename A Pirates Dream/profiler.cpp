@@ -0,0 +1,121 @@
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+
+#include "profiler.h"
+
+namespace game {
+
+// every thread that has recorded a zone, newest first
+static std::atomic<ProfileBuffer*> buffers_g(nullptr);
+
+// only handing out thread ids and adding to the list takes the lock, never recording
+static std::mutex buffers_mutex_g;
+static int next_thread_id_g = 1;
+
+// the time everything is measured from
+static const std::chrono::steady_clock::time_point start_time_g = std::chrono::steady_clock::now();
+
+static thread_local ProfileBuffer *thread_buffer_g = nullptr;
+
+
+uint64_t Profiler::Now(void)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time_g).count();
+}
+
+
+ProfileBuffer *Profiler::GetThreadBuffer(void)
+{
+    if (thread_buffer_g) return thread_buffer_g;
+
+    // the buffers are never freed, the export can still read them after their thread has finished
+    ProfileBuffer *buffer = new ProfileBuffer;
+    buffer->count.store(0, std::memory_order_relaxed);
+    buffer->thread_name = nullptr;
+
+    std::lock_guard<std::mutex> lock(buffers_mutex_g);
+    buffer->thread_id = next_thread_id_g++;
+    buffer->next = buffers_g.load(std::memory_order_relaxed);
+    buffers_g.store(buffer, std::memory_order_release);
+
+    thread_buffer_g = buffer;
+    return buffer;
+}
+
+
+void Profiler::Record(const char *name, uint64_t start, uint64_t end)
+{
+    ProfileBuffer *buffer = GetThreadBuffer();
+
+    uint64_t count = buffer->count.load(std::memory_order_relaxed);
+    ProfileEvent &event = buffer->events[count % PROFILE_BUFFER_SIZE];
+    event.name = name;
+    event.start = start;
+    event.end = end;
+
+    // publish the event after it is written so the export never sees half of it
+    buffer->count.store(count + 1, std::memory_order_release);
+}
+
+
+void Profiler::SetThreadName(const char *name)
+{
+    GetThreadBuffer()->thread_name = name;
+}
+
+
+// Write a zone name as a json string
+static void WriteJsonString(std::ofstream &f, const char *text)
+{
+    f << '"';
+    for (const char *c = text; *c; c++)
+    {
+        if (*c == '"' || *c == '\\') f << '\\';
+        f << *c;
+    }
+    f << '"';
+}
+
+
+void Profiler::WriteChromeTrace(const std::string &filename)
+{
+    std::ofstream f(filename.c_str());
+    if (f.fail()) {
+        throw(std::ios_base::failure(std::string("Error opening file ") + filename));
+    }
+
+    // the trace wants microseconds, keep the fractions so short zones dont all come out as 0
+    f.setf(std::ios::fixed);
+    f.precision(3);
+
+    f << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    for (ProfileBuffer *buffer = buffers_g.load(std::memory_order_acquire); buffer; buffer = buffer->next)
+    {
+        if (buffer->thread_name)
+        {
+            f << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->thread_id << ",\"args\":{\"name\":";
+            WriteJsonString(f, buffer->thread_name);
+            f << "}}";
+            first = false;
+        }
+
+        // once the ring has wrapped only the newest PROFILE_BUFFER_SIZE zones are left
+        uint64_t count = buffer->count.load(std::memory_order_acquire);
+        uint64_t begin = count > PROFILE_BUFFER_SIZE ? count - PROFILE_BUFFER_SIZE : 0;
+        for (uint64_t i = begin; i < count; i++)
+        {
+            const ProfileEvent &event = buffer->events[i % PROFILE_BUFFER_SIZE];
+            f << (first ? "" : ",\n") << "{\"name\":";
+            WriteJsonString(f, event.name);
+            f << ",\"cat\":\"game\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->thread_id
+              << ",\"ts\":" << event.start / 1000.0 << ",\"dur\":" << (event.end - event.start) / 1000.0 << "}";
+            first = false;
+        }
+    }
+    f << "\n]}\n";
+}
+
+} // namespace game
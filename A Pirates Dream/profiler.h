@@ -0,0 +1,102 @@
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <string>
+#include <atomic>
+#include <stdint.h>
+
+// how many zones each thread keeps before it starts writing over its oldest ones
+#define PROFILE_BUFFER_SIZE 65536
+
+/*
+    Scoped profiling zones, put PROFILE_ZONE("name") at the top of a block to time it
+    The zones only exist when the build defines PROFILE_ENABLED (cmake -DPROFILE=ON), otherwise
+    the macro is empty and costs nothing. The name has to be a string literal, only the pointer is kept
+*/
+#ifdef PROFILE_ENABLED
+#define PROFILE_JOIN_(a, b) a##b
+#define PROFILE_JOIN(a, b) PROFILE_JOIN_(a, b)
+#define PROFILE_ZONE(name) game::ProfileZone PROFILE_JOIN(profile_zone_, __LINE__)(name)
+#define PROFILE_THREAD(name) game::Profiler::SetThreadName(name)
+#else
+#define PROFILE_ZONE(name) ((void) 0)
+#define PROFILE_THREAD(name) ((void) 0)
+#endif
+
+namespace game {
+
+    // One finished zone
+    struct ProfileEvent {
+        const char *name;
+        uint64_t start;
+        uint64_t end;
+    };
+
+    // The zones a single thread has finished, only that thread writes and the export only reads
+    // so a zone closing never takes a lock
+    struct ProfileBuffer {
+        ProfileEvent events[PROFILE_BUFFER_SIZE];
+
+        // how many zones were ever written, the slot is this modulo the size
+        std::atomic<uint64_t> count;
+
+        // the thread it belongs to, for the trace
+        int thread_id;
+        const char *thread_name;
+
+        // the next buffer in the list of every thread that has profiled
+        ProfileBuffer *next;
+    };
+
+    /*
+        Profiler collects the zones from every thread and writes them out in the Chrome trace event
+        format, open the file in chrome://tracing or https://ui.perfetto.dev to see it
+    */
+    class Profiler {
+
+        public:
+            // Nanoseconds since the program started
+            static uint64_t Now(void);
+
+            // Record a zone on the calling thread
+            static void Record(const char *name, uint64_t start, uint64_t end);
+
+            // Name the calling thread in the trace
+            static void SetThreadName(const char *name);
+
+            // Write every zone still in the buffers to a trace file
+            // Call it when the other threads are done profiling, zones closing while it runs may come out torn
+            static void WriteChromeTrace(const std::string &filename);
+
+            // Whether the zones were compiled in
+            static inline bool IsEnabled(void) {
+#ifdef PROFILE_ENABLED
+                return true;
+#else
+                return false;
+#endif
+            }
+
+        private:
+            // The calling threads buffer, made and added to the list the first time a thread asks
+            static ProfileBuffer *GetThreadBuffer(void);
+
+    }; // class Profiler
+
+
+    // Times the block it is declared in, use PROFILE_ZONE instead of making one directly
+    class ProfileZone {
+
+        public:
+            inline ProfileZone(const char *name) : name_(name), start_(Profiler::Now()) {}
+            inline ~ProfileZone() { Profiler::Record(name_, start_, Profiler::Now()); }
+
+        private:
+            const char *name_;
+            uint64_t start_;
+
+    }; // class ProfileZone
+
+} // namespace game
+
+#endif // PROFILER_H_
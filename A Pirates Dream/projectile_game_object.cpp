@@ -1,38 +1,54 @@
-#include "projectile_game_object.h"
-
-namespace game {
-
-/*
-	ProjectileGameObject inherits from GameObject
-	It overrides GameObject's update method, so that you can check for input to change the velocity of the player
-*/
-
-ProjectileGameObject::ProjectileGameObject(const glm::vec3 &position, Geometry *geom, Shader *shader, GLuint texture)
-	: GameObject(position, geom, shader, texture) 
-	{ 
-		start_pos_ = position;
-	}
-
-// Update function for moving the player object around
-void ProjectileGameObject::Update(double delta_time) {
-
-	// Special player updates go here
-	
-	//std::cout << time_ << std::endl;
-
-	position_.x = start_pos_.x + (velocity_.x * 100 * time_);
-	position_.y = start_pos_.y + (velocity_.y * 100 * time_);
-	
-
-	
-
-	// Call the parent's update method to move the object in standard way, if desired
-	GameObject::Update(delta_time);
-}
-
-void ProjectileGameObject::SetVelocity(glm::vec3 &velocity)
-{
-	velocity_ = velocity;
-}
-
+#include "projectile_game_object.h"
+
+namespace game {
+
+/*
+	ProjectileGameObject inherits from GameObject
+	It overrides GameObject's update method, so that you can check for input to change the velocity of the player
+*/
+
+ProjectileGameObject::ProjectileGameObject(const glm::vec3 &position, Geometry *geom, Shader *shader, GLuint texture)
+	: GameObject(position, geom, shader, texture) 
+	{ 
+		start_pos_ = position;
+	}
+
+// Update function for moving the player object around
+void ProjectileGameObject::Update(double delta_time) {
+
+	// Special player updates go here
+	
+	//std::cout << time_ << std::endl;
+
+	position_.x = start_pos_.x + (velocity_.x * 100 * time_);
+	position_.y = start_pos_.y + (velocity_.y * 100 * time_);
+	
+
+	
+
+	// Call the parent's update method to move the object in standard way, if desired
+	GameObject::Update(delta_time);
+}
+
+void ProjectileGameObject::SetVelocity(glm::vec3 &velocity)
+{
+	velocity_ = velocity;
+}
+
+
+void ProjectileGameObject::Save(Snapshot &snapshot) const
+{
+	GameObject::Save(snapshot);
+
+	snapshot.Write(start_pos_);
+}
+
+
+void ProjectileGameObject::Load(Snapshot &snapshot)
+{
+	GameObject::Load(snapshot);
+
+	snapshot.Read(start_pos_);
+}
+
 }
\ No newline at end of file
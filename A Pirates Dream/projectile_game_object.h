@@ -1,29 +1,35 @@
-#ifndef PROJECTILE_GAME_OBJECT_H_
-#define PROJECTILE_GAME_OBJECT_H_
-
-#include "game_object.h"
-
-namespace game {
-
-    // Inherits from GameObject
-    class ProjectileGameObject : public GameObject {
-
-        public:
-            ProjectileGameObject(const glm::vec3 &position, Geometry *geom, Shader *shader, GLuint texture);
-
-            void SetVelocity(glm::vec3 &velocity) override;
-
-            // Update function for moving the player object around
-            void Update(double delta_time) override;
-
-            // getter
-            inline glm::vec3 GetStart(void) const { return start_pos_;}
-
-        private:
-            glm::vec3 start_pos_;
-
-    }; // class ProjectileGameObject
-
-} // namespace game
-
+#ifndef PROJECTILE_GAME_OBJECT_H_
+#define PROJECTILE_GAME_OBJECT_H_
+
+#include "game_object.h"
+
+namespace game {
+
+    // Inherits from GameObject
+    class ProjectileGameObject : public GameObject {
+
+        public:
+            ALLOC_TAGGED_NEW(ALLOC_TAG_PROJECTILE)
+
+            ProjectileGameObject(const glm::vec3 &position, Geometry *geom, Shader *shader, GLuint texture);
+
+            void SetVelocity(glm::vec3 &velocity) override;
+
+            // Update function for moving the player object around
+            void Update(double delta_time) override;
+
+            // getter
+            inline glm::vec3 GetStart(void) const { return start_pos_;}
+
+            // Save or restore the projectile along with where it was fired from
+            void Save(Snapshot &snapshot) const override;
+            void Load(Snapshot &snapshot) override;
+
+        private:
+            glm::vec3 start_pos_;
+
+    }; // class ProjectileGameObject
+
+} // namespace game
+
 #endif // PLAYER_GAME_OBJECT_H_
\ No newline at end of file
@@ -0,0 +1,141 @@
+#include "random.h"
+
+namespace game {
+
+// splitmix64, used to turn one seed into well mixed generator states
+static uint64_t SplitMix64(uint64_t &x)
+{
+    uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+
+static inline uint32_t Rotl(uint32_t x, int k)
+{
+    return (x << k) | (x >> (32 - k));
+}
+
+
+// turn the top 24 bits into a float in [0, 1)
+static inline float ToFloat(uint32_t x)
+{
+    return (x >> 8) * (1.0f / 16777216.0f);
+}
+
+
+Random::Random(uint64_t seed)
+{
+    Seed(seed);
+}
+
+
+void Random::Seed(uint64_t seed)
+{
+    uint64_t x = seed;
+    uint64_t a = SplitMix64(x);
+    uint64_t b = SplitMix64(x);
+    state_[0] = static_cast<uint32_t>(a);
+    state_[1] = static_cast<uint32_t>(a >> 32);
+    state_[2] = static_cast<uint32_t>(b);
+    state_[3] = static_cast<uint32_t>(b >> 32);
+
+    // an all zero state would only ever give zeros
+    if ((state_[0] | state_[1] | state_[2] | state_[3]) == 0) state_[0] = 1;
+}
+
+
+uint32_t Random::NextU32(void)
+{
+    uint32_t result = Rotl(state_[1] * 5, 7) * 9;
+    uint32_t t = state_[1] << 9;
+
+    state_[2] ^= state_[0];
+    state_[3] ^= state_[1];
+    state_[1] ^= state_[2];
+    state_[0] ^= state_[3];
+    state_[2] ^= t;
+    state_[3] = Rotl(state_[3], 11);
+
+    return result;
+}
+
+
+float Random::NextFloat(void)
+{
+    return ToFloat(NextU32());
+}
+
+
+int Random::NextInt(int n)
+{
+    if (n <= 0) return 0;
+
+    // scale the bits down instead of using modulo so small ranges stay even
+    return static_cast<int>((static_cast<uint64_t>(NextU32()) * static_cast<uint64_t>(n)) >> 32);
+}
+
+
+void Random::Fill(float *out, int count, float lo, float hi)
+{
+    // four generators laid out lane by lane, seeded off this stream
+    uint32_t s0[4], s1[4], s2[4], s3[4];
+    for (int l = 0; l < 4; l++)
+    {
+        s0[l] = NextU32();
+        s1[l] = NextU32();
+        s2[l] = NextU32();
+        s3[l] = NextU32() | 1;
+    }
+
+    float scale = (hi - lo) * (1.0f / 16777216.0f);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        // the same xoshiro128** step on every lane
+        for (int l = 0; l < 4; l++)
+        {
+            uint32_t m = s1[l] * 5;
+            uint32_t result = ((m << 7) | (m >> 25)) * 9;
+            uint32_t t = s1[l] << 9;
+
+            s2[l] ^= s0[l];
+            s3[l] ^= s1[l];
+            s1[l] ^= s2[l];
+            s0[l] ^= s3[l];
+            s2[l] ^= t;
+            s3[l] = (s3[l] << 11) | (s3[l] >> 21);
+
+            out[i + l] = lo + static_cast<float>(result >> 8) * scale;
+        }
+    }
+
+    // whatever doesnt fill a full group of four
+    for (; i < count; i++)
+    {
+        out[i] = Range(lo, hi);
+    }
+}
+
+
+RandomService::RandomService(uint64_t seed)
+{
+    Seed(seed);
+}
+
+
+void RandomService::Seed(uint64_t seed)
+{
+    seed_ = seed;
+
+    // each stream gets its own seed so pulling numbers from one never shifts another
+    uint64_t x = seed;
+    for (int i = 0; i < RANDOM_NUM_STREAMS; i++)
+    {
+        streams_[i].Seed(SplitMix64(x));
+    }
+}
+
+} // namespace game
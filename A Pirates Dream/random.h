@@ -0,0 +1,82 @@
+#ifndef RANDOM_H_
+#define RANDOM_H_
+
+#include <stdint.h>
+
+// the independent streams handed out by the random service
+#define RANDOM_SPAWN 0
+#define RANDOM_DROP 1
+#define RANDOM_PARTICLES 2
+#define RANDOM_AI 3
+#define RANDOM_NUM_STREAMS 4
+
+namespace game {
+
+    /*
+        Random is one stream of random numbers (xoshiro128**)
+        It is small, fast and fully determined by its seed, and every stream has its own state
+        so different systems (or threads) never have to share one
+    */
+    class Random {
+
+        public:
+            // Constructor, every stream starts from a seed
+            Random(uint64_t seed = 1);
+
+            // Restart the stream from a seed
+            void Seed(uint64_t seed);
+
+            // The next 32 random bits
+            uint32_t NextU32(void);
+
+            // A float in [0, 1)
+            float NextFloat(void);
+
+            // A float in [lo, hi)
+            inline float Range(float lo, float hi) { return lo + (hi - lo) * NextFloat(); }
+
+            // An int in [0, n)
+            int NextInt(int n);
+
+            // Fill a whole array with floats in [lo, hi)
+            // This runs four generators side by side so the compiler can keep them all in one vector register
+            void Fill(float *out, int count, float lo = 0.0f, float hi = 1.0f);
+
+            // The raw state, used to save and restore the stream
+            inline void GetState(uint32_t state[4]) const { for (int i = 0; i < 4; i++) state[i] = state_[i]; }
+            inline void SetState(const uint32_t state[4]) { for (int i = 0; i < 4; i++) state_[i] = state[i]; }
+
+        private:
+            // the generator state
+            uint32_t state_[4];
+
+    }; // class Random
+
+
+    // Hands out one seeded stream per subsystem, all derived from a single game seed
+    class RandomService {
+
+        public:
+            // Constructor
+            RandomService(uint64_t seed = 1);
+
+            // Reseed every stream from one game seed
+            void Seed(uint64_t seed);
+
+            // Get the stream for a subsystem (RANDOM_SPAWN, RANDOM_DROP, ...)
+            inline Random &Get(int stream) { return streams_[stream]; }
+
+            inline uint64_t GetSeed(void) const { return seed_; }
+
+        private:
+            // the seed everything was derived from
+            uint64_t seed_;
+
+            // one stream per subsystem
+            Random streams_[RANDOM_NUM_STREAMS];
+
+    }; // class RandomService
+
+} // namespace game
+
+#endif // RANDOM_H_
@@ -0,0 +1,428 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "rollback_session.h"
+#include "profiler.h"
+
+namespace game {
+
+// the first bytes of every packet, anything else on the port is ignored
+static const uint32_t packet_magic_g = 0x50445242;
+
+// how often we say hello while waiting for the other player, in seconds
+static const double hello_interval_g = 0.1;
+
+
+static double Seconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+void RollbackStats::Report(std::ostream &out) const
+{
+    double per_frame = frames > 0 ? 1000.0 / frames : 0.0;
+
+    out << "  frames " << frames << ", held back " << stalls << " waiting for input and " << waits << " to let the other player catch up" << std::endl;
+    out << "  rollbacks " << rollbacks << " (" << (frames > 0 ? 100.0 * rollbacks / frames : 0.0) << "% of frames), "
+        << resimulated << " frames run again, " << (rollbacks > 0 ? static_cast<double>(resimulated) / rollbacks : 0.0)
+        << " deep on average and " << max_depth << " at most" << std::endl;
+    out << "  running frames again took " << resimulate_seconds * 1000.0 << " ms (" << resimulate_seconds * per_frame << " ms/frame, "
+        << (rollbacks > 0 ? resimulate_seconds * 1000.0 / rollbacks : 0.0) << " ms/rollback), saving snapshots "
+        << save_seconds * 1000.0 << " ms (" << save_seconds * per_frame << " ms/frame)" << std::endl;
+    out << "  packets sent " << sent << " (" << dropped << " dropped on purpose), received " << received << " (" << bad << " bad)" << std::endl;
+    out << "  checksums compared " << checksums << ", desyncs " << desyncs << std::endl;
+}
+
+
+RollbackSession::RollbackSession(void)
+{
+    player_ = 0;
+    connected_ = false;
+    seed_ = 0;
+    last_hello_ = -1.0;
+    simulation_ = NULL;
+    frame_ = 0;
+    confirmed_ = 0;
+    remote_frame_ = 0;
+    remote_advantage_ = 0;
+    sync_frame_ = 0;
+    acked_ = 0;
+    latest_ = 0;
+    rollback_to_ = -1;
+    next_checksum_ = 0;
+    latest_checksum_ = -1;
+
+    for (int i = 0; i < ROLLBACK_INPUT_RING; i++)
+    {
+        local_[i] = remote_[i] = guessed_[i] = 0;
+        local_slot_[i] = remote_slot_[i] = -1;
+    }
+    for (int i = 0; i < ROLLBACK_MAX_PREDICTION; i++)
+    {
+        saved_frame_[i] = -1;
+    }
+    for (int i = 0; i < ROLLBACK_CHECKSUM_RING; i++)
+    {
+        local_checksum_frame_[i] = remote_checksum_frame_[i] = compared_frame_[i] = -1;
+        local_checksum_[i] = remote_checksum_[i] = 0;
+    }
+}
+
+
+void RollbackSession::Open(int player, int port, const NetAddress &remote, uint64_t seed, const NetConditions &conditions)
+{
+    if (player != 0 && player != 1)
+    {
+        throw(std::runtime_error(std::string("A co-op game has players 0 and 1, not ") + std::to_string(player)));
+    }
+
+    player_ = player;
+    peer_ = remote;
+    seed_ = seed;
+
+    link_.Open(port, seed ^ (0x9e3779b97f4a7c15ULL * (player + 1)), conditions);
+
+    // nobody presses anything during the input delay, so those frames are known from the start
+    for (int f = 0; f < ROLLBACK_INPUT_DELAY; f++)
+    {
+        local_[f] = remote_[f] = 0;
+        local_slot_[f] = remote_slot_[f] = f;
+    }
+    latest_ = ROLLBACK_INPUT_DELAY;
+    confirmed_ = ROLLBACK_INPUT_DELAY;
+}
+
+
+bool RollbackSession::Connect(double now)
+{
+    // keep saying it even once weve heard them, they might not have heard us yet
+    Receive(now);
+    if (now - last_hello_ >= hello_interval_g)
+    {
+        Send(now);
+        last_hello_ = now;
+    }
+    link_.Flush(now);
+    return connected_;
+}
+
+
+void RollbackSession::Begin(Simulation *simulation)
+{
+    if (simulation->GetNumPlayers() != 2)
+    {
+        throw(std::runtime_error(std::string("A co-op game needs a simulation set up for two players")));
+    }
+
+    simulation_ = simulation;
+    simulation_->Save(start_);
+}
+
+
+void RollbackSession::Poll(double now)
+{
+    Receive(now);
+    if (rollback_to_ >= 0) Rollback();
+    SendInputs(now);
+}
+
+
+bool RollbackSession::AdvanceFrame(uint8_t keys, double now)
+{
+    PROFILE_ZONE("RollbackSession::AdvanceFrame");
+
+    Receive(now);
+    if (rollback_to_ >= 0) Rollback();
+
+    // too far ahead of what we know of the other player, any more guessing and we couldnt roll it back
+    if (frame_ - confirmed_ >= ROLLBACK_MAX_PREDICTION)
+    {
+        stats_.stalls++;
+        SendInputs(now);
+        return false;
+    }
+
+    // we both see the other a little behind, if were further ahead than they are we sit a frame out so
+    // the rollbacks dont all end up on one side. What we know of them is a round trip old, so we give it
+    // a while to catch up with the last frame we sat out before doing it again
+    int advantage = frame_ - remote_frame_;
+    if (frame_ >= sync_frame_ && (advantage - remote_advantage_) / 2 >= 2)
+    {
+        stats_.waits++;
+        sync_frame_ = frame_ + ROLLBACK_SYNC_INTERVAL;
+        SendInputs(now);
+        return false;
+    }
+
+    // our keys for a few frames from now
+    int f = frame_ + ROLLBACK_INPUT_DELAY;
+    local_[f % ROLLBACK_INPUT_RING] = keys;
+    local_slot_[f % ROLLBACK_INPUT_RING] = f;
+    latest_ = f + 1;
+
+    SaveFrame(frame_);
+    Checksum();
+    Step(frame_);
+    frame_++;
+    stats_.frames++;
+
+    SendInputs(now);
+    return true;
+}
+
+
+uint8_t RollbackSession::RemoteKeys(int frame)
+{
+    int slot = frame % ROLLBACK_INPUT_RING;
+    if (remote_slot_[slot] == frame) return remote_[slot];
+
+    // the best guess is they are still holding whatever they last pressed
+    int last = (confirmed_ - 1) % ROLLBACK_INPUT_RING;
+    guessed_[slot] = remote_[last];
+    return guessed_[slot];
+}
+
+
+void RollbackSession::Step(int frame)
+{
+    int slot = frame % ROLLBACK_INPUT_RING;
+    uint8_t keys[2];
+    keys[player_] = local_slot_[slot] == frame ? local_[slot] : 0;
+    keys[1 - player_] = RemoteKeys(frame);
+
+    simulation_->HandleControls(0, keys[0], ROLLBACK_TICK);
+    simulation_->HandleControls(1, keys[1], ROLLBACK_TICK);
+    simulation_->Update(ROLLBACK_TICK);
+
+    // both games get here on the same frame, so both start over together
+    if (simulation_->IsOver()) simulation_->Restore(start_);
+}
+
+
+void RollbackSession::Rollback(void)
+{
+    PROFILE_ZONE("RollbackSession::Rollback");
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    int from = rollback_to_;
+    rollback_to_ = -1;
+
+    int slot = from % ROLLBACK_MAX_PREDICTION;
+    if (saved_frame_[slot] != from)
+    {
+        throw(std::runtime_error(std::string("Cant roll back to frame ") + std::to_string(from) + std::string(", it wasnt kept")));
+    }
+    simulation_->Restore(saved_[slot]);
+
+    for (int f = from; f < frame_; f++)
+    {
+        if (f > from) SaveFrame(f);
+        Step(f);
+    }
+
+    // these were all heard the first time the frames ran
+    dropped_sounds_.clear();
+    simulation_->TakeAudioEvents(dropped_sounds_);
+
+    int depth = frame_ - from;
+    stats_.rollbacks++;
+    stats_.resimulated += depth;
+    stats_.max_depth = std::max(stats_.max_depth, depth);
+    stats_.resimulate_seconds += Seconds(start);
+}
+
+
+void RollbackSession::SaveFrame(int frame)
+{
+    // a frame we know everything about is never rolled back to, unless we still need its checksum
+    bool checked = frame % ROLLBACK_CHECKSUM_INTERVAL == 0 && frame >= next_checksum_;
+    if (frame < confirmed_ && !checked) return;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    int slot = frame % ROLLBACK_MAX_PREDICTION;
+    simulation_->Save(saved_[slot]);
+    saved_frame_[slot] = frame;
+    stats_.save_seconds += Seconds(start);
+}
+
+
+void RollbackSession::Checksum(void)
+{
+    // a frame is certain once we have both players keys for everything before it
+    while (next_checksum_ <= confirmed_ && next_checksum_ <= frame_)
+    {
+        int slot = next_checksum_ % ROLLBACK_MAX_PREDICTION;
+        if (saved_frame_[slot] == next_checksum_)
+        {
+            int ring = (next_checksum_ / ROLLBACK_CHECKSUM_INTERVAL) % ROLLBACK_CHECKSUM_RING;
+            local_checksum_frame_[ring] = next_checksum_;
+            local_checksum_[ring] = saved_[slot].GetChecksum();
+            latest_checksum_ = next_checksum_;
+            CompareChecksum(next_checksum_);
+        }
+        next_checksum_ += ROLLBACK_CHECKSUM_INTERVAL;
+    }
+}
+
+
+void RollbackSession::CompareChecksum(int frame)
+{
+    int ring = (frame / ROLLBACK_CHECKSUM_INTERVAL) % ROLLBACK_CHECKSUM_RING;
+    if (local_checksum_frame_[ring] != frame || remote_checksum_frame_[ring] != frame || compared_frame_[ring] == frame) return;
+
+    stats_.checksums++;
+    if (local_checksum_[ring] != remote_checksum_[ring])
+    {
+        if (stats_.desyncs == 0) std::cerr << "The co-op games went out of sync by frame " << frame << std::endl;
+        stats_.desyncs++;
+    }
+
+    // every packet repeats it, it only counts once
+    compared_frame_[ring] = frame;
+}
+
+
+void RollbackSession::SendInputs(double now)
+{
+    if (!connected_) return;
+    Send(now);
+}
+
+
+void RollbackSession::Send(double now)
+{
+    // the keys the other player hasnt told us they got, as many as fit
+    int from = std::max(acked_, latest_ - 255);
+    int count = latest_ - from;
+
+    packet_.Clear();
+    packet_.Write(packet_magic_g);
+    packet_.Write(static_cast<uint8_t>(player_));
+    packet_.Write(seed_);
+    packet_.Write(frame_);
+    packet_.Write(frame_ - remote_frame_);
+    packet_.Write(confirmed_);
+    packet_.Write(from);
+    packet_.Write(static_cast<uint8_t>(count));
+    for (int f = from; f < latest_; f++)
+    {
+        packet_.Write(local_[f % ROLLBACK_INPUT_RING]);
+    }
+
+    // our latest checksum rides along, they compare it when theyve got theirs
+    int ring = latest_checksum_ >= 0 ? (latest_checksum_ / ROLLBACK_CHECKSUM_INTERVAL) % ROLLBACK_CHECKSUM_RING : 0;
+    packet_.Write(latest_checksum_);
+    packet_.Write(latest_checksum_ >= 0 ? local_checksum_[ring] : 0u);
+
+    stats_.sent++;
+    if (!link_.Send(peer_, &packet_.GetData()[0], static_cast<int>(packet_.GetSize()), now)) stats_.dropped++;
+}
+
+
+void RollbackSession::Receive(double now)
+{
+    uint8_t buffer[UDP_MAX_PACKET];
+    NetAddress from;
+    int size;
+    while ((size = link_.Receive(from, buffer, sizeof(buffer), now)) >= 0)
+    {
+        packet_.Clear();
+        packet_.WriteBytes(buffer, size);
+
+        try
+        {
+            uint32_t magic;
+            uint8_t player;
+            uint64_t seed;
+            packet_.Read(magic);
+            packet_.Read(player);
+            packet_.Read(seed);
+            if (magic != packet_magic_g || player != 1 - player_)
+            {
+                stats_.bad++;
+                continue;
+            }
+
+            // the second player plays the first players game, it cant change once weve started
+            if (player_ == 1 && !simulation_) seed_ = seed;
+            if (player_ == 1 && seed != seed_)
+            {
+                stats_.bad++;
+                continue;
+            }
+            connected_ = true;
+
+            int frame, advantage, ack, start;
+            uint8_t count;
+            packet_.Read(frame);
+            packet_.Read(advantage);
+            packet_.Read(ack);
+            packet_.Read(start);
+            packet_.Read(count);
+
+            if (frame >= remote_frame_)
+            {
+                remote_frame_ = frame;
+                remote_advantage_ = advantage;
+            }
+            acked_ = std::max(acked_, ack);
+
+            for (int i = 0; i < count; i++)
+            {
+                uint8_t keys;
+                packet_.Read(keys);
+                TakeRemote(start + i, keys);
+            }
+
+            int checksum_frame;
+            uint32_t checksum;
+            packet_.Read(checksum_frame);
+            packet_.Read(checksum);
+            if (checksum_frame >= 0)
+            {
+                // if theyre ahead of us it waits here until we get there
+                int ring = (checksum_frame / ROLLBACK_CHECKSUM_INTERVAL) % ROLLBACK_CHECKSUM_RING;
+                remote_checksum_frame_[ring] = checksum_frame;
+                remote_checksum_[ring] = checksum;
+                CompareChecksum(checksum_frame);
+            }
+
+            stats_.received++;
+        }
+        catch (std::exception &e)
+        {
+            // cut short on the way
+            stats_.bad++;
+        }
+    }
+}
+
+
+void RollbackSession::TakeRemote(int frame, uint8_t keys)
+{
+    // already have it, or too far ahead to have anywhere to put it
+    if (frame < confirmed_ || frame >= confirmed_ + ROLLBACK_INPUT_RING) return;
+
+    int slot = frame % ROLLBACK_INPUT_RING;
+    if (remote_slot_[slot] == frame) return;
+
+    remote_[slot] = keys;
+    remote_slot_[slot] = frame;
+
+    // we already ran this frame on a guess, if the guess was wrong everything from here on has to run again
+    if (frame < frame_ && guessed_[slot] != keys)
+    {
+        if (rollback_to_ < 0 || frame < rollback_to_) rollback_to_ = frame;
+    }
+
+    while (remote_slot_[confirmed_ % ROLLBACK_INPUT_RING] == confirmed_)
+    {
+        confirmed_++;
+    }
+}
+
+} // namespace game
@@ -0,0 +1,192 @@
+#ifndef ROLLBACK_SESSION_H_
+#define ROLLBACK_SESSION_H_
+
+#include <stdint.h>
+#include <ostream>
+#include <vector>
+
+#include "simulation.h"
+#include "snapshot.h"
+#include "net_link.h"
+
+// every frame of a co-op game is exactly this long, on both machines
+#define ROLLBACK_TICK (1.0 / 60.0)
+
+// how many frames our own input waits before it is used, the other player gets that long to hear about it
+#define ROLLBACK_INPUT_DELAY 2
+
+// how far we go ahead of the other players input before we wait for it, and so how far back a rollback can go
+#define ROLLBACK_MAX_PREDICTION 12
+
+// how many frames of input we remember, more than can ever be waiting to be sent or used
+#define ROLLBACK_INPUT_RING 128
+
+// the least number of frames between two we sit out to let the other player catch up
+#define ROLLBACK_SYNC_INTERVAL 10
+
+// the state of the world is compared every so many frames to catch the two games drifting apart
+#define ROLLBACK_CHECKSUM_INTERVAL 30
+#define ROLLBACK_CHECKSUM_RING 8
+
+namespace game {
+
+    // What the session has been up to
+    struct RollbackStats {
+        long long frames;
+        long long rollbacks;
+        long long resimulated;
+        int max_depth;
+        double resimulate_seconds;
+        double save_seconds;
+
+        // frames we held back, because the other player was too far behind or just behind us
+        long long stalls;
+        long long waits;
+
+        long long sent;
+        long long received;
+        long long dropped;
+        long long bad;
+
+        long long checksums;
+        long long desyncs;
+
+        RollbackStats(void) : frames(0), rollbacks(0), resimulated(0), max_depth(0), resimulate_seconds(0.0), save_seconds(0.0),
+                              stalls(0), waits(0), sent(0), received(0), dropped(0), bad(0), checksums(0), desyncs(0) {}
+
+        // Print it all out, with the averages worked out
+        void Report(std::ostream &out) const;
+    };
+
+    /*
+        RollbackSession plays a two player game over UDP with no server, both machines run the whole
+        simulation and only send each other their keys
+        Rather than waiting to hear what the other player pressed we guess (the same as last time), carry on,
+        and if the guess turns out wrong go back to the last frame we knew for sure, put the right keys in and
+        run the frames since then again. A snapshot is kept of every frame that still has a guess in it
+        The simulation has to come out exactly the same on both machines given the same keys, so every frame
+        is ROLLBACK_TICK long no matter how fast the game runs, and both games start from the same seed (the
+        first player picks it). A checksum of the world goes back and forth now and then to check that it did
+        Sounds from frames that are run again are dropped, they were already played the first time round
+    */
+    class RollbackSession {
+
+        public:
+            // Constructor
+            RollbackSession(void);
+
+            // Start talking to the other player, we are player 0 or 1 and the first players seed is the one used
+            // Throws if the port cant be opened
+            void Open(int player, int port, const NetAddress &remote, uint64_t seed, const NetConditions &conditions = NetConditions());
+
+            // Say hello until the other player does (and a little longer), now is the time in seconds on the callers clock
+            // Returns true once they have, GetSeed then has the seed both games have to use
+            bool Connect(double now);
+
+            // Take over a simulation set up for two players with GetSeed, it is saved as the start for a restart
+            void Begin(Simulation *simulation);
+
+            // Run the next frame with our keys, sending and receiving on the way and going back over any frames we
+            // guessed wrong. Returns false if we had to wait on the other player instead
+            bool AdvanceFrame(uint8_t keys, double now);
+
+            // Send and receive (and roll back if we have to) without running a new frame
+            void Poll(double now);
+
+            // Getters
+            inline bool IsConnected(void) const { return connected_; }
+            inline uint64_t GetSeed(void) const { return seed_; }
+            inline int GetLocalPlayer(void) const { return player_; }
+            inline int GetPort(void) const { return link_.GetPort(); }
+            inline int GetFrame(void) const { return frame_; }
+            inline int GetConfirmedFrame(void) const { return confirmed_; }
+            inline const RollbackStats &GetStats(void) const { return stats_; }
+
+        private:
+            // which player we are and the one we play with
+            int player_;
+            NetLink link_;
+            NetAddress peer_;
+            bool connected_;
+            uint64_t seed_;
+            double last_hello_;
+
+            Simulation *simulation_;
+            Snapshot start_;
+
+            // the next frame to run
+            int frame_;
+
+            // every frame before this has the other players keys, the rest are guesses
+            int confirmed_;
+
+            // the latest frame the other player has told us they ran, and how far they were ahead of us then
+            int remote_frame_;
+            int remote_advantage_;
+
+            // the first frame we can sit out again
+            int sync_frame_;
+
+            // every frame below this of our own keys has reached the other player, and we have keys up to latest
+            int acked_;
+            int latest_;
+
+            // our keys and theirs by frame, which frame each slot holds (-1 if none) and what we guessed for theirs
+            uint8_t local_[ROLLBACK_INPUT_RING];
+            int local_slot_[ROLLBACK_INPUT_RING];
+            uint8_t remote_[ROLLBACK_INPUT_RING];
+            int remote_slot_[ROLLBACK_INPUT_RING];
+            uint8_t guessed_[ROLLBACK_INPUT_RING];
+
+            // the world at the start of every frame that could still be rolled back to, by frame
+            Snapshot saved_[ROLLBACK_MAX_PREDICTION];
+            int saved_frame_[ROLLBACK_MAX_PREDICTION];
+
+            // the earliest frame we found a wrong guess in, -1 if none
+            int rollback_to_;
+
+            // the checksums of the world at the start of the frames that are checked, ours and theirs, and the
+            // frame each slot was last compared for. The next frame to check and the last one we did
+            int next_checksum_;
+            int latest_checksum_;
+            int local_checksum_frame_[ROLLBACK_CHECKSUM_RING];
+            uint32_t local_checksum_[ROLLBACK_CHECKSUM_RING];
+            int remote_checksum_frame_[ROLLBACK_CHECKSUM_RING];
+            uint32_t remote_checksum_[ROLLBACK_CHECKSUM_RING];
+            int compared_frame_[ROLLBACK_CHECKSUM_RING];
+
+            RollbackStats stats_;
+            Snapshot packet_;
+            std::vector<SimAudioEvent> dropped_sounds_;
+
+            // Take in every packet that arrived, and send on the delayed ones whose time has come
+            void Receive(double now);
+
+            // Send our keys from the first one the other player hasnt got, through a pretend bad network
+            void SendInputs(double now);
+            void Send(double now);
+
+            // Keep the keys the other player sent for a frame, and mark where a guess of ours was wrong
+            void TakeRemote(int frame, uint8_t keys);
+
+            // The keys to use for the other player on a frame, theirs if we have them and a guess if not
+            uint8_t RemoteKeys(int frame);
+
+            // Run one frame with both players keys, starting over once the game is over
+            void Step(int frame);
+
+            // Go back to the frame with the first wrong guess and run up to now again
+            void Rollback(void);
+
+            // Save the world at the start of the frame about to run, if it could still be rolled back to
+            void SaveFrame(int frame);
+
+            // Work out the checksums of frames that are now certain, and compare them with theirs
+            void Checksum(void);
+            void CompareChecksum(int frame);
+
+    }; // class RollbackSession
+
+} // namespace game
+
+#endif // ROLLBACK_SESSION_H_
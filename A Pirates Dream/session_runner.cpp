@@ -0,0 +1,212 @@
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+
+#include "session_runner.h"
+#include "simulation.h"
+#include "input_recorder.h"
+#include "random.h"
+#include "snapshot.h"
+#include "profiler.h"
+
+namespace game {
+
+// what the bot can be doing, mostly sailing about and firing like a player would
+static const uint8_t bot_keys_g[] = {
+    INPUT_KEY_W | INPUT_KEY_SPACE,
+    INPUT_KEY_W | INPUT_KEY_A | INPUT_KEY_SPACE,
+    INPUT_KEY_W | INPUT_KEY_D | INPUT_KEY_SPACE,
+    INPUT_KEY_W | INPUT_KEY_A,
+    INPUT_KEY_W | INPUT_KEY_D,
+    INPUT_KEY_Q | INPUT_KEY_SPACE,
+    INPUT_KEY_E | INPUT_KEY_SPACE,
+    INPUT_KEY_S | INPUT_KEY_LEFT_SHIFT
+};
+
+
+SessionRunner::SessionRunner(void) : seed_(1), ticks_(0), next_(0), failed_(false), threads_(0), seconds_(0.0)
+{
+}
+
+
+void SessionRunner::Setup(int sessions, uint64_t seed, int ticks, const std::string &level)
+{
+    seed_ = seed;
+    ticks_ = ticks;
+    level_ = level;
+    results_.assign(sessions, SessionResult());
+    seconds_ = 0.0;
+}
+
+
+void SessionRunner::Run(int threads)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    // hardware_concurrency is allowed to not know
+    if (threads <= 0) threads = std::thread::hardware_concurrency();
+    if (threads <= 0) threads = 1;
+    threads_ = std::min(threads, std::max(static_cast<int>(results_.size()), 1));
+
+    next_ = 0;
+    failed_ = false;
+    error_.clear();
+
+    Clock::time_point start = Clock::now();
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads_; i++)
+    {
+        workers.push_back(std::thread(&SessionRunner::Work, this));
+    }
+    for (int i = 0; i < workers.size(); i++)
+    {
+        workers[i].join();
+    }
+    seconds_ = std::chrono::duration<double>(Clock::now() - start).count();
+
+    if (failed_)
+    {
+        throw(std::runtime_error(std::string("A session failed: ") + error_));
+    }
+}
+
+
+void SessionRunner::Work(void)
+{
+    PROFILE_THREAD("Session");
+
+    while (!failed_)
+    {
+        int index = next_++;
+        if (index >= results_.size()) return;
+
+        try
+        {
+            results_[index] = RunSession(seed_ + index, ticks_, level_);
+        }
+        catch (std::exception &e)
+        {
+            // only the first one gets to say what went wrong, the others just stop
+            bool expected = false;
+            if (failed_.compare_exchange_strong(expected, true)) error_ = e.what();
+        }
+    }
+}
+
+
+SessionResult SessionRunner::RunSession(uint64_t seed, int ticks, const std::string &level)
+{
+    PROFILE_ZONE("SessionRunner::RunSession");
+
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point start = Clock::now();
+
+    SessionResult result;
+    result.seed = seed;
+
+    // headless, nothing is ever drawn
+    SimulationAssets assets;
+    assets.level = level;
+
+    Simulation simulation;
+    simulation.Seed(seed);
+    simulation.Setup(assets);
+
+    // the bot draws from its own stream so it doesnt disturb the games, and holds each choice for a while
+    Random bot(seed ^ 0x2545f4914f6cdd1dULL);
+    uint8_t keys = 0;
+    int hold = 0;
+
+    int t = 0;
+    for (; t < ticks && !simulation.IsOver() && !simulation.IsWon(); t++)
+    {
+        if (hold-- <= 0)
+        {
+            keys = bot_keys_g[bot.NextInt(sizeof(bot_keys_g))];
+            hold = 15 + bot.NextInt(45);
+        }
+
+        simulation.HandleControls(keys, SESSION_TICK);
+        simulation.Update(SESSION_TICK);
+
+        int entities = simulation.GetNumEntities();
+        result.entity_ticks += entities;
+        result.peak_entities = std::max(result.peak_entities, entities);
+    }
+
+    result.ticks = t;
+    result.over = simulation.IsOver();
+    result.won = simulation.IsWon();
+    result.score = simulation.GetScore();
+    result.health = simulation.GetPlayerHealth();
+
+    Snapshot snapshot;
+    simulation.Save(snapshot);
+    result.checksum = snapshot.GetChecksum();
+
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return result;
+}
+
+
+long long SessionRunner::GetTotalTicks(void) const
+{
+    long long total = 0;
+    for (int i = 0; i < results_.size(); i++)
+    {
+        total += results_[i].ticks;
+    }
+    return total;
+}
+
+
+void SessionRunner::Report(std::ostream &out) const
+{
+    if (results_.empty()) return;
+
+    long long ticks = GetTotalTicks();
+    long long entity_ticks = 0;
+    int won = 0, over = 0, peak = 0;
+    long long score = 0;
+    int min_score = results_[0].score, max_score = results_[0].score;
+    std::vector<int> survived;
+    for (int i = 0; i < results_.size(); i++)
+    {
+        const SessionResult &result = results_[i];
+        entity_ticks += result.entity_ticks;
+        peak = std::max(peak, result.peak_entities);
+        score += result.score;
+        min_score = std::min(min_score, result.score);
+        max_score = std::max(max_score, result.score);
+        if (result.won) won++;
+        if (result.over)
+        {
+            over++;
+            survived.push_back(result.ticks);
+        }
+    }
+
+    double aggregate = seconds_ > 0.0 ? ticks / seconds_ : 0.0;
+
+    out << results_.size() << " sessions of up to " << ticks_ << " ticks on " << threads_ << " threads, "
+        << ticks << " ticks in " << seconds_ << " s" << std::endl;
+    out << "  aggregate " << static_cast<long long>(aggregate) << " ticks/s, "
+        << static_cast<long long>(aggregate / threads_) << " ticks/s per thread, "
+        << (ticks > 0 ? static_cast<double>(entity_ticks) / ticks : 0.0) << " entities on average, " << peak << " at most" << std::endl;
+
+    out << "  won " << won << ", lost " << over << ", still going " << (results_.size() - won - over)
+        << ", score " << min_score << " / " << static_cast<double>(score) / results_.size() << " / " << max_score << " (min / avg / max)" << std::endl;
+
+    // how long the lost ones lasted, the spread of it is the difficulty curve
+    if (!survived.empty())
+    {
+        std::sort(survived.begin(), survived.end());
+        int last = static_cast<int>(survived.size()) - 1;
+        out << "  lost after " << survived[last / 10] * SESSION_TICK << " / " << survived[last / 2] * SESSION_TICK
+            << " / " << survived[last - last / 10] * SESSION_TICK << " s (10th / 50th / 90th percentile)" << std::endl;
+    }
+}
+
+} // namespace game
@@ -0,0 +1,95 @@
+#ifndef SESSION_RUNNER_H_
+#define SESSION_RUNNER_H_
+
+#include <stdint.h>
+#include <atomic>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// every session runs at the games fixed 60 ticks a second
+#define SESSION_TICK (1.0 / 60.0)
+
+namespace game {
+
+    // How one session went
+    struct SessionResult {
+        uint64_t seed;
+
+        // ticks it ran for, it stops early once the game is over or won
+        int ticks;
+        bool over;
+        bool won;
+        int score;
+        int health;
+
+        // the most entities that were in the world at once, and the entities summed over every tick
+        int peak_entities;
+        long long entity_ticks;
+
+        // wall clock time it took
+        double seconds;
+
+        // of the world as it ended, so a rerun of the same seed can be checked against it
+        uint32_t checksum;
+
+        SessionResult(void) : seed(0), ticks(0), over(false), won(false), score(0), health(0), peak_entities(0), entity_ticks(0), seconds(0.0), checksum(0) {}
+    };
+
+    /*
+        SessionRunner plays a batch of whole games with nobody at the keys, each on its own seed, spread over
+        as many threads as there are cores, for trying out the difficulty over lots of games or keeping the
+        machine busy for a soak test
+        Each session is a Simulation of its own with a bot steering the ship from a random stream of its own,
+        nothing is shared between them, so a session comes out the same on whatever thread it runs or however
+        many run beside it. The threads take the next session that nobody has started until there are none left
+    */
+    class SessionRunner {
+
+        public:
+            // Constructor
+            SessionRunner(void);
+
+            // How many sessions to run and the seed of the first, the others count up from it
+            // Each stops after ticks if it isnt over by then, level is the level file (empty for the usual one)
+            void Setup(int sessions, uint64_t seed, int ticks, const std::string &level = std::string());
+
+            // Run every session on threads threads (0 for one per core) and wait until they are all done
+            void Run(int threads);
+
+            // Play one session start to finish on the calling thread
+            static SessionResult RunSession(uint64_t seed, int ticks, const std::string &level);
+
+            // Print how fast it went and how the games turned out
+            void Report(std::ostream &out) const;
+
+            // Getters
+            inline const std::vector<SessionResult> &GetResults(void) const { return results_; }
+            inline int GetThreads(void) const { return threads_; }
+            inline double GetSeconds(void) const { return seconds_; }
+            long long GetTotalTicks(void) const;
+
+        private:
+            uint64_t seed_;
+            int ticks_;
+            std::string level_;
+            std::vector<SessionResult> results_;
+
+            // the next session nobody has taken yet
+            std::atomic<int> next_;
+
+            // the first error a thread ran into, the rest are dropped
+            std::atomic<bool> failed_;
+            std::string error_;
+
+            int threads_;
+            double seconds_;
+
+            // Take sessions until there are none left
+            void Work(void);
+
+    }; // class SessionRunner
+
+} // namespace game
+
+#endif // SESSION_RUNNER_H_
@@ -0,0 +1,1484 @@
+#include <stdexcept>
+#include <string>
+#define GLM_FORCE_RADIANS
+#include <glm/gtc/matrix_transform.hpp> 
+#include <iostream>
+
+#include <path_config.h>
+
+#include "simulation.h"
+#include "collision.h"
+#include "input_recorder.h"
+#include "particle_system.h"
+#include "profiler.h"
+#include "alloc_tracker.h"
+
+namespace game {
+
+Simulation::Simulation(void)
+{
+    for (int i = 0; i < SIM_MAX_PLAYERS; i++)
+    {
+        players_[i] = NULL;
+        bullet_timers_[i] = NULL;
+    }
+    num_players_ = 1;
+    enemy_timer_ = NULL;
+    buff_timer_ = NULL;
+
+    current_time_ = 0.0;
+    player_health_ = 0;
+    score_ = 0;
+    boss_ = false;
+    over_ = false;
+    invulnerable_ = false;
+    buff_count_ = 0;
+    num_enemies_ = 0;
+    num_buffs_ = 0;
+    num_intercepting_ = 0;
+    next_lod_slot_ = 0;
+
+    // the director always draws from the spawn stream
+    spawn_director_.SetRandom(&random_.Get(RANDOM_SPAWN));
+}
+
+
+Simulation::~Simulation()
+{
+    // Free memory for all objects
+    for (int i = 0; i < SIM_MAX_PLAYERS; i++)
+    {
+        delete players_[i];
+        delete bullet_timers_[i];
+    }
+
+    ClearObjects();
+
+    delete enemy_timer_;
+    delete buff_timer_;
+}
+
+
+void Simulation::ClearObjects(void)
+{
+    for (int i = 0; i < enemy_game_objects_.size(); i++)
+    {
+        delete enemy_game_objects_[i];
+    }
+
+    for (int i = 0; i < collectible_game_objects_.size(); i++)
+    {
+        delete collectible_game_objects_[i];
+    }
+
+    for (int i = 0; i < explosions_.size(); i++)
+    {
+        // explosions own the temporary object they follow
+        GameObject* temp;
+        explosions_[i]->GetParent(&temp);
+        delete temp;
+        delete explosions_[i];
+    }
+
+    for (int i = 0; i < particle_game_objects_.size(); i++)
+    {
+        delete particle_game_objects_[i];
+    }
+
+    for (int i = 0; i < emitters_.size(); i++)
+    {
+        // emitters own their anchor too
+        GameObject* temp;
+        emitters_[i]->GetParent(&temp);
+        delete temp;
+        delete emitters_[i];
+    }
+
+    for (int i = 0; i < bullets_.size(); i++)
+    {
+        delete bullets_[i];
+    }
+
+    for (int i = 0; i < spikes_.size(); i++)
+    {
+        delete spikes_[i];
+    }
+
+    for (int i = 0; i < child_game_objects_.size(); i++)
+    {
+        delete child_game_objects_[i];
+    }
+
+    for (int i = 0; i < tentacles_.size(); i++)
+    {
+        delete tentacles_[i];
+    }
+
+    enemy_game_objects_.clear();
+    collectible_game_objects_.clear();
+    explosions_.clear();
+    particle_game_objects_.clear();
+    emitters_.clear();
+    bullets_.clear();
+    spikes_.clear();
+    child_game_objects_.clear();
+    tentacles_.clear();
+}
+
+
+void Simulation::Seed(uint64_t seed)
+{
+    random_.Seed(seed);
+}
+
+
+void Simulation::SetNumPlayers(int count)
+{
+    if (count < 1 || count > SIM_MAX_PLAYERS)
+    {
+        throw(std::runtime_error(std::string("Simulation can only have 1 to ") + std::to_string(SIM_MAX_PLAYERS) + std::string(" players")));
+    }
+    num_players_ = count;
+}
+
+
+void Simulation::Setup(const SimulationAssets &assets)
+{
+    ALLOC_SCOPE(ALLOC_TAG_SIMULATION);
+
+    assets_ = assets;
+
+    // Initialize time
+    current_time_ = 0.0;
+
+    // every timer created while setting up runs on the simulations wheel
+    TimerWheelScope wheel_scope(&timer_wheel_);
+
+    // Initialize player health
+    player_health_ = 3;
+
+    //
+    score_ = 0;
+
+    //
+    boss_ = false;
+    over_ = false;
+
+    // Initialize buff count
+    buff_count_ = 0;
+
+    // Setup the player objects (position, texture, vertex count), side by side starting from the middle
+    float pi_over_two = glm::pi<float>() / 2.0f;
+    for (int i = 0; i < num_players_; i++)
+    {
+        players_[i] = new PlayerGameObject(glm::vec3(1.0f * i, 0.0f, 0.0f), assets_.sprite, assets_.sprite_shader, assets_.tex[0]);
+        players_[i]->SetRotation(pi_over_two);
+    }
+
+    num_enemies_ = 0;
+    num_intercepting_ = 0;
+    next_lod_slot_ = 0;
+
+    // build the spawn tables now that the random numbers are seeded
+    spawn_director_.BuildTables();
+
+    // rotate the collision masks of everything that collides now instead of on the first hit
+    if (assets_.shapes)
+    {
+        int full_size[] = { 0, 1, 2, 5, 21 };
+        for (int i = 0; i < sizeof(full_size) / sizeof(int); i++)
+        {
+            assets_.shapes->Prepare(assets_.tex[full_size[i]], 1.0f);
+        }
+        assets_.shapes->Prepare(assets_.tex[8], 0.5f);
+        assets_.shapes->Prepare(assets_.tex[20], 0.5f);
+    }
+
+    // spawn 5 enemies to start, spread out around the player
+    spawn_blockers_.clear();
+    for (int i = 0; i < 5; i++)
+    {
+        glm::vec3 position;
+        if (spawn_director_.FindSpawn(SPAWN_TABLE_ENEMY, players_[0]->GetPosition(), spawn_blockers_, 0.8f, position))
+        {
+            AddEnemy(SPAWN_NAVY, position);
+            spawn_blockers_.push_back(glm::vec3(position.x, position.y, 0.0f));
+        }
+    }
+    
+    //set the base buffs to 0 since were not spawning any here
+    num_buffs_ = 0;
+
+    // index the level, its chunks get streamed in as the player reaches them
+    try
+    {
+        world_.Load(assets_.level.empty() ? std::string(RESOURCES_DIRECTORY) + std::string("/levels/sea.lvl") : assets_.level);
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+    }
+
+    // initialize the timers for spawning
+    enemy_timer_ = new Timer();
+    buff_timer_ = new Timer();
+    for (int i = 0; i < num_players_; i++)
+    {
+        bullet_timers_[i] = new Timer();
+    }
+
+    // the spawners run straight off their timers instead of being checked every frame
+    enemy_timer_->SetCallback([this]() {
+        if (player_health_ > 0 && score_ < 25 && score_ + enemy_game_objects_.size() < 25) SpawnWave();
+    });
+    buff_timer_->SetCallback([this]() {
+        if (num_buffs_ < 5 && player_health_ > 0) SpawnBuff();
+    });
+}
+
+
+int Simulation::GetNumEntities(void) const
+{
+    int count = player_health_ > 0 ? num_players_ : 0;
+    count += enemy_game_objects_.size() + collectible_game_objects_.size() + explosions_.size();
+    count += bullets_.size() + spikes_.size() + particle_game_objects_.size() + child_game_objects_.size();
+    count += emitters_.size() + tentacles_.size();
+    return count;
+}
+
+
+void Simulation::AddBullet(const glm::vec3 &position, glm::vec3 velocity)
+{
+    TimerWheelScope wheel_scope(&timer_wheel_);
+
+    bullets_.push_back(new ProjectileGameObject(position, assets_.sprite, assets_.sprite_shader, assets_.tex[6]));
+    bullets_.back()->SetScale(.25);
+    bullets_.back()->SetVelocity(velocity);
+    bullets_.back()->SetRotation( atan2(velocity.y, velocity.x) - (glm::pi<float>() / 2.0f) );
+    bullets_.back()->SetTimer(2);
+
+    // the trail follows the bullet, it sits at the same index in particle_game_objects_ as the bullet does in bullets_
+    GameObject *particles = new ParticleSystem(glm::vec3(0,0,0), assets_.bullet_particles, assets_.particle_shader, assets_.tex[6], bullets_.back());
+    particles->SetScale(0.2);
+    particle_game_objects_.push_back(particles); 
+}
+
+
+void Simulation::AddEmitter(const glm::vec3 &position)
+{
+    TimerWheelScope wheel_scope(&timer_wheel_);
+
+    // a burst of explosion particles that never runs out, following an anchor of its own
+    GameObject *particles = new ParticleSystem(glm::vec3(0,0,0), assets_.explosion_particles, assets_.particle_shader, assets_.tex[4], new GameObject(position, assets_.sprite, assets_.sprite_shader, assets_.tex[4]));
+    particles->SetScale(0.2);
+    emitters_.push_back(particles);
+}
+
+
+void Simulation::TakeAudioEvents(std::vector<SimAudioEvent> &events)
+{
+    events.insert(events.end(), audio_events_.begin(), audio_events_.end());
+    audio_events_.clear();
+}
+
+
+void Simulation::Save(Snapshot &snapshot)
+{
+    PROFILE_ZONE("Simulation::Save");
+
+    snapshot.Clear();
+    snapshot.Write(SIM_SNAPSHOT_VERSION);
+
+    // the spawn tables were built from the seed, so the seed is enough to get them back
+    snapshot.Write(random_.GetSeed());
+    for (int i = 0; i < RANDOM_NUM_STREAMS; i++)
+    {
+        uint32_t state[4];
+        random_.Get(i).GetState(state);
+        snapshot.Write(state);
+    }
+
+    snapshot.Write(current_time_);
+    snapshot.Write(player_health_);
+    snapshot.Write(score_);
+    snapshot.Write(boss_);
+    snapshot.Write(over_);
+    snapshot.Write(buff_count_);
+    snapshot.Write(num_enemies_);
+    snapshot.Write(num_buffs_);
+    snapshot.Write(num_intercepting_);
+    snapshot.Write(next_lod_slot_);
+
+    snapshot.Write(num_players_);
+    for (int i = 0; i < num_players_; i++)
+    {
+        players_[i]->Save(snapshot);
+        bullet_timers_[i]->Save(snapshot);
+    }
+    enemy_timer_->Save(snapshot);
+    buff_timer_->Save(snapshot);
+
+    snapshot.Write(static_cast<int>(enemy_game_objects_.size()));
+    for (int i = 0; i < enemy_game_objects_.size(); i++)
+    {
+        enemy_game_objects_[i]->Save(snapshot);
+    }
+
+    snapshot.Write(static_cast<int>(collectible_game_objects_.size()));
+    for (int i = 0; i < collectible_game_objects_.size(); i++)
+    {
+        collectible_game_objects_[i]->Save(snapshot);
+    }
+
+    // every bullet goes with its trail
+    snapshot.Write(static_cast<int>(bullets_.size()));
+    for (int i = 0; i < bullets_.size(); i++)
+    {
+        bullets_[i]->Save(snapshot);
+        particle_game_objects_[i]->Save(snapshot);
+    }
+
+    snapshot.Write(static_cast<int>(spikes_.size()));
+    for (int i = 0; i < spikes_.size(); i++)
+    {
+        spikes_[i]->Save(snapshot);
+    }
+
+    // explosions and emitters go after the anchor they follow
+    snapshot.Write(static_cast<int>(explosions_.size()));
+    for (int i = 0; i < explosions_.size(); i++)
+    {
+        GameObject* anchor;
+        explosions_[i]->GetParent(&anchor);
+        anchor->Save(snapshot);
+        explosions_[i]->Save(snapshot);
+    }
+
+    snapshot.Write(static_cast<int>(emitters_.size()));
+    for (int i = 0; i < emitters_.size(); i++)
+    {
+        GameObject* anchor;
+        emitters_[i]->GetParent(&anchor);
+        anchor->Save(snapshot);
+        emitters_[i]->Save(snapshot);
+    }
+
+    snapshot.Write(static_cast<int>(tentacles_.size()));
+    for (int i = 0; i < tentacles_.size(); i++)
+    {
+        tentacles_[i]->Save(snapshot);
+    }
+
+    // nothing ever makes child objects, they have no way to say who their parent was so they are left out
+
+    world_.Save(snapshot);
+    flow_field_.Save(snapshot);
+    ai_lod_.Save(snapshot);
+    kraken_ik_.Save(snapshot);
+    kraken_bvh_.Save(snapshot);
+
+    // last, the wheel writes every running timer as its place in the list of all of them
+    GetTimerEntries(timer_entries_);
+    timer_wheel_.Save(snapshot, timer_entries_);
+}
+
+
+void Simulation::Restore(Snapshot &snapshot)
+{
+    PROFILE_ZONE("Simulation::Restore");
+    ALLOC_SCOPE(ALLOC_TAG_SIMULATION);
+
+    if (!players_[0])
+    {
+        throw(std::runtime_error(std::string("Simulation has to be set up before a snapshot can be restored")));
+    }
+
+    snapshot.Rewind();
+    int version;
+    snapshot.Read(version);
+    if (version != SIM_SNAPSHOT_VERSION)
+    {
+        throw(std::runtime_error(std::string("Snapshot is from a different version of the game")));
+    }
+
+    // the objects made below get their timers on our wheel
+    TimerWheelScope wheel_scope(&timer_wheel_);
+
+    uint64_t seed;
+    snapshot.Read(seed);
+    if (seed != random_.GetSeed())
+    {
+        random_.Seed(seed);
+        spawn_director_.BuildTables();
+    }
+    for (int i = 0; i < RANDOM_NUM_STREAMS; i++)
+    {
+        uint32_t state[4];
+        snapshot.Read(state);
+        random_.Get(i).SetState(state);
+    }
+
+    snapshot.Read(current_time_);
+    snapshot.Read(player_health_);
+    snapshot.Read(score_);
+    snapshot.Read(boss_);
+    snapshot.Read(over_);
+    snapshot.Read(buff_count_);
+    snapshot.Read(num_enemies_);
+    snapshot.Read(num_buffs_);
+    snapshot.Read(num_intercepting_);
+    snapshot.Read(next_lod_slot_);
+
+    // the players are kept rather than made again, so there have to be as many as when it was saved
+    int num_players;
+    snapshot.Read(num_players);
+    if (num_players != num_players_)
+    {
+        throw(std::runtime_error(std::string("Snapshot has ") + std::to_string(num_players) + std::string(" players but the game has ") + std::to_string(num_players_)));
+    }
+    for (int i = 0; i < num_players_; i++)
+    {
+        players_[i]->Load(snapshot);
+        bullet_timers_[i]->Load(snapshot);
+    }
+    enemy_timer_->Load(snapshot);
+    buff_timer_->Load(snapshot);
+
+    // the textures, geometry and shaders all stay loaded, only the objects are made again
+    ClearObjects();
+
+    int count;
+    snapshot.Read(count);
+    for (int i = 0; i < count; i++)
+    {
+        enemy_game_objects_.push_back(new EnemyGameObject(glm::vec3(0.0f), assets_.sprite, assets_.sprite_shader, 0));
+        enemy_game_objects_.back()->Load(snapshot);
+    }
+
+    snapshot.Read(count);
+    for (int i = 0; i < count; i++)
+    {
+        collectible_game_objects_.push_back(new CollectibleGameObject(glm::vec3(0.0f), assets_.sprite, assets_.sprite_shader, 0));
+        collectible_game_objects_.back()->Load(snapshot);
+    }
+
+    snapshot.Read(count);
+    for (int i = 0; i < count; i++)
+    {
+        bullets_.push_back(new ProjectileGameObject(glm::vec3(0.0f), assets_.sprite, assets_.sprite_shader, 0));
+        bullets_.back()->Load(snapshot);
+        particle_game_objects_.push_back(RestoreParticles(snapshot, assets_.bullet_particles, bullets_.back()));
+    }
+
+    snapshot.Read(count);
+    for (int i = 0; i < count; i++)
+    {
+        spikes_.push_back(new ProjectileGameObject(glm::vec3(0.0f), assets_.sprite, assets_.sprite_shader, 0));
+        spikes_.back()->Load(snapshot);
+    }
+
+    snapshot.Read(count);
+    for (int i = 0; i < count; i++)
+    {
+        GameObject *anchor = RestoreObject(snapshot);
+        explosions_.push_back(RestoreParticles(snapshot, assets_.explosion_particles, anchor));
+    }
+
+    snapshot.Read(count);
+    for (int i = 0; i < count; i++)
+    {
+        GameObject *anchor = RestoreObject(snapshot);
+        emitters_.push_back(RestoreParticles(snapshot, assets_.explosion_particles, anchor));
+    }
+
+    snapshot.Read(count);
+    for (int i = 0; i < count; i++)
+    {
+        tentacles_.push_back(RestoreObject(snapshot));
+    }
+
+    world_.Load(snapshot);
+    flow_field_.Load(snapshot);
+    ai_lod_.Load(snapshot);
+    kraken_ik_.Load(snapshot);
+    kraken_bvh_.Load(snapshot);
+
+    // every object is back, so the wheel can put their timers back in the slots they were in
+    GetTimerEntries(timer_entries_);
+    timer_wheel_.Load(snapshot, timer_entries_);
+
+    audio_events_.clear();
+}
+
+
+void Simulation::GetTimerEntries(std::vector<TimerEntry*> &entries)
+{
+    timers_.clear();
+    timers_.push_back(enemy_timer_);
+    timers_.push_back(buff_timer_);
+    for (int i = 0; i < num_players_; i++)
+    {
+        timers_.push_back(bullet_timers_[i]);
+        players_[i]->GetTimers(timers_);
+    }
+
+    for (int i = 0; i < enemy_game_objects_.size(); i++)
+    {
+        enemy_game_objects_[i]->GetTimers(timers_);
+    }
+    for (int i = 0; i < collectible_game_objects_.size(); i++)
+    {
+        collectible_game_objects_[i]->GetTimers(timers_);
+    }
+    for (int i = 0; i < bullets_.size(); i++)
+    {
+        bullets_[i]->GetTimers(timers_);
+        particle_game_objects_[i]->GetTimers(timers_);
+    }
+    for (int i = 0; i < spikes_.size(); i++)
+    {
+        spikes_[i]->GetTimers(timers_);
+    }
+    for (int i = 0; i < explosions_.size(); i++)
+    {
+        GameObject* anchor;
+        explosions_[i]->GetParent(&anchor);
+        anchor->GetTimers(timers_);
+        explosions_[i]->GetTimers(timers_);
+    }
+    for (int i = 0; i < emitters_.size(); i++)
+    {
+        GameObject* anchor;
+        emitters_[i]->GetParent(&anchor);
+        anchor->GetTimers(timers_);
+        emitters_[i]->GetTimers(timers_);
+    }
+    for (int i = 0; i < tentacles_.size(); i++)
+    {
+        tentacles_[i]->GetTimers(timers_);
+    }
+
+    entries.clear();
+    for (int i = 0; i < timers_.size(); i++)
+    {
+        entries.push_back(timers_[i]->GetEntry());
+    }
+}
+
+
+GameObject *Simulation::RestoreObject(Snapshot &snapshot)
+{
+    GameObject *object = new GameObject(glm::vec3(0.0f), assets_.sprite, assets_.sprite_shader, 0);
+    object->Load(snapshot);
+    return object;
+}
+
+
+GameObject *Simulation::RestoreParticles(Snapshot &snapshot, Geometry *geometry, GameObject *parent)
+{
+    GameObject *particles = new ParticleSystem(glm::vec3(0.0f), geometry, assets_.particle_shader, 0, parent);
+    particles->Load(snapshot);
+    return particles;
+}
+
+
+void Simulation::HandleControls(int player, uint8_t keys, double delta_time)
+{
+    PROFILE_ZONE("Simulation::HandleControls");
+    ALLOC_SCOPE(ALLOC_TAG_SIMULATION);
+
+    if (boss_ && enemy_game_objects_.size() == 0) 
+    {
+        return;
+    }
+
+    if (player_health_ == 0 || player < 0 || player >= num_players_) return;
+
+    // the bullets and spikes fired below get their timers from our wheel
+    TimerWheelScope wheel_scope(&timer_wheel_);
+
+    PlayerGameObject *ship = players_[player];
+    Timer *bullet_timer = bullet_timers_[player];
+
+    // Get current position and angle
+    glm::vec3 curpos = ship->GetPosition();
+    float angle = ship->GetRotation();
+    // Compute current bearing direction
+    glm::vec3 dir = ship->GetBearing();
+    // Adjust motion increment and angle increment 
+    // if translation or rotation is too slow
+    float speed = delta_time*1000.0;
+    float motion_increment = 0.001*speed;
+    float angle_increment = (glm::pi<float>() / 1800.0f)*speed;
+
+    // Check for player input and make changes accordingly
+
+    // add to a velocity based on the keys being pressed
+
+    if (keys & INPUT_KEY_W) {
+        //curpos += ;
+        ship->SetVelocity((motion_increment/5)*dir);
+    }
+    if (keys & INPUT_KEY_S) {
+        //curpos -= motion_increment*dir;
+        ship->SetVelocity(-(motion_increment/5)*dir);
+    }
+    if (keys & INPUT_KEY_D) {
+        angle -= angle_increment;
+    }
+    if (keys & INPUT_KEY_A) {
+        angle += angle_increment;
+    }
+    if (keys & INPUT_KEY_Q) {
+        //curpos += motion_increment*;
+        ship->SetVelocity(-(motion_increment/5)*ship->GetRight());
+    }
+    if (keys & INPUT_KEY_E) {
+        //curpos -= motion_increment*ship->GetRight();
+        ship->SetVelocity((motion_increment/5)*ship->GetRight());
+    }
+    if (keys & INPUT_KEY_SPACE)
+    {
+        if (bullet_timer->Finished() != 0)
+        {
+            AddBullet(glm::vec3(ship->GetPosition().x, ship->GetPosition().y, 0.0f), 0.03f * ship->GetBearing());
+            bullet_timer->Start(1);
+        }
+    }
+    if (keys & INPUT_KEY_LEFT_SHIFT)
+    {
+        if (bullet_timer->Finished() != 0)
+        {
+            spikes_.push_back(new ProjectileGameObject(glm::vec3(ship->GetPosition().x, ship->GetPosition().y, 0.0f), assets_.sprite, assets_.sprite_shader, assets_.tex[20]));
+            spikes_.back()->SetScale(.5);
+            spikes_.back()->SetVelocity(-0.001f * ship->GetBearing());
+            //spikes_.back()->SetRotation( ship->GetRotation() - (glm::pi<float>() / 2.0f) );
+            spikes_.back()->SetTimer(2);
+            bullet_timer->Start(3);
+        }
+    }
+
+    
+    ship->SetRotation(angle);
+}
+
+
+void Simulation::Update(double delta_time)
+{
+    PROFILE_ZONE("Simulation::Update");
+    ALLOC_SCOPE(ALLOC_TAG_SIMULATION);
+
+    // the timers made below go on our wheel, whichever simulation ran last
+    TimerWheelScope wheel_scope(&timer_wheel_);
+
+    // Update time
+    current_time_ += delta_time;
+
+    // move the timer wheel along, this fires every timer that ran out during the frame
+    timer_wheel_.Advance(delta_time);
+
+    {
+        PROFILE_ZONE("Explosions");
+
+        // Update all other game objects (for now just explosions)
+        for (int i = 0; i < explosions_.size(); i++) {
+            // Get the current game object
+            GameObject* current_game_object = explosions_[i];
+
+            // Update the current game object
+            //std::cout << i << std::endl;
+            current_game_object->Update(delta_time);
+
+            //std::cout << i << " is inactive" << std::endl;
+            //if the explosion is active and the timer is finished then we can proceed in removing the object, otherwise we continue on as normal.
+            if (current_game_object->GetTimer() == 1)
+            {
+                // we added a temporary game object as the parent for the explosions so were gonna get rid of the memory we used before deleting the expolsion
+                GameObject* temp;
+                explosions_[i]->GetParent(&temp);
+                delete temp;
+
+                //std::cout << "another explosion fades away..." << std::endl;
+                // free the space from the object list and remove it
+                delete explosions_[i];
+                explosions_.erase(explosions_.begin()+i);
+
+                num_enemies_ --;
+            }
+           
+        }
+    }
+
+    // before the early out below so the tentacles go down with the kraken
+    UpdateKraken();
+
+    if (boss_ && enemy_game_objects_.size() == 0) return;
+
+    // if the player is dead then we want to start moving towards the shut down state
+    if (player_health_ == 0)
+    {
+        // if the explosion vector is empty it means that they have all resolved and we can shut the game down now
+        if (explosions_.size() == 0)
+        {
+            // the game starts over once it sees were over
+            over_ = true;
+        }/**/ 
+        else
+        {
+            for (int p = 0; p < num_players_; p++)
+            {
+                players_[p]->SetTexture(assets_.tex[0]);
+            }
+        }   
+    }
+    
+    if (score_ >= 25 && !boss_)
+    {
+        NewEnemy(players_[0]->GetPosition() + glm::vec3(6.0f,0.0f,0.0f), assets_.tex[22], 15, 1);
+
+        // the tentacles grow out of it on the next UpdateKraken
+        enemy_game_objects_.back()->SetBoss();
+
+        boss_ = true;
+    }
+
+    // handling enemy spawning (same as the buff spawner below)
+    // the timer spawns the enemy itself when it runs out, we just need to keep it going
+    if (num_enemies_ < spawn_director_.GetDifficulty(score_).max_enemies && player_health_ > 0 && score_ < 25)
+    {
+        if (enemy_timer_->Finished() != 0)
+        {
+            enemy_timer_->Start(spawn_director_.GetDifficulty(score_).spawn_interval);
+        }
+    }
+
+    //handling buff spawning, for now well make sure that we hover around 3 buffs at once
+    if (num_buffs_ < 5 && player_health_ > 0)
+    {
+        // if the timers done (or was never started) we start the countdown to the next buff
+        if (buff_timer_->Finished() != 0)
+        {
+            buff_timer_->Start(5);
+        }
+    }
+    
+    // update the player since we not check for player player collision
+    if (player_health_ > 0) 
+    {
+        for (int p = 0; p < num_players_; p++)
+        {
+            players_[p]->Update(delta_time);
+        }
+
+        // keep the part of the level around the player in play
+        StreamChunks();
+    }
+
+    {
+        PROFILE_ZONE("Particles");
+
+        //
+        for (int i = 0; i < particle_game_objects_.size(); i++)
+        {
+            particle_game_objects_[i]->Update(delta_time);
+        }
+
+        for (int i = 0; i < child_game_objects_.size(); i++)
+        {
+            child_game_objects_[i]->Update(delta_time);
+        }
+
+        for (int i = 0; i < emitters_.size(); i++)
+        {
+            emitters_[i]->Update(delta_time);
+        }
+    }
+
+    // one pass over the grid around the players gives every intercepting enemy its direction to the nearest of them
+    if (num_intercepting_ > 0 && player_health_ > 0)
+    {
+        PROFILE_ZONE("FlowField::Build");
+        glm::vec3 goals[SIM_MAX_PLAYERS];
+        for (int p = 0; p < num_players_; p++)
+        {
+            goals[p] = players_[p]->GetPosition();
+        }
+        flow_field_.Build(goals, num_players_);
+    }
+    num_intercepting_ = 0;
+
+    ai_lod_.BeginFrame();
+
+    {
+        PROFILE_ZONE("Enemies");
+
+        // update all enemy game objects
+        for (int i = 0; i < enemy_game_objects_.size(); i++) 
+        {
+            // Get the current game object
+            EnemyGameObject* current_game_object = enemy_game_objects_[i];
+
+            // intercepting enemies follow the flow field instead of heading straight at the player
+            if (current_game_object->GetState() == INTERCEPTING)
+            {
+                glm::vec3 heading;
+                if (flow_field_.Sample(current_game_object->GetPosition(), heading))
+                {
+                    current_game_object->SetHeading(heading);
+                }
+                flow_field_.AddAgent(current_game_object->GetPosition());
+                num_intercepting_++;
+            }
+
+            // every enemy goes after whichever player is closest
+            PlayerGameObject *player = NearestPlayer(current_game_object->GetPosition());
+
+            // far away enemies only get a full update every few frames, with the time they missed added on
+            float lod_distance = glm::length(current_game_object->GetPosition() - player->GetPosition());
+            if (ai_lod_.ShouldUpdate(current_game_object->GetLodSlot(), lod_distance))
+            {
+                // Update the current game object
+                current_game_object->Update(delta_time + current_game_object->TakeSkippedTime());
+            }
+            else
+            {
+                current_game_object->SkipUpdate(delta_time);
+            }
+        
+
+            float distance = glm::length(current_game_object->GetPosition() - player->GetPosition());
+
+            // check if we get close to an enemy, if so we wanna set it to patrolling, give it its first tagert
+            if (distance < 1.8f && player_health_ > 0)
+            {
+                // if we get close enough we wanna set it to patrolling and if the object is patrolling we wanna
+                if (enemy_game_objects_[i]->GetState() == 0)
+                {
+                    enemy_game_objects_[i]->SetTarget(player->GetPosition());
+                }
+            }/**/
+
+            // if the entity is intercepting we wanna update the target if its timer is done
+            if ( enemy_game_objects_[i]->GetState() == 1 && enemy_game_objects_[i]->GetTimer() == 1)
+            {
+                enemy_game_objects_[i]->SetTarget(player->GetPosition());
+            }
+
+            // If distance is below a threshold, we have a collision
+            PlayerGameObject *hit = NULL;
+            if (player_health_ > 0 && enemy_game_objects_[i]->GetHitTimer() != 0 && (hit = PlayerContact(enemy_game_objects_[i], 0.8f)))
+            {
+            
+                //std::cout << "Contact!" << std::endl;
+            
+                //here were just getting the position of the object we wanna blow up
+                glm::vec3 pos = current_game_object->GetPosition();
+
+                if (enemy_game_objects_[i]->GetHealth() == 1)
+                {
+                    int r = random_.Get(RANDOM_DROP).NextInt(5);
+                    if ( r == 2 )
+                    {
+                        collectible_game_objects_.push_back(new CollectibleGameObject(pos, assets_.sprite, assets_.sprite_shader, assets_.tex[2], 1) );
+                    }
+                    else if (r == 1)
+                    {
+                        collectible_game_objects_.push_back(new CollectibleGameObject(pos, assets_.sprite, assets_.sprite_shader, assets_.tex[21], 2));
+                    }
+                
+
+                    // we them blow it up metaphorically by deleting it (dont wanna waste space)
+                    world_.MarkCleared(current_game_object->GetChunk(), current_game_object->GetChunkId());
+                    delete current_game_object;
+                    enemy_game_objects_.erase(enemy_game_objects_.begin() + i);
+
+                    // we then replace the object with an explosion, set the explosion to false so that we dont accidentally blow up the explosion (that would be weird), and set a timer for how long itll stay on screen
+                    //pos
+                    GameObject *particles = new ParticleSystem(glm::vec3(0,0,0), assets_.explosion_particles, assets_.particle_shader, assets_.tex[4], new GameObject(pos, assets_.sprite, assets_.sprite_shader, assets_.tex[4]));
+                    particles->SetScale(0.2);
+                    particles->SetTimer(1.0f);
+                    explosions_.push_back(particles); 
+
+                    // and next were gonna play a nom sound cause he ate that thang
+                    audio_events_.push_back(SimAudioEvent(SIM_SOUND_EXPLOSION, pos));
+
+                    score_++;
+                }
+                else
+                {
+                    enemy_game_objects_[i]->Hit();
+                    if (hit->GetTimer() == 0) enemy_game_objects_[i]->Hit();
+                    enemy_game_objects_[i]->SetHitTimer();
+                }
+
+                // player hit another object so were gonna take 1 health away
+                hit->SetTexture(assets_.tex[0]);
+                if (!invulnerable_) player_health_ -= 1;
+            
+                // same as above but for the players if we hit 3 enemies, the health is shared so every ship goes down
+                if (player_health_ == 0)
+                {
+                    for (int p = 0; p < num_players_; p++)
+                    {
+                        glm::vec3 pos = players_[p]->GetPosition();
+
+                        // the player stays around (but is no longer updated or drawn) so the rest of the tick can still ask where it was
+
+                        //pos
+                        GameObject *particles = new ParticleSystem(glm::vec3(0,0,0), assets_.explosion_particles, assets_.particle_shader, assets_.tex[4], new GameObject(pos, assets_.sprite, assets_.sprite_shader, assets_.tex[4]));
+                        particles->SetScale(0.2);
+                        particles->SetTimer(1.0f);
+                        explosions_.push_back(particles); 
+                    }
+                }
+            
+                // restart from the beginning since we shrunk the enemy vector by 1 after the collision
+                i--;
+
+                if (i < 0) goto endloop;
+
+                continue;
+            }
+        }
+    }
+
+    {
+        PROFILE_ZONE("Collectibles");
+
+        // update all collectible game objects
+        for (int i = 0; i < collectible_game_objects_.size(); i++) 
+        {
+            // Get the current game object
+            CollectibleGameObject* current_game_object = collectible_game_objects_[i];
+
+            // Update the current game object
+            //std::cout << i << std::endl;
+            current_game_object->Update(delta_time);
+
+
+            // check if we contacted a collectible
+            if (player_health_ > 0 && PlayerTouching(current_game_object, 0.6f))
+            {
+                // were gonna get rid of the object first since we dont need it anymore
+
+                if (collectible_game_objects_[i]->GetType() == 0)
+                {
+                    // were gonna change the values for 
+                    num_buffs_ --;
+                    buff_count_++;
+
+                    // if the number of buffs weve collected is greater than or equal to 5 were gonna go into gold mode
+                    if (buff_count_ >= 5)
+                    {
+                        // set the timer on the power up, everyone gets it
+                        for (int p = 0; p < num_players_; p++)
+                        {
+                            players_[p]->SetTimer(10.0f);
+                        }
+                        // reset the buff count so we dont chain power ups
+                        buff_count_ = 0;
+                    }
+                }
+                else if (collectible_game_objects_[i]->GetType() == 1 && player_health_ < 3)
+                {
+                    player_health_++;
+                }
+                else if (collectible_game_objects_[i]->GetType() == 2)
+                {
+                    score_++;
+                }
+
+                world_.MarkCleared(current_game_object->GetChunk(), current_game_object->GetChunkId());
+                delete current_game_object;
+                collectible_game_objects_.erase(collectible_game_objects_.begin()+i);
+                // were gonna move back to the same i since everything after the object we just deleted shifted down one (i+1 is now just i) and we wouldnt wanna miss any collision
+                i--;
+            }
+        }
+    }
+
+    {
+        PROFILE_ZONE("Bullets");
+
+        for (int i = 0; i < bullets_.size(); i++)
+        {
+            bullets_[i]->Update(delta_time);
+
+            // a bullet goes when it hits something or runs out of time, the rest of the bullets still get their turn
+            bool hit = false;
+            for (int j = 0; j < enemy_game_objects_.size(); j++)
+            {
+                // does the step the bullet took this tick run through the enemy
+                if (EnemyStruck(enemy_game_objects_[j], bullets_[i]->GetPosition(), bullets_[i]->GetVelocity()))
+                {
+                    if (enemy_game_objects_[j]->GetHealth() <= 1)
+                    {
+                        int r = random_.Get(RANDOM_DROP).NextInt(5);
+                        if ( r == 2 )
+                        {
+                            collectible_game_objects_.push_back(new CollectibleGameObject(enemy_game_objects_[j]->GetPosition(), assets_.sprite, assets_.sprite_shader, assets_.tex[2], 1));
+                        }
+                        else if (r == 1)
+                        {
+                            collectible_game_objects_.push_back(new CollectibleGameObject(enemy_game_objects_[j]->GetPosition(), assets_.sprite, assets_.sprite_shader, assets_.tex[21], 2));
+                        }
+
+                        //enemy_game_objects_[j]->GetPosition()
+                        GameObject *particles = new ParticleSystem(glm::vec3(0,0,0), assets_.explosion_particles, assets_.particle_shader, assets_.tex[4], new GameObject(enemy_game_objects_[j]->GetPosition(), assets_.sprite, assets_.sprite_shader, assets_.tex[4]));
+                        particles->SetScale(0.2);
+                        particles->SetTimer(1.0f);
+                        explosions_.push_back(particles); 
+
+                        world_.MarkCleared(enemy_game_objects_[j]->GetChunk(), enemy_game_objects_[j]->GetChunkId());
+                        delete enemy_game_objects_[j];
+                        enemy_game_objects_.erase(enemy_game_objects_.begin()+j);
+
+                        score_++;
+                    }
+                    else
+                    {
+                        enemy_game_objects_[j]->Hit();
+                        if (players_[0]->GetTimer() == 0) enemy_game_objects_[j]->Hit();
+                    }
+            
+
+                    audio_events_.push_back(SimAudioEvent(SIM_SOUND_EXPLOSION, bullets_[i]->GetPosition()));
+
+                    hit = true;
+                    break;
+                }
+            }
+
+            if (hit || bullets_[i]->GetTimer() == 2)
+            {
+                delete bullets_[i];
+                bullets_.erase(bullets_.begin()+i);
+
+                // the bullets trail goes with it
+                delete particle_game_objects_[i];
+                particle_game_objects_.erase(particle_game_objects_.begin()+i);
+
+                i--;
+            }
+        }
+    }
+
+    {
+        PROFILE_ZONE("Spikes");
+
+        for (int i = 0; i < spikes_.size(); i++)
+        {
+            spikes_[i]->Update(delta_time);
+
+            /**/
+
+            for (int j = 0; j < enemy_game_objects_.size(); j++)
+            {
+                // If distance is below a threshold, we have a collision
+                if (EnemyContact(enemy_game_objects_[j], spikes_[i], 0.8f))
+                {
+                    if (enemy_game_objects_[j]->GetHealth() <= 1)
+                    {
+                        int r = random_.Get(RANDOM_DROP).NextInt(5);
+                        if ( r == 2 )
+                        {
+                            collectible_game_objects_.push_back( new CollectibleGameObject(enemy_game_objects_[j]->GetPosition(), assets_.sprite, assets_.sprite_shader, assets_.tex[2], 1) );
+                        }
+                        else if (r == 1)
+                        {
+                            collectible_game_objects_.push_back(new CollectibleGameObject(enemy_game_objects_[j]->GetPosition(), assets_.sprite, assets_.sprite_shader, assets_.tex[21], 2));
+                        }
+
+                        //enemy_game_objects_[j]->GetPosition()
+                        GameObject *particles = new ParticleSystem(glm::vec3(0,0,0), assets_.explosion_particles, assets_.particle_shader, assets_.tex[4], new GameObject(enemy_game_objects_[j]->GetPosition(), assets_.sprite, assets_.sprite_shader, assets_.tex[4]));
+                        particles->SetScale(0.2);
+                        particles->SetTimer(1.0f);
+                        explosions_.push_back(particles); 
+
+                        world_.MarkCleared(enemy_game_objects_[j]->GetChunk(), enemy_game_objects_[j]->GetChunkId());
+                        delete enemy_game_objects_[j];
+                        enemy_game_objects_.erase(enemy_game_objects_.begin()+j);
+
+                        score_++;
+                    }
+                    else
+                    {
+                        enemy_game_objects_[j]->Hit();
+                        if (players_[0]->GetTimer() == 0) enemy_game_objects_[j]->Hit();
+                    }
+                
+                    audio_events_.push_back(SimAudioEvent(SIM_SOUND_EXPLOSION, spikes_[i]->GetPosition()));
+
+                    delete spikes_[i];
+                    spikes_.erase(spikes_.begin()+i);
+
+                    i--;
+
+                    if (i < 0) goto endloop;
+                    break;
+                }
+            
+            }
+
+            if ( spikes_[i]->GetTimer() == 2 )
+            {
+                delete spikes_[i];
+                spikes_.erase(spikes_.begin()+i);
+
+                i--;
+            }
+        }
+    }
+
+    endloop:
+    {
+        if (boss_ && enemy_game_objects_.size() == 0) 
+        {
+            for (int p = 0; p < num_players_; p++)
+            {
+                players_[p]->SetVelocity(glm::vec3(0,0,0));
+            }
+        }
+        return;
+    }
+        
+}
+
+
+void Simulation::AddEnemy(int type, const glm::vec3 &position)
+{
+    // these can be called from outside Update, so the new objects timers have to be pointed at our wheel here too
+    TimerWheelScope wheel_scope(&timer_wheel_);
+
+    if (type == SPAWN_MONSTER)
+    {
+        NewEnemy(position, assets_.tex[5], 3, 1);
+    }
+    else
+    {
+        NewEnemy(position, assets_.tex[1]);
+    }
+    num_enemies_ ++;
+}
+
+
+void Simulation::NewEnemy(const glm::vec3 &position, GLuint texture, int health, int state)
+{
+    enemy_game_objects_.push_back(new EnemyGameObject(position, assets_.sprite, assets_.sprite_shader, texture, health, state));
+
+    // spread enemies evenly over the AI level of detail round robin
+    enemy_game_objects_.back()->SetLodSlot(next_lod_slot_++);
+}
+
+
+PlayerGameObject *Simulation::NearestPlayer(const glm::vec3 &position) const
+{
+    PlayerGameObject *nearest = players_[0];
+    float best = glm::length(position - nearest->GetPosition());
+    for (int p = 1; p < num_players_; p++)
+    {
+        float distance = glm::length(position - players_[p]->GetPosition());
+        if (distance < best)
+        {
+            best = distance;
+            nearest = players_[p];
+        }
+    }
+    return nearest;
+}
+
+
+PlayerGameObject *Simulation::PlayerContact(EnemyGameObject *enemy, float distance)
+{
+    for (int p = 0; p < num_players_; p++)
+    {
+        if (EnemyContact(enemy, players_[p], distance)) return players_[p];
+    }
+    return NULL;
+}
+
+
+PlayerGameObject *Simulation::PlayerTouching(GameObject *object, float distance)
+{
+    for (int p = 0; p < num_players_; p++)
+    {
+        if (Touching(players_[p], object, distance)) return players_[p];
+    }
+    return NULL;
+}
+
+
+void Simulation::AddCollectible(int type, const glm::vec3 &position)
+{
+    TimerWheelScope wheel_scope(&timer_wheel_);
+
+    // barrels count towards the buff limit, health and gold are drops
+    GLuint texture = assets_.tex[8];
+    if (type == 1) texture = assets_.tex[2];
+    else if (type == 2) texture = assets_.tex[21];
+
+    collectible_game_objects_.push_back(new CollectibleGameObject(position, assets_.sprite, assets_.sprite_shader, texture, type));
+    if (type == 0)
+    {
+        collectible_game_objects_.back()->SetScale(0.5);
+        num_buffs_ ++;
+    }
+}
+
+
+void Simulation::SpawnWave(void)
+{
+    // let the director pick the wave based on how well the player is doing
+    std::vector<int> wave;
+    spawn_director_.PlanWave(score_, num_enemies_, wave);
+    if (wave.empty()) return;
+
+    // new enemies keep clear of the ones already out there and of any islands
+    spawn_blockers_.clear();
+    for (int i = 0; i < enemy_game_objects_.size(); i++)
+    {
+        glm::vec3 p = enemy_game_objects_[i]->GetPosition();
+        spawn_blockers_.push_back(glm::vec3(p.x, p.y, 0.0f));
+    }
+    world_.GetActiveIslands(spawn_blockers_);
+
+    for (int i = 0; i < wave.size(); i++)
+    {
+        glm::vec3 position;
+
+        // if the sea around the player is too crowded we just skip this one
+        if (!spawn_director_.FindSpawn(SPAWN_TABLE_ENEMY, players_[0]->GetPosition(), spawn_blockers_, 0.8f, position)) continue;
+
+        AddEnemy(wave[i], position);
+        spawn_blockers_.push_back(glm::vec3(position.x, position.y, 0.0f));
+    }
+}
+
+
+void Simulation::SpawnBuff(void)
+{
+    // buffs keep clear of the other collectibles and any islands
+    spawn_blockers_.clear();
+    for (int i = 0; i < collectible_game_objects_.size(); i++)
+    {
+        glm::vec3 p = collectible_game_objects_[i]->GetPosition();
+        spawn_blockers_.push_back(glm::vec3(p.x, p.y, 0.0f));
+    }
+    world_.GetActiveIslands(spawn_blockers_);
+
+    glm::vec3 position;
+    if (spawn_director_.FindSpawn(SPAWN_TABLE_BUFF, players_[0]->GetPosition(), spawn_blockers_, 0.6f, position))
+    {
+        // add a new entity to the list and increment the counter
+        collectible_game_objects_.push_back( new CollectibleGameObject(position, assets_.sprite, assets_.sprite_shader, assets_.tex[8]));
+        collectible_game_objects_.back()->SetScale(0.5);
+        num_buffs_ ++;
+    }
+}
+
+
+void Simulation::StreamChunks(void)
+{
+    PROFILE_ZONE("StreamChunks");
+
+    std::vector<ChunkSpawn> activated;
+    std::vector<int> deactivated;
+    world_.Update(players_[0]->GetPosition(), activated, deactivated);
+
+    if (activated.empty() && deactivated.empty()) return;
+
+    // remove everything that came from a chunk we left behind
+    for (int c = 0; c < deactivated.size(); c++)
+    {
+        for (int i = 0; i < enemy_game_objects_.size(); i++)
+        {
+            if (enemy_game_objects_[i]->GetChunk() == deactivated[c])
+            {
+                delete enemy_game_objects_[i];
+                enemy_game_objects_.erase(enemy_game_objects_.begin() + i);
+                num_enemies_ --;
+                i--;
+            }
+        }
+
+        for (int i = 0; i < collectible_game_objects_.size(); i++)
+        {
+            if (collectible_game_objects_[i]->GetChunk() == deactivated[c])
+            {
+                if (collectible_game_objects_[i]->GetType() == 0) num_buffs_ --;
+                delete collectible_game_objects_[i];
+                collectible_game_objects_.erase(collectible_game_objects_.begin() + i);
+                i--;
+            }
+        }
+    }
+
+    // and bring in whatever the new chunks hold
+    for (int i = 0; i < activated.size(); i++)
+    {
+        const ChunkSpawn &spawn = activated[i];
+
+        if (spawn.kind == CHUNK_ENEMY)
+        {
+            if (spawn.type == 1) NewEnemy(spawn.position, assets_.tex[5], 3, 1);
+            else NewEnemy(spawn.position, assets_.tex[1]);
+            enemy_game_objects_.back()->SetChunk(spawn.chunk, spawn.id);
+            num_enemies_ ++;
+        }
+        else if (spawn.kind == CHUNK_COLLECTIBLE)
+        {
+            // same textures as the random spawns and the drops
+            AddCollectible(spawn.type, spawn.position);
+            collectible_game_objects_.back()->SetChunk(spawn.chunk, spawn.id);
+        }
+    }
+
+    // the islands in play block the enemies paths
+    std::vector<glm::vec3> islands;
+    world_.GetActiveIslands(islands);
+    flow_field_.ClearObstacles();
+    for (int i = 0; i < islands.size(); i++)
+    {
+        flow_field_.AddObstacle(glm::vec3(islands[i].x, islands[i].y, 0.0f), islands[i].z);
+    }
+}
+
+
+void Simulation::UpdateKraken(void)
+{
+    PROFILE_ZONE("Kraken IK");
+
+    EnemyGameObject *kraken = NULL;
+    if (boss_)
+    {
+        for (int i = 0; i < enemy_game_objects_.size(); i++)
+        {
+            if (enemy_game_objects_[i]->IsBoss())
+            {
+                kraken = enemy_game_objects_[i];
+                break;
+            }
+        }
+    }
+
+    // the kraken sank (or never came), nothing left to hold the tentacles up
+    if (!kraken)
+    {
+        for (int i = 0; i < tentacles_.size(); i++)
+        {
+            delete tentacles_[i];
+        }
+        tentacles_.clear();
+        kraken_ik_.Clear();
+        kraken_bvh_.Clear();
+        return;
+    }
+
+    glm::vec3 head = kraken->GetPosition();
+    float pi = glm::pi<float>();
+
+    // first time we see it, lay the arms out straight around the head
+    if (kraken_ik_.GetNumChains() == 0)
+    {
+        kraken_bvh_.AddCapsule(glm::vec2(head.x, head.y), glm::vec2(head.x, head.y), KRAKEN_HEAD_RADIUS);
+
+        for (int a = 0; a < KRAKEN_ARMS; a++)
+        {
+            float angle = 2.0f * pi * a / KRAKEN_ARMS;
+            glm::vec2 out(cos(angle), sin(angle));
+            kraken_ik_.AddChain(glm::vec2(head.x, head.y) + out * 0.35f, out, KRAKEN_SEGMENTS, KRAKEN_SEGMENT_LENGTH);
+
+            for (int j = 0; j < KRAKEN_SEGMENTS; j++)
+            {
+                // the last segment of every arm is the tentacle tip
+                GLuint texture = j == KRAKEN_SEGMENTS - 1 ? assets_.tex[24] : assets_.tex[23];
+                tentacles_.push_back(new GameObject(head, assets_.sprite, assets_.sprite_shader, texture));
+                tentacles_.back()->SetScale(KRAKEN_SEGMENT_LENGTH * 1.2f);
+                kraken_bvh_.AddCapsule(kraken_ik_.GetJoint(a, j), kraken_ik_.GetJoint(a, j + 1), KRAKEN_LINK_RADIUS);
+            }
+        }
+
+        kraken_bvh_.Build();
+    }
+
+    // the arms facing the nearest player grab for it if it is close enough, the rest sway about
+    // grabbing needs a tight pose so it gets more passes, a swaying arm looks fine a little behind
+    glm::vec3 player = NearestPlayer(head)->GetPosition();
+    float player_angle = atan2(player.y - head.y, player.x - head.x);
+    for (int a = 0; a < KRAKEN_ARMS; a++)
+    {
+        float angle = 2.0f * pi * a / KRAKEN_ARMS;
+        glm::vec2 out(cos(angle), sin(angle));
+        glm::vec2 base = glm::vec2(head.x, head.y) + out * 0.35f;
+        kraken_ik_.SetBase(a, base);
+
+        float facing = fabs(remainder(player_angle - angle, 2.0f * pi));
+        float distance = glm::length(glm::vec2(player.x, player.y) - base);
+        if (player_health_ > 0 && facing < pi / KRAKEN_ARMS * 1.5f && distance < kraken_ik_.GetReach(a) * 1.25f)
+        {
+            kraken_ik_.SetTarget(a, glm::vec2(player.x, player.y));
+            kraken_ik_.SetBudget(a, KRAKEN_GRAB_BUDGET);
+        }
+        else
+        {
+            float sway = angle + 0.5f * sin(2.0f * current_time_ + a);
+            kraken_ik_.SetTarget(a, base + glm::vec2(cos(sway), sin(sway)) * kraken_ik_.GetReach(a) * 0.75f);
+            kraken_ik_.SetBudget(a, KRAKEN_IDLE_BUDGET);
+        }
+    }
+
+    kraken_ik_.Solve();
+
+    // every segment sits halfway along its bone and points down it
+    for (int a = 0; a < KRAKEN_ARMS; a++)
+    {
+        for (int j = 0; j < KRAKEN_SEGMENTS; j++)
+        {
+            glm::vec2 from = kraken_ik_.GetJoint(a, j);
+            glm::vec2 to = kraken_ik_.GetJoint(a, j + 1);
+            GameObject *segment = tentacles_[a * KRAKEN_SEGMENTS + j];
+            segment->SetPosition(glm::vec3((from + to) * 0.5f, 0.0f));
+            segment->SetRotation(atan2(to.y - from.y, to.x - from.x) - pi / 2.0f);
+            kraken_bvh_.SetCapsule(1 + a * KRAKEN_SEGMENTS + j, from, to);
+        }
+    }
+
+    kraken_bvh_.SetCapsule(0, glm::vec2(head.x, head.y), glm::vec2(head.x, head.y));
+    kraken_bvh_.Refit();
+}
+
+
+bool Simulation::Touching(GameObject *a, GameObject *b, float distance)
+{
+    if (assets_.shapes && assets_.shapes->Has(*a, *b))
+    {
+        return assets_.shapes->Overlap(*a, *b);
+    }
+
+    return glm::length(a->GetPosition() - b->GetPosition()) < distance;
+}
+
+
+bool Simulation::EnemyContact(EnemyGameObject *enemy, GameObject *other, float distance)
+{
+    if (enemy->IsBoss() && kraken_bvh_.IsBuilt())
+    {
+        glm::vec3 centre = other->GetPosition();
+        return kraken_bvh_.OverlapCircle(glm::vec2(centre.x, centre.y), KRAKEN_CONTACT_RADIUS) >= 0;
+    }
+
+    return Touching(enemy, other, distance);
+}
+
+
+bool Simulation::EnemyStruck(EnemyGameObject *enemy, const glm::vec3 &start, const glm::vec3 &step) const
+{
+    if (enemy->IsBoss() && kraken_bvh_.IsBuilt())
+    {
+        return kraken_bvh_.Raycast(glm::vec2(start.x, start.y), glm::vec2(step.x, step.y)) >= 0;
+    }
+
+    return SegmentInsideCircle(start, step, enemy->GetPosition(), 0.1f);
+}
+
+} // namespace game
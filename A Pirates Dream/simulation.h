@@ -0,0 +1,316 @@
+#ifndef SIMULATION_H_
+#define SIMULATION_H_
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <vector>
+#include <string>
+#include <stdint.h>
+
+#include "shader.h"
+#include "geometry.h"
+#include "game_object.h"
+#include "player_game_object.h"
+#include "enemy_game_object.h"
+#include "collectible_game_object.h"
+#include "projectile_game_object.h"
+#include "child_game_object.h"
+#include "timer.h"
+#include "timer_wheel.h"
+#include "flow_field.h"
+#include "ai_lod.h"
+#include "chunked_world.h"
+#include "spawn_director.h"
+#include "random.h"
+#include "ik_solver.h"
+#include "capsule_bvh.h"
+#include "sprite_shape.h"
+#include "snapshot.h"
+
+// the number of textures the game loads, see Game::SetAllTextures
+#define SIM_NUM_TEXTURES 26
+
+// changes whenever what goes into a snapshot does, so an old one is turned away instead of read wrong
+#define SIM_SNAPSHOT_VERSION 2
+
+// how many ships can play at once (two in co-op, more on a server), they share the health, score and buffs
+#define SIM_MAX_PLAYERS 8
+
+// the sounds the simulation asks for, the game decides how to play them
+#define SIM_SOUND_EXPLOSION 0
+
+// the krakens tentacles, how many, how many segments each and how long a segment is
+#define KRAKEN_ARMS 8
+#define KRAKEN_SEGMENTS 6
+#define KRAKEN_SEGMENT_LENGTH 0.3f
+
+// how many solver passes a tentacle gets when it is grabbing for the player and when it is just swaying
+#define KRAKEN_GRAB_BUDGET 8
+#define KRAKEN_IDLE_BUDGET 2
+
+// the krakens collision pieces, its head and each tentacle link, and how close the player or a spike has to get to one
+#define KRAKEN_HEAD_RADIUS 0.4f
+#define KRAKEN_LINK_RADIUS 0.08f
+#define KRAKEN_CONTACT_RADIUS 0.3f
+
+namespace game {
+
+    // The geometry, shaders and textures the simulation hands to the objects it creates so the game can draw them
+    // A headless simulation leaves the geometry and shaders null and every texture 0, nothing it creates is ever drawn
+    // The shapes come from the textures alpha, without them (headless) the collisions fall back to distances
+    struct SimulationAssets {
+        Geometry *sprite;
+        Geometry *bullet_particles;
+        Geometry *explosion_particles;
+        Shader *sprite_shader;
+        Shader *particle_shader;
+        SpriteShapes *shapes;
+        GLuint tex[SIM_NUM_TEXTURES];
+
+        // the level file to stream in, the one in the resources directory if empty
+        std::string level;
+
+        SimulationAssets(void) : sprite(NULL), bullet_particles(NULL), explosion_particles(NULL), sprite_shader(NULL), particle_shader(NULL), shapes(NULL)
+        {
+            for (int i = 0; i < SIM_NUM_TEXTURES; i++) tex[i] = 0;
+        }
+    };
+
+    // A sound the simulation wants played and where it happened, so the nearest ones can win out
+    struct SimAudioEvent {
+        int sound;
+        glm::vec3 position;
+
+        SimAudioEvent(int sound, const glm::vec3 &position) : sound(sound), position(position) {}
+    };
+
+    /*
+        Simulation holds the state of the game world and everything that moves it forward: the entities,
+        their timers, the random streams, spawning, AI, collisions and pickups
+        It never touches the window, OpenGL or the audio, so it runs the same with or without graphics,
+        sounds it wants played are queued up as events for whoever owns the audio
+        Time only moves when it is told to and every random number comes from its own seeded streams, so any
+        number of them can run side by side, on one thread or many
+    */
+    class Simulation {
+
+        public:
+            // Constructor and destructor
+            Simulation(void);
+            ~Simulation();
+
+            // Seed every random stream, call before Setup()
+            void Seed(uint64_t seed);
+
+            // How many players there are (1 unless playing co-op), call before Setup()
+            void SetNumPlayers(int count);
+
+            // Set up the world (players, first enemies, level, spawn timers)
+            void Setup(const SimulationAssets &assets);
+
+            // Apply a tick of input to one of the players, keys is a mask of INPUT_KEY_ bits
+            void HandleControls(int player, uint8_t keys, double delta_time);
+            inline void HandleControls(uint8_t keys, double delta_time) { HandleControls(0, keys, delta_time); }
+
+            // Move the world forward by one tick
+            void Update(double delta_time);
+
+            // Add a single enemy of a SPAWN_ type, or a collectible of a given type, at a position
+            void AddEnemy(int type, const glm::vec3 &position);
+            void AddCollectible(int type, const glm::vec3 &position);
+
+            // Fire a bullet from a position, or add a particle emitter that keeps going until the simulation ends
+            void AddBullet(const glm::vec3 &position, glm::vec3 velocity);
+            void AddEmitter(const glm::vec3 &position);
+
+            // Move the sounds queued since the last call into events
+            void TakeAudioEvents(std::vector<SimAudioEvent> &events);
+
+            // Save everything the world is made of (the objects, timers, counters, random streams, level and AI) into a snapshot
+            void Save(Snapshot &snapshot);
+
+            // Put the world back the way it was when a snapshot was saved, call after Setup()
+            // Nothing is loaded, the objects are made again with the assets we were set up with, so this is quick enough
+            // to restart with or to go back to a checkpoint. Sounds that were still queued are dropped, and whether the
+            // player is invulnerable stays as it is. Throws if the snapshot is from another version or level, or
+            // has a different number of players
+            void Restore(Snapshot &snapshot);
+
+            // Keep the player from taking damage (for benchmarks that need the world to keep going)
+            inline void SetInvulnerable(bool invulnerable) { invulnerable_ = invulnerable; }
+
+            // Getters
+            inline PlayerGameObject *GetPlayer(void) const { return players_[0]; }
+            inline PlayerGameObject *GetPlayer(int player) const { return players_[player]; }
+            inline int GetNumPlayers(void) const { return num_players_; }
+            inline const std::vector<EnemyGameObject*> &GetEnemies(void) const { return enemy_game_objects_; }
+            inline const std::vector<CollectibleGameObject*> &GetCollectibles(void) const { return collectible_game_objects_; }
+            inline const std::vector<GameObject*> &GetExplosions(void) const { return explosions_; }
+            inline const std::vector<ProjectileGameObject*> &GetBullets(void) const { return bullets_; }
+            inline const std::vector<ProjectileGameObject*> &GetSpikes(void) const { return spikes_; }
+            inline const std::vector<GameObject*> &GetParticles(void) const { return particle_game_objects_; }
+            inline const std::vector<ChildGameObject*> &GetChildren(void) const { return child_game_objects_; }
+            inline const std::vector<GameObject*> &GetEmitters(void) const { return emitters_; }
+            inline const std::vector<GameObject*> &GetTentacles(void) const { return tentacles_; }
+            inline RandomService &GetRandom(void) { return random_; }
+            inline double GetTime(void) const { return current_time_; }
+            inline int GetPlayerHealth(void) const { return player_health_; }
+            inline int GetScore(void) const { return score_; }
+            int GetNumEntities(void) const;
+
+            // The player is dead and the last explosion has faded
+            inline bool IsOver(void) const { return over_; }
+
+            // The boss showed up and every enemy has been sunk
+            inline bool IsWon(void) const { return boss_ && enemy_game_objects_.empty(); }
+
+        private:
+            // what the objects we create get drawn with
+            SimulationAssets assets_;
+
+            // The player objects, the level streams in and things spawn around the first one
+            PlayerGameObject* players_[SIM_MAX_PLAYERS];
+            int num_players_;
+
+            // A vector of enemy entities
+            std::vector<EnemyGameObject*> enemy_game_objects_;
+
+            // steers every intercepting enemy towards the player, rebuilt once per tick
+            FlowField flow_field_;
+
+            // the number of enemies that were intercepting last tick, no need to build the field if there are none
+            int num_intercepting_;
+
+            // decides how often each enemy gets a full update based on how far it is from the player
+            AiLodScheduler ai_lod_;
+
+            // the round robin slot the next enemy gets, kept here so every simulation hands out its own
+            int next_lod_slot_;
+
+            // the level, streamed in chunk by chunk as the player moves along it
+            ChunkedWorld world_;
+
+            // all the random numbers in the game, one seeded stream per subsystem
+            RandomService random_;
+
+            // decides what enemies come in each wave and where they and the buffs go
+            SpawnDirector spawn_director_;
+
+            // scratch list of things a new spawn has to keep away from
+            std::vector<glm::vec3> spawn_blockers_;
+
+            // A vecotr of collectible objects
+            std::vector<CollectibleGameObject*> collectible_game_objects_;
+
+            // A vector of basic game objects used for the explosions
+            std::vector<GameObject*> explosions_;
+
+            // a collection of bullet objects
+            std::vector<ProjectileGameObject*> bullets_;
+            std::vector<ProjectileGameObject*> spikes_;
+
+            // particle object to render
+            std::vector<GameObject*> particle_game_objects_;
+
+            //
+            std::vector<ChildGameObject*> child_game_objects_;
+
+            // standalone particle emitters, each with an anchor object it owns
+            std::vector<GameObject*> emitters_;
+
+            // the segments of the krakens tentacles, arm by arm from the base out, and the chains that pose them
+            std::vector<GameObject*> tentacles_;
+            IkSolver kraken_ik_;
+
+            // the head and every tentacle link of the kraken, refit after the tentacles are posed each tick
+            // capsule 0 is the head, arm a link j is 1 + a * KRAKEN_SEGMENTS + j
+            CapsuleBvh kraken_bvh_;
+
+            // Keep track of time
+            double current_time_;
+
+            // the wheel that drives every timer in the simulation off the tick clock
+            TimerWheel timer_wheel_;
+
+            // a tracker to determine the players health
+            int player_health_;
+
+            //
+            int score_;
+
+            //
+            bool boss_;
+
+            // set once the player is gone and the explosions have played out
+            bool over_;
+
+            // the player doesnt take damage
+            bool invulnerable_;
+
+            // a tracker to determine the number of collectibles the player has gathered
+            int buff_count_;
+
+            // the number of enemies on the map
+            int num_enemies_;
+
+            // the number of buffs on the map
+            int num_buffs_;
+
+            // a timer thatll help with spawning enemies over time
+            Timer* enemy_timer_;
+
+            // a timer for spawning buffs over time
+            Timer* buff_timer_;
+
+            // a timer per player to determine if it is appropriate to spawn another bullet
+            Timer* bullet_timers_[SIM_MAX_PLAYERS];
+
+            // sounds waiting to be played
+            std::vector<SimAudioEvent> audio_events_;
+
+            // scratch list of every timer in the world, see GetTimerEntries
+            std::vector<Timer*> timers_;
+            std::vector<TimerEntry*> timer_entries_;
+
+            // Delete every object but the player
+            void ClearObjects(void);
+
+            // The wheel entries of every timer in the world, in the same order Save and Restore go through the objects
+            void GetTimerEntries(std::vector<TimerEntry*> &entries);
+
+            // Make a plain object or a particle system again from a snapshot
+            GameObject *RestoreObject(Snapshot &snapshot);
+            GameObject *RestoreParticles(Snapshot &snapshot, Geometry *geometry, GameObject *parent);
+
+            // Add a new enemy and give it the next AI level of detail slot
+            void NewEnemy(const glm::vec3 &position, GLuint texture, int health = 1, int state = 0);
+
+            // The closest player to a position
+            PlayerGameObject *NearestPlayer(const glm::vec3 &position) const;
+
+            // The player an enemy ran into or an object is touching, NULL if none
+            PlayerGameObject *PlayerContact(EnemyGameObject *enemy, float distance);
+            PlayerGameObject *PlayerTouching(GameObject *object, float distance);
+
+            // Spawn a wave of enemies or a buff away from the player (called when their timers run out)
+            void SpawnWave(void);
+            void SpawnBuff(void);
+
+            // Bring in the level chunks around the player and remove the ones left behind
+            void StreamChunks(void);
+
+            // Grow the tentacles when the kraken shows up, pose them every tick and drop them once it sinks
+            void UpdateKraken(void);
+
+            // Whether two objects touch, by their sprite shapes if we have them and by distance if we dont
+            bool Touching(GameObject *a, GameObject *b, float distance);
+
+            // Whether an object or the step a bullet took touches an enemy, the kraken is tested against its pieces
+            bool EnemyContact(EnemyGameObject *enemy, GameObject *other, float distance);
+            bool EnemyStruck(EnemyGameObject *enemy, const glm::vec3 &start, const glm::vec3 &step) const;
+
+    }; // class Simulation
+
+} // namespace game
+
+#endif // SIMULATION_H_
@@ -0,0 +1,81 @@
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "snapshot.h"
+
+namespace game {
+
+Snapshot::Snapshot(void)
+{
+    read_ = 0;
+}
+
+
+void Snapshot::Clear(void)
+{
+    data_.clear();
+    read_ = 0;
+}
+
+
+void Snapshot::WriteBytes(const void *data, size_t size)
+{
+    if (size == 0) return;
+
+    size_t at = data_.size();
+    data_.resize(at + size);
+    memcpy(&data_[at], data, size);
+}
+
+
+void Snapshot::ReadBytes(void *data, size_t size)
+{
+    if (size > data_.size() - read_)
+    {
+        throw(std::runtime_error(std::string("Snapshot ended early, it was written by something else")));
+    }
+    if (size == 0) return;
+
+    memcpy(data, &data_[read_], size);
+    read_ += size;
+}
+
+
+uint32_t Snapshot::GetChecksum(void) const
+{
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < data_.size(); i++)
+    {
+        hash ^= data_[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+
+void Snapshot::WriteVarint(uint32_t value)
+{
+    while (value >= 0x80)
+    {
+        data_.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    data_.push_back(static_cast<uint8_t>(value));
+}
+
+
+void Snapshot::ReadVarint(uint32_t &value)
+{
+    value = 0;
+    for (int shift = 0; shift < 35; shift += 7)
+    {
+        uint8_t byte;
+        Read(byte);
+        value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return;
+    }
+    throw(std::runtime_error(std::string("Snapshot has a number that never ends, it was written by something else")));
+}
+
+} // namespace game
@@ -0,0 +1,77 @@
+#ifndef SNAPSHOT_H_
+#define SNAPSHOT_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+namespace game {
+
+    /*
+        A block of bytes the state of the simulation is packed into, so it can be put back later without
+        loading or building anything again (restarting, checkpoints)
+        Values go in as their raw bytes one after the other and have to be read back in the same order, so
+        only plain values fit: numbers, glm vectors and structs made of them
+        A snapshot only makes sense to the same build with the same assets loaded, it isnt a save file
+    */
+    class Snapshot {
+
+        public:
+            // Constructor
+            Snapshot(void);
+
+            // Empty it to write a new one, the memory is kept for next time
+            void Clear(void);
+
+            // Go back to the start to read it again
+            inline void Rewind(void) { read_ = 0; }
+
+            // Write or read a single value
+            template<typename T> inline void Write(const T &value) { WriteBytes(&value, sizeof(T)); }
+            template<typename T> inline void Read(T &value) { ReadBytes(&value, sizeof(T)); }
+
+            // A vector goes in as its size followed by its elements
+            template<typename T> void WriteVector(const std::vector<T> &values)
+            {
+                Write(static_cast<uint32_t>(values.size()));
+                if (!values.empty()) WriteBytes(&values[0], values.size() * sizeof(T));
+            }
+            template<typename T> void ReadVector(std::vector<T> &values)
+            {
+                uint32_t size;
+                Read(size);
+                values.resize(size);
+                if (size > 0) ReadBytes(&values[0], size * sizeof(T));
+            }
+
+            // Whole numbers that are usually small go in as 1 to 5 bytes, 7 bits at a time, and the signed
+            // ones are zigzagged first so small negative numbers stay small too (for packets, where bytes count)
+            void WriteVarint(uint32_t value);
+            void ReadVarint(uint32_t &value);
+            inline void WriteSigned(int32_t value) { WriteVarint((static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31)); }
+            inline void ReadSigned(int32_t &value) { uint32_t v; ReadVarint(v); value = static_cast<int32_t>((v >> 1) ^ (0u - (v & 1))); }
+
+            // Raw bytes, reading throws if the snapshot runs out first
+            void WriteBytes(const void *data, size_t size);
+            void ReadBytes(void *data, size_t size);
+
+            // FNV-1a over everything written, enough to tell two worlds apart
+            uint32_t GetChecksum(void) const;
+
+            // Getters
+            inline const std::vector<uint8_t> &GetData(void) const { return data_; }
+            inline size_t GetSize(void) const { return data_.size(); }
+            inline bool IsEmpty(void) const { return data_.empty(); }
+
+        private:
+            // everything written so far
+            std::vector<uint8_t> data_;
+
+            // how far weve read
+            size_t read_;
+
+    }; // class Snapshot
+
+} // namespace game
+
+#endif // SNAPSHOT_H_
@@ -0,0 +1,627 @@
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "software_mixer.h"
+#include "audio_manager.h"
+
+// SSE2 is always there on x64, the scalar loops below do the same thing anywhere else
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MIXER_SSE
+#include <emmintrin.h>
+#endif
+
+namespace audio_manager {
+
+// Add a mono block into the stereo mix with a gain for each ear
+static void MixMono(float *mix, const float *voice, int frames, float left, float right)
+{
+    int i = 0;
+#ifdef MIXER_SSE
+    __m128 gains = _mm_setr_ps(left, right, left, right);
+    for (; i + 4 <= frames; i += 4)
+    {
+        // each sample goes to both ears, so spread four of them over eight slots
+        __m128 samples = _mm_loadu_ps(voice + i);
+        __m128 low = _mm_unpacklo_ps(samples, samples);
+        __m128 high = _mm_unpackhi_ps(samples, samples);
+        _mm_storeu_ps(mix + 2 * i, _mm_add_ps(_mm_loadu_ps(mix + 2 * i), _mm_mul_ps(low, gains)));
+        _mm_storeu_ps(mix + 2 * i + 4, _mm_add_ps(_mm_loadu_ps(mix + 2 * i + 4), _mm_mul_ps(high, gains)));
+    }
+#endif
+    for (; i < frames; i++)
+    {
+        mix[2 * i] += voice[i] * left;
+        mix[2 * i + 1] += voice[i] * right;
+    }
+}
+
+
+// Add a stereo block into the mix, already laid out the same way
+static void MixStereo(float *mix, const float *voice, int frames, float left, float right)
+{
+    int samples = frames * 2;
+    int i = 0;
+#ifdef MIXER_SSE
+    __m128 gains = _mm_setr_ps(left, right, left, right);
+    for (; i + 4 <= samples; i += 4)
+    {
+        _mm_storeu_ps(mix + i, _mm_add_ps(_mm_loadu_ps(mix + i), _mm_mul_ps(_mm_loadu_ps(voice + i), gains)));
+    }
+#endif
+    for (; i < samples; i += 2)
+    {
+        mix[i] += voice[i] * left;
+        mix[i + 1] += voice[i + 1] * right;
+    }
+}
+
+
+// Scale the mix back up to 16 bits, clipping anything too loud
+static void Convert(int16_t *out, const float *mix, int samples)
+{
+    int i = 0;
+#ifdef MIXER_SSE
+    __m128 scale = _mm_set1_ps(32767.0f);
+    __m128 low = _mm_set1_ps(-32768.0f);
+    __m128 high = _mm_set1_ps(32767.0f);
+    for (; i + 8 <= samples; i += 8)
+    {
+        __m128 a = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(mix + i), scale), low), high);
+        __m128 b = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(mix + i + 4), scale), low), high);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b)));
+    }
+#endif
+    for (; i < samples; i++)
+    {
+        float value = mix[i] * 32767.0f;
+        if (value < -32768.0f) value = -32768.0f;
+        if (value > 32767.0f) value = 32767.0f;
+        // rounds to nearest like cvtps does, so both paths give the same samples
+        out[i] = static_cast<int16_t>(lrintf(value));
+    }
+}
+
+
+// Little endian fields for the wav header
+static void WriteU32(FILE *file, uint32_t value)
+{
+    unsigned char bytes[4] = { static_cast<unsigned char>(value), static_cast<unsigned char>(value >> 8), static_cast<unsigned char>(value >> 16), static_cast<unsigned char>(value >> 24) };
+    fwrite(bytes, 1, 4, file);
+}
+
+
+static void WriteU16(FILE *file, uint16_t value)
+{
+    unsigned char bytes[2] = { static_cast<unsigned char>(value), static_cast<unsigned char>(value >> 8) };
+    fwrite(bytes, 1, 2, file);
+}
+
+
+SoftwareMixer::SoftwareMixer(int sample_rate)
+{
+    sample_rate_ = sample_rate;
+    listener_x_ = listener_y_ = listener_z_ = 0.0f;
+    error_ = false;
+}
+
+
+SoftwareMixer::~SoftwareMixer()
+{
+}
+
+
+void SoftwareMixer::Render(int16_t *out, int frames)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    while (frames > 0)
+    {
+        int block = frames < MIXER_BLOCK_FRAMES ? frames : MIXER_BLOCK_FRAMES;
+        MixBlock(out, block);
+        out += block * 2;
+        frames -= block;
+    }
+}
+
+
+void SoftwareMixer::RenderToFile(const char *filename, double seconds)
+{
+    std::vector<int16_t> samples(static_cast<int>(seconds * sample_rate_) * 2);
+    if (!samples.empty()) Render(&samples[0], samples.size() / 2);
+    WriteWav(filename, samples, sample_rate_);
+}
+
+
+void SoftwareMixer::WriteWav(const char *filename, const std::vector<int16_t> &samples, int sample_rate)
+{
+    FILE *file = fopen(filename, "wb");
+    if (!file)
+    {
+        throw(AudioManagerException(std::string("Error opening file ") + filename));
+    }
+
+    uint32_t bytes = samples.size() * sizeof(int16_t);
+    fwrite("RIFF", 1, 4, file);
+    WriteU32(file, 36 + bytes);
+    fwrite("WAVE", 1, 4, file);
+
+    // plain 16 bit stereo
+    fwrite("fmt ", 1, 4, file);
+    WriteU32(file, 16);
+    WriteU16(file, 1);
+    WriteU16(file, 2);
+    WriteU32(file, sample_rate);
+    WriteU32(file, sample_rate * 4);
+    WriteU16(file, 4);
+    WriteU16(file, 16);
+
+    fwrite("data", 1, 4, file);
+    WriteU32(file, bytes);
+    for (int i = 0; i < samples.size(); i++)
+    {
+        WriteU16(file, static_cast<uint16_t>(samples[i]));
+    }
+
+    bool failed = ferror(file) != 0;
+    fclose(file);
+    if (failed)
+    {
+        throw(AudioManagerException(std::string("Error writing file ") + filename));
+    }
+}
+
+
+int SoftwareMixer::GetNumPlaying(void)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    int count = 0;
+    for (int i = 0; i < sources_.size(); i++)
+    {
+        if (sources_[i].used && sources_[i].state == AUDIO_SOURCE_PLAYING) count++;
+    }
+    return count;
+}
+
+
+unsigned int SoftwareMixer::CreateBuffer(void)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    int index = 0;
+    while (index < buffers_.size() && buffers_[index].used) index++;
+    if (index == buffers_.size()) buffers_.push_back(Buffer());
+
+    Buffer &buffer = buffers_[index];
+    buffer.used = true;
+    buffer.channels = 1;
+    buffer.sample_rate = sample_rate_;
+    buffer.frames = 0;
+    buffer.samples.clear();
+    return index + 1;
+}
+
+
+void SoftwareMixer::DeleteBuffer(unsigned int buffer)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Buffer *b = GetBuffer(buffer);
+    if (!b) return;
+    b->used = false;
+    b->samples.clear();
+}
+
+
+void SoftwareMixer::SetBufferData(unsigned int buffer, const int16_t *samples, int frames, int channels, int sample_rate)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Buffer *b = GetBuffer(buffer);
+    if (!b) return;
+    if (channels < 1 || channels > 2 || sample_rate <= 0 || frames < 0)
+    {
+        error_ = true;
+        return;
+    }
+
+    b->channels = channels;
+    b->sample_rate = sample_rate;
+    b->frames = frames;
+    b->samples.assign(samples, samples + frames * channels);
+}
+
+
+unsigned int SoftwareMixer::CreateSource(void)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    int index = 0;
+    while (index < sources_.size() && sources_[index].used) index++;
+    if (index == sources_.size()) sources_.push_back(Source());
+
+    // the same defaults as an OpenAL source
+    Source &source = sources_[index];
+    source.used = true;
+    source.state = AUDIO_SOURCE_INITIAL;
+    source.queue.clear();
+    source.processed = 0;
+    source.position = 0.0;
+    source.rewind = false;
+    source.loop = false;
+    source.gain = 1.0f;
+    source.x = source.y = source.z = 0.0f;
+    source.relative = false;
+    source.reference = 1.0f;
+    source.max = FLT_MAX;
+    source.rolloff = 1.0f;
+    return index + 1;
+}
+
+
+void SoftwareMixer::DeleteSource(unsigned int source)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Source *s = GetSource(source);
+    if (!s) return;
+    s->used = false;
+    s->queue.clear();
+}
+
+
+void SoftwareMixer::SetSourceBuffer(unsigned int source, unsigned int buffer)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Source *s = GetSource(source);
+    if (!s) return;
+    if (buffer != 0 && !GetBuffer(buffer)) return;
+
+    s->queue.clear();
+    if (buffer != 0) s->queue.push_back(buffer);
+    s->processed = 0;
+    s->position = 0.0;
+    s->rewind = false;
+}
+
+
+void SoftwareMixer::SetSourceLooping(unsigned int source, bool loop)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Source *s = GetSource(source);
+    if (s) s->loop = loop;
+}
+
+
+void SoftwareMixer::SetSourceGain(unsigned int source, float gain)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Source *s = GetSource(source);
+    if (s) s->gain = gain;
+}
+
+
+void SoftwareMixer::SetSourcePosition(unsigned int source, float x, float y, float z)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Source *s = GetSource(source);
+    if (!s) return;
+    s->x = x;
+    s->y = y;
+    s->z = z;
+}
+
+
+void SoftwareMixer::SetSourceRelative(unsigned int source, bool relative)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Source *s = GetSource(source);
+    if (s) s->relative = relative;
+}
+
+
+void SoftwareMixer::SetSourceDistance(unsigned int source, float reference, float max, float rolloff)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Source *s = GetSource(source);
+    if (!s) return;
+    s->reference = reference;
+    s->max = max;
+    s->rolloff = rolloff;
+}
+
+
+void SoftwareMixer::SetSourceOffset(unsigned int source, float seconds)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Source *s = GetSource(source);
+    if (!s || s->processed >= s->queue.size()) return;
+
+    // an offset set while stopped is where the next Play starts
+    Buffer *b = GetBuffer(s->queue[s->processed]);
+    if (!b) return;
+    s->position = seconds * b->sample_rate;
+    s->rewind = false;
+}
+
+
+void SoftwareMixer::PlaySource(unsigned int source)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Source *s = GetSource(source);
+    if (!s) return;
+
+    if (s->rewind)
+    {
+        s->position = 0.0;
+        s->processed = 0;
+        s->rewind = false;
+    }
+    s->state = AUDIO_SOURCE_PLAYING;
+}
+
+
+void SoftwareMixer::StopSource(unsigned int source)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Source *s = GetSource(source);
+    if (!s) return;
+
+    // like OpenAL a stopped source is done with everything queued on it
+    s->state = AUDIO_SOURCE_STOPPED;
+    s->processed = s->queue.size();
+    s->rewind = true;
+}
+
+
+int SoftwareMixer::GetSourceState(unsigned int source)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Source *s = GetSource(source);
+    return s ? s->state : AUDIO_SOURCE_INITIAL;
+}
+
+
+void SoftwareMixer::QueueBuffer(unsigned int source, unsigned int buffer)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Source *s = GetSource(source);
+    if (!s || !GetBuffer(buffer)) return;
+    s->queue.push_back(buffer);
+}
+
+
+unsigned int SoftwareMixer::UnqueueBuffer(unsigned int source)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Source *s = GetSource(source);
+    if (!s || s->processed == 0) return 0;
+
+    unsigned int buffer = s->queue.front();
+    s->queue.erase(s->queue.begin());
+    s->processed--;
+    return buffer;
+}
+
+
+int SoftwareMixer::GetQueuedBuffers(unsigned int source)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Source *s = GetSource(source);
+    return s ? s->queue.size() : 0;
+}
+
+
+int SoftwareMixer::GetProcessedBuffers(unsigned int source)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Source *s = GetSource(source);
+    return s ? s->processed : 0;
+}
+
+
+void SoftwareMixer::SetListenerPosition(float x, float y, float z)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    listener_x_ = x;
+    listener_y_ = y;
+    listener_z_ = z;
+}
+
+
+bool SoftwareMixer::HasError(void)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    bool error = error_;
+    error_ = false;
+    return error;
+}
+
+
+SoftwareMixer::Buffer *SoftwareMixer::GetBuffer(unsigned int buffer)
+{
+    if (buffer == 0 || buffer > buffers_.size() || !buffers_[buffer - 1].used)
+    {
+        error_ = true;
+        return NULL;
+    }
+    return &buffers_[buffer - 1];
+}
+
+
+SoftwareMixer::Source *SoftwareMixer::GetSource(unsigned int source)
+{
+    if (source == 0 || source > sources_.size() || !sources_[source - 1].used)
+    {
+        error_ = true;
+        return NULL;
+    }
+    return &sources_[source - 1];
+}
+
+
+void SoftwareMixer::MixBlock(int16_t *out, int frames)
+{
+    memset(mix_, 0, sizeof(float) * frames * 2);
+
+    for (int i = 0; i < sources_.size(); i++)
+    {
+        Source &source = sources_[i];
+        if (!source.used || source.state != AUDIO_SOURCE_PLAYING) continue;
+
+        int channels = Resample(source, frames);
+        if (channels == 0) continue;
+
+        float left, right;
+        Gains(source, channels, left, right);
+        if (channels == 1)
+        {
+            MixMono(mix_, voice_, frames, left, right);
+        }
+        else
+        {
+            MixStereo(mix_, voice_, frames, left, right);
+        }
+    }
+
+    Convert(out, mix_, frames * 2);
+}
+
+
+int SoftwareMixer::Resample(Source &source, int frames)
+{
+    if (source.processed >= source.queue.size())
+    {
+        source.state = AUDIO_SOURCE_STOPPED;
+        source.rewind = true;
+        return 0;
+    }
+
+    // everything comes out with the channels of the buffer playing now, a stream doesnt change format half way
+    Buffer *first = GetBuffer(source.queue[source.processed]);
+    if (!first) return 0;
+    int channels = first->channels;
+
+    int i = 0;
+    while (i < frames && source.processed < source.queue.size())
+    {
+        Buffer *buffer = GetBuffer(source.queue[source.processed]);
+        if (!buffer || buffer->frames == 0)
+        {
+            source.processed++;
+            source.position = 0.0;
+            continue;
+        }
+
+        // a looping source wraps onto its own start, anything else stops on its last sample
+        bool wrap = source.loop && source.queue.size() == 1;
+        double step = static_cast<double>(buffer->sample_rate) / sample_rate_;
+        const int16_t *data = &buffer->samples[0];
+        int from = buffer->channels;
+        int last = buffer->frames - 1;
+
+        while (i < frames && source.position < buffer->frames)
+        {
+            int index = static_cast<int>(source.position);
+            float t = static_cast<float>(source.position - index);
+            int next = index < last ? index + 1 : (wrap ? 0 : last);
+            for (int c = 0; c < channels; c++)
+            {
+                // a mono buffer in a stereo stream plays in both ears
+                int channel = c < from ? c : 0;
+                float a = data[index * from + channel];
+                float b = data[next * from + channel];
+                voice_[i * channels + c] = (a + (b - a) * t) * (1.0f / 32768.0f);
+            }
+            source.position += step;
+            i++;
+        }
+
+        if (source.position >= buffer->frames)
+        {
+            source.position -= buffer->frames;
+            if (wrap)
+            {
+                source.position = fmod(source.position, static_cast<double>(buffer->frames));
+            }
+            else
+            {
+                source.processed++;
+            }
+        }
+    }
+
+    if (source.processed >= source.queue.size())
+    {
+        source.state = AUDIO_SOURCE_STOPPED;
+        source.rewind = true;
+    }
+
+    // the rest of the block is silence
+    for (; i < frames; i++)
+    {
+        for (int c = 0; c < channels; c++)
+        {
+            voice_[i * channels + c] = 0.0f;
+        }
+    }
+    return channels;
+}
+
+
+void SoftwareMixer::Gains(const Source &source, int channels, float &left, float &right) const
+{
+    // like OpenAL only mono sources are placed, anything else just plays at its gain
+    if (channels != 1)
+    {
+        left = right = source.gain;
+        return;
+    }
+
+    float dx = source.x;
+    float dy = source.y;
+    float dz = source.z;
+    if (!source.relative)
+    {
+        dx -= listener_x_;
+        dy -= listener_y_;
+        dz -= listener_z_;
+    }
+    float distance = sqrt(dx * dx + dy * dy + dz * dz);
+
+    // inverse distance clamped to the reference and max distances
+    float attenuation = 1.0f;
+    if (source.reference > 0.0f)
+    {
+        float clamped = distance;
+        if (clamped < source.reference) clamped = source.reference;
+        if (clamped > source.max) clamped = source.max;
+        attenuation = source.reference / (source.reference + source.rolloff * (clamped - source.reference));
+    }
+
+    // equal power panning by how far to the side it is, so something crossing in front doesnt dip in the middle
+    float pan = distance > 0.0001f ? dx / distance : 0.0f;
+    float angle = (pan + 1.0f) * 0.25f * 3.14159265f;
+    left = source.gain * attenuation * cos(angle);
+    right = source.gain * attenuation * sin(angle);
+}
+
+} // namespace audio_manager
@@ -0,0 +1,133 @@
+#ifndef SOFTWARE_MIXER_H_
+#define SOFTWARE_MIXER_H_
+
+#include <mutex>
+#include <vector>
+
+#include "audio_backend.h"
+
+// the rate the mixer renders at unless asked for another, the output is always stereo
+#define MIXER_SAMPLE_RATE 44100
+
+// how many frames are mixed at once, few enough that the block of every voice stays in the cache
+#define MIXER_BLOCK_FRAMES 256
+
+namespace audio_manager {
+
+    /*
+        A backend that does the mixing itself instead of leaving it to a sound card, so the audio can run where
+        there isnt one (a server, a test) and comes out exactly the same every time
+        Nothing plays until Render is called, which mixes the next so many frames of every playing source into
+        16 bit stereo. Each source is resampled to the output rate (linearly), falls off with distance on the
+        same curve OpenAL uses and is panned by how far to the left or right of the listener it is
+        The gains are applied and summed four samples at a time with SSE where the compiler has it
+        Every call locks, so the audio thread can drive it while another thread renders
+    */
+    class SoftwareMixer : public AudioBackend {
+
+        public:
+            // Constructor and destructor
+            SoftwareMixer(int sample_rate = MIXER_SAMPLE_RATE);
+            ~SoftwareMixer();
+
+            // Mix the next frames into out, frames * 2 samples with left before right
+            void Render(int16_t *out, int frames);
+
+            // Mix the next so many seconds into a wav file, throws an AudioManagerException if it cant be written
+            void RenderToFile(const char *filename, double seconds);
+
+            // Write 16 bit stereo samples out as a wav file, throws an AudioManagerException if it cant
+            static void WriteWav(const char *filename, const std::vector<int16_t> &samples, int sample_rate);
+
+            // Getters
+            inline int GetSampleRate(void) const { return sample_rate_; }
+            int GetNumPlaying(void);
+
+            unsigned int CreateBuffer(void);
+            void DeleteBuffer(unsigned int buffer);
+            void SetBufferData(unsigned int buffer, const int16_t *samples, int frames, int channels, int sample_rate);
+
+            unsigned int CreateSource(void);
+            void DeleteSource(unsigned int source);
+            void SetSourceBuffer(unsigned int source, unsigned int buffer);
+            void SetSourceLooping(unsigned int source, bool loop);
+            void SetSourceGain(unsigned int source, float gain);
+            void SetSourcePosition(unsigned int source, float x, float y, float z);
+            void SetSourceRelative(unsigned int source, bool relative);
+            void SetSourceDistance(unsigned int source, float reference, float max, float rolloff);
+            void SetSourceOffset(unsigned int source, float seconds);
+            void PlaySource(unsigned int source);
+            void StopSource(unsigned int source);
+            int GetSourceState(unsigned int source);
+
+            void QueueBuffer(unsigned int source, unsigned int buffer);
+            unsigned int UnqueueBuffer(unsigned int source);
+            int GetQueuedBuffers(unsigned int source);
+            int GetProcessedBuffers(unsigned int source);
+
+            void SetListenerPosition(float x, float y, float z);
+
+            bool HasError(void);
+
+        private:
+            struct Buffer {
+                bool used;
+                int channels;
+                int sample_rate;
+                int frames;
+                // kept at 16 bits, half what floats would take, they are scaled as they are resampled
+                std::vector<int16_t> samples;
+            };
+
+            struct Source {
+                bool used;
+                int state;
+
+                // the buffers it plays one after the other, the first processed of them are done with
+                std::vector<unsigned int> queue;
+                int processed;
+
+                // how far into the current buffer it is in frames, and whether Play starts it over
+                double position;
+                bool rewind;
+
+                bool loop;
+                float gain;
+                float x, y, z;
+                bool relative;
+                float reference, max, rolloff;
+            };
+
+            int sample_rate_;
+
+            // a buffer or source number is its index plus one
+            std::vector<Buffer> buffers_;
+            std::vector<Source> sources_;
+
+            float listener_x_, listener_y_, listener_z_;
+            bool error_;
+
+            std::mutex mutex_;
+
+            // the block being mixed, and one source resampled for it
+            float mix_[MIXER_BLOCK_FRAMES * 2];
+            float voice_[MIXER_BLOCK_FRAMES * 2];
+
+            // Look up a number, NULL (and an error) if it isnt one we handed out
+            Buffer *GetBuffer(unsigned int buffer);
+            Source *GetSource(unsigned int source);
+
+            // Mix one block of at most MIXER_BLOCK_FRAMES
+            void MixBlock(int16_t *out, int frames);
+
+            // Resample the next frames of a source into voice_, returns how many channels it has (0 for none)
+            int Resample(Source &source, int frames);
+
+            // How loud a source is in each ear
+            void Gains(const Source &source, int channels, float &left, float &right) const;
+
+    }; // class SoftwareMixer
+
+} // namespace audio_manager
+
+#endif // SOFTWARE_MIXER_H_
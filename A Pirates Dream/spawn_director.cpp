@@ -0,0 +1,219 @@
+#include <cmath>
+#include <glm/gtc/constants.hpp>
+
+#include "spawn_director.h"
+
+namespace game {
+
+SpawnDirector::SpawnDirector(void)
+{
+    max_tries_ = 16;
+    random_ = nullptr;
+
+    // the default curve keeps the old pacing, one ship every 5 seconds with sea monsters joining in once the score passes 10
+    DifficultyKey start = { 0, 5.0f, 5, 1, 0.0f };
+    DifficultyKey calm = { 10, 5.0f, 5, 1, 0.0f };
+    DifficultyKey monsters = { 11, 5.0f, 5, 2, 0.6f };
+    DifficultyKey boss = { 25, 5.0f, 5, 2, 0.6f };
+    AddDifficultyKey(start);
+    AddDifficultyKey(calm);
+    AddDifficultyKey(monsters);
+    AddDifficultyKey(boss);
+}
+
+
+float SpawnDirector::RandomFloat(void)
+{
+    return random_->NextFloat();
+}
+
+
+void SpawnDirector::BuildTables(void)
+{
+    // enemies used to spawn in a 10 by 10 box kept 2 units off the player, buffs in an 8 by 8 box kept 1 unit off
+    BuildTable(tables_[SPAWN_TABLE_ENEMY], 5.0f, 2.0f, 0.7f);
+    BuildTable(tables_[SPAWN_TABLE_BUFF], 4.0f, 1.0f, 0.6f);
+}
+
+
+void SpawnDirector::BuildTable(std::vector<glm::vec2> &table, float half_size, float exclusion, float min_distance)
+{
+    // bridsons poisson disk sampling, with a grid so each point only checks its close neighbours
+    float cell = min_distance / sqrt(2.0f);
+    int grid_size = static_cast<int>(ceil(2.0f * half_size / cell));
+    std::vector<int> grid(grid_size * grid_size, -1);
+    std::vector<int> active;
+
+    table.clear();
+
+    // the first point can go anywhere in the ring
+    glm::vec2 first;
+    do {
+        first = glm::vec2((2.0f * RandomFloat() - 1.0f) * half_size, (2.0f * RandomFloat() - 1.0f) * half_size);
+    } while (glm::length(first) < exclusion);
+
+    table.push_back(first);
+    active.push_back(0);
+    grid[static_cast<int>((first.y + half_size) / cell) * grid_size + static_cast<int>((first.x + half_size) / cell)] = 0;
+
+    const int attempts = 30;
+    while (!active.empty())
+    {
+        int a = static_cast<int>(RandomFloat() * active.size());
+        glm::vec2 centre = table[active[a]];
+        bool placed = false;
+
+        for (int k = 0; k < attempts; k++)
+        {
+            // try a point in the annulus between one and two minimum distances away
+            float angle = RandomFloat() * 2.0f * glm::pi<float>();
+            float radius = min_distance * (1.0f + RandomFloat());
+            glm::vec2 p(centre.x + radius * cos(angle), centre.y + radius * sin(angle));
+
+            if (p.x < -half_size || p.x >= half_size || p.y < -half_size || p.y >= half_size) continue;
+            if (glm::length(p) < exclusion) continue;
+
+            int gx = static_cast<int>((p.x + half_size) / cell);
+            int gy = static_cast<int>((p.y + half_size) / cell);
+
+            bool free = true;
+            for (int y = gy - 2; y <= gy + 2 && free; y++)
+            {
+                for (int x = gx - 2; x <= gx + 2; x++)
+                {
+                    if (x < 0 || y < 0 || x >= grid_size || y >= grid_size) continue;
+
+                    int other = grid[y * grid_size + x];
+                    if (other >= 0 && glm::length(table[other] - p) < min_distance)
+                    {
+                        free = false;
+                        break;
+                    }
+                }
+            }
+
+            if (free)
+            {
+                grid[gy * grid_size + gx] = table.size();
+                active.push_back(table.size());
+                table.push_back(p);
+                placed = true;
+                break;
+            }
+        }
+
+        // this point is surrounded, stop growing from it
+        if (!placed)
+        {
+            active[a] = active.back();
+            active.pop_back();
+        }
+    }
+
+    // shuffle so walking through the table in order still jumps around the ring
+    for (int i = table.size() - 1; i > 0; i--)
+    {
+        int j = static_cast<int>(RandomFloat() * (i + 1));
+        glm::vec2 temp = table[i];
+        table[i] = table[j];
+        table[j] = temp;
+    }
+}
+
+
+void SpawnDirector::AddDifficultyKey(const DifficultyKey &key)
+{
+    curve_.push_back(key);
+}
+
+
+DifficultyKey SpawnDirector::GetDifficulty(int score) const
+{
+    if (score <= curve_.front().score) return curve_.front();
+    if (score >= curve_.back().score) return curve_.back();
+
+    // find the two keys around the score and blend between them
+    int i = 1;
+    while (curve_[i].score < score) i++;
+
+    const DifficultyKey &a = curve_[i - 1];
+    const DifficultyKey &b = curve_[i];
+    float t = static_cast<float>(score - a.score) / static_cast<float>(b.score - a.score);
+
+    DifficultyKey key;
+    key.score = score;
+    key.spawn_interval = a.spawn_interval + t * (b.spawn_interval - a.spawn_interval);
+    key.max_enemies = a.max_enemies + static_cast<int>(t * (b.max_enemies - a.max_enemies));
+    key.wave_budget = a.wave_budget + static_cast<int>(t * (b.wave_budget - a.wave_budget));
+    key.monster_chance = a.monster_chance + t * (b.monster_chance - a.monster_chance);
+    return key;
+}
+
+
+int SpawnDirector::PlanWave(int score, int alive, std::vector<int> &types)
+{
+    DifficultyKey difficulty = GetDifficulty(score);
+
+    int room = difficulty.max_enemies - alive;
+    int budget = difficulty.wave_budget;
+    int count = 0;
+
+    // spend the budget one enemy at a time until its gone or the sea is full
+    while (room > 0 && budget > 0)
+    {
+        if (budget >= 2 && RandomFloat() < difficulty.monster_chance)
+        {
+            types.push_back(SPAWN_MONSTER);
+            budget -= 2;
+        }
+        else
+        {
+            types.push_back(SPAWN_NAVY);
+            budget -= 1;
+        }
+        room--;
+        count++;
+    }
+
+    return count;
+}
+
+
+bool SpawnDirector::FindSpawn(int table, const glm::vec3 &anchor, const std::vector<glm::vec3> &blockers, float separation, glm::vec3 &position)
+{
+    const std::vector<glm::vec2> &candidates = tables_[table];
+    if (candidates.empty()) return false;
+
+    // start somewhere random in the table and walk forward, looking at no more than max_tries_ candidates
+    int start = static_cast<int>(RandomFloat() * candidates.size());
+    int tries = max_tries_ < candidates.size() ? max_tries_ : candidates.size();
+
+    for (int t = 0; t < tries; t++)
+    {
+        const glm::vec2 &offset = candidates[(start + t) % candidates.size()];
+        glm::vec3 p(anchor.x + offset.x, anchor.y + offset.y, 0.0f);
+
+        bool free = true;
+        for (int b = 0; b < blockers.size(); b++)
+        {
+            float dx = p.x - blockers[b].x;
+            float dy = p.y - blockers[b].y;
+            float r = separation + blockers[b].z;
+            if (dx * dx + dy * dy < r * r)
+            {
+                free = false;
+                break;
+            }
+        }
+
+        if (free)
+        {
+            position = p;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+} // namespace game
@@ -0,0 +1,96 @@
+#ifndef SPAWN_DIRECTOR_H_
+#define SPAWN_DIRECTOR_H_
+
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "random.h"
+
+// the candidate tables the director keeps
+#define SPAWN_TABLE_ENEMY 0
+#define SPAWN_TABLE_BUFF 1
+#define SPAWN_NUM_TABLES 2
+
+// the enemy types a wave can be made of
+#define SPAWN_NAVY 0
+#define SPAWN_MONSTER 1
+
+namespace game {
+
+    // One point on the difficulty curve, the director blends between the two keys around the current score
+    struct DifficultyKey {
+        int score;
+
+        // seconds between waves
+        float spawn_interval;
+
+        // how many enemies can be out at once
+        int max_enemies;
+
+        // points a wave can spend on enemies (a navy ship costs 1, a sea monster 2)
+        int wave_budget;
+
+        // the chance that an enemy in the wave is a sea monster
+        float monster_chance;
+    };
+
+    /*
+        SpawnDirector decides what to spawn and where
+        Each wave gets a budget from a difficulty curve driven by the score, and spawn positions come
+        from tables of well spread (poisson disk) points that are built once up front around the
+        player, so finding a place to spawn tries a fixed number of candidates instead of
+        rolling random positions until one happens to fit
+    */
+    class SpawnDirector {
+
+        public:
+            // Constructor
+            SpawnDirector(void);
+
+            // Set the random stream the director draws from (call before anything else)
+            inline void SetRandom(Random *random) { random_ = random; }
+
+            // Build the candidate tables (call once after seeding the random numbers)
+            void BuildTables(void);
+
+            // Add a key to the difficulty curve, keys have to be added in order of score
+            void AddDifficultyKey(const DifficultyKey &key);
+
+            // The point on the difficulty curve for a given score
+            DifficultyKey GetDifficulty(int score) const;
+
+            // Pick the enemy types for the next wave, returns how many were picked
+            int PlanWave(int score, int alive, std::vector<int> &types);
+
+            // Find a spawn position around the anchor, away from the blockers (x, y and radius)
+            // Returns false if none of the candidates we tried were free
+            bool FindSpawn(int table, const glm::vec3 &anchor, const std::vector<glm::vec3> &blockers, float separation, glm::vec3 &position);
+
+            // Getters
+            inline int GetTableSize(int table) const { return tables_[table].size(); }
+            inline int GetMaxTries(void) const { return max_tries_; }
+
+        private:
+            // the candidate offsets from the anchor for each table
+            std::vector<glm::vec2> tables_[SPAWN_NUM_TABLES];
+
+            // the difficulty curve
+            std::vector<DifficultyKey> curve_;
+
+            // how many candidates a single search may look at
+            int max_tries_;
+
+            // the stream we draw from
+            Random *random_;
+
+            // Fill a table with poisson disk points in a square ring around the anchor
+            void BuildTable(std::vector<glm::vec2> &table, float half_size, float exclusion, float min_distance);
+
+            // A random float in [0, 1)
+            float RandomFloat(void);
+
+    }; // class SpawnDirector
+
+} // namespace game
+
+#endif // SPAWN_DIRECTOR_H_
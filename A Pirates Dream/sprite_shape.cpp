@@ -0,0 +1,266 @@
+#include <cmath>
+
+#include "sprite_shape.h"
+
+namespace game {
+
+// Which of the SHAPE_ANGLE_STEPS rotations is closest to an angle
+static int AngleStep(float angle)
+{
+    float turns = angle / (2.0f * glm::pi<float>());
+    int step = static_cast<int>(floor(turns * SHAPE_ANGLE_STEPS + 0.5f)) % SHAPE_ANGLE_STEPS;
+    return step < 0 ? step + SHAPE_ANGLE_STEPS : step;
+}
+
+
+// 64 bits of a mask row starting at any cell, cells off either end of the row are empty
+static inline uint64_t RowBits(const uint64_t *row, int words, int offset)
+{
+    int word = offset >= 0 ? offset / 64 : -((63 - offset) / 64);
+    int shift = offset - word * 64;
+
+    uint64_t low = (word >= 0 && word < words) ? row[word] : 0;
+    if (shift == 0) return low;
+
+    uint64_t high = (word + 1 >= 0 && word + 1 < words) ? row[word + 1] : 0;
+    return (low >> shift) | (high << (64 - shift));
+}
+
+
+// The box around the solid pixels of an object, placed in the world
+struct ShapeBox {
+    glm::vec2 centre;
+    glm::vec2 axis[2];
+    glm::vec2 half;
+};
+
+
+static ShapeBox PlaceBox(const SpriteShape &shape, const GameObject &object)
+{
+    float c = cos(object.GetRotation());
+    float s = sin(object.GetRotation());
+    float scale = object.GetScale();
+
+    ShapeBox box;
+    box.axis[0] = glm::vec2(c, s);
+    box.axis[1] = glm::vec2(-s, c);
+    glm::vec2 local = shape.GetBoxCentre() * scale;
+    box.centre = glm::vec2(object.GetPosition().x, object.GetPosition().y) + box.axis[0] * local.x + box.axis[1] * local.y;
+    box.half = shape.GetBoxHalf() * scale;
+    return box;
+}
+
+
+// Separating axis test between two boxes, in 2D only their own four axes can separate them
+static bool BoxesOverlap(const ShapeBox &a, const ShapeBox &b)
+{
+    glm::vec2 d = b.centre - a.centre;
+    for (int i = 0; i < 4; i++)
+    {
+        glm::vec2 axis = i < 2 ? a.axis[i] : b.axis[i - 2];
+        float ra = a.half.x * fabs(glm::dot(a.axis[0], axis)) + a.half.y * fabs(glm::dot(a.axis[1], axis));
+        float rb = b.half.x * fabs(glm::dot(b.axis[0], axis)) + b.half.y * fabs(glm::dot(b.axis[1], axis));
+        if (fabs(glm::dot(d, axis)) > ra + rb) return false;
+    }
+    return true;
+}
+
+
+SpriteShape::SpriteShape(const unsigned char *rgba, int width, int height)
+{
+    width_ = width;
+    height_ = height;
+    solid_.resize(width * height);
+
+    int min_x = width, min_y = height, max_x = -1, max_y = -1;
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            bool solid = rgba[(y * width + x) * 4 + 3] >= SHAPE_ALPHA_THRESHOLD;
+            solid_[y * width + x] = solid;
+            if (!solid) continue;
+
+            if (x < min_x) min_x = x;
+            if (x > max_x) max_x = x;
+            if (y < min_y) min_y = y;
+            if (y > max_y) max_y = y;
+        }
+    }
+
+    empty_ = max_x < 0;
+    if (empty_)
+    {
+        box_centre_ = glm::vec2(0.0f);
+        box_half_ = glm::vec2(0.0f);
+        return;
+    }
+
+    // pixel edges to sprite space, the image is upside down compared to the world
+    float left = static_cast<float>(min_x) / width - 0.5f;
+    float right = static_cast<float>(max_x + 1) / width - 0.5f;
+    float top = 0.5f - static_cast<float>(min_y) / height;
+    float bottom = 0.5f - static_cast<float>(max_y + 1) / height;
+    box_centre_ = glm::vec2((left + right) * 0.5f, (top + bottom) * 0.5f);
+    box_half_ = glm::vec2((right - left) * 0.5f, (top - bottom) * 0.5f);
+}
+
+
+void SpriteShape::Prepare(float scale)
+{
+    for (int i = 0; i < scaled_.size(); i++)
+    {
+        if (scaled_[i].scale == scale) return;
+    }
+
+    scaled_.push_back(ScaledMasks());
+    scaled_.back().scale = scale;
+    scaled_.back().masks.resize(SHAPE_ANGLE_STEPS);
+    for (int i = 0; i < SHAPE_ANGLE_STEPS; i++)
+    {
+        BuildMask(scale, 2.0f * glm::pi<float>() * i / SHAPE_ANGLE_STEPS, scaled_.back().masks[i]);
+    }
+}
+
+
+const SpriteMask &SpriteShape::GetMask(float scale, float angle)
+{
+    for (int i = 0; i < scaled_.size(); i++)
+    {
+        if (scaled_[i].scale == scale) return scaled_[i].masks[AngleStep(angle)];
+    }
+
+    // a scale nobody prepared, build it now
+    Prepare(scale);
+    return scaled_.back().masks[AngleStep(angle)];
+}
+
+
+void SpriteShape::BuildMask(float scale, float angle, SpriteMask &mask) const
+{
+    float c = cos(angle);
+    float s = sin(angle);
+    float cell = 1.0f / SHAPE_CELLS_PER_UNIT;
+
+    // the cells the rotated box around the solid pixels can cover
+    glm::vec2 low(1e30f, 1e30f);
+    glm::vec2 high(-1e30f, -1e30f);
+    for (int corner = 0; corner < 4; corner++)
+    {
+        glm::vec2 p = box_centre_ + glm::vec2(corner & 1 ? box_half_.x : -box_half_.x, corner & 2 ? box_half_.y : -box_half_.y);
+        p *= scale;
+        glm::vec2 world(c * p.x - s * p.y, s * p.x + c * p.y);
+        low = glm::min(low, world);
+        high = glm::max(high, world);
+    }
+
+    mask.x0 = static_cast<int>(floor(low.x / cell));
+    mask.y0 = static_cast<int>(floor(low.y / cell));
+    mask.width = static_cast<int>(ceil(high.x / cell)) - mask.x0;
+    mask.height = static_cast<int>(ceil(high.y / cell)) - mask.y0;
+    mask.words = (mask.width + 63) / 64;
+    mask.bits.assign(mask.words * mask.height, 0);
+    if (empty_) return;
+
+    // every cell takes the pixel under its centre, turned back into the sprites own space
+    for (int j = 0; j < mask.height; j++)
+    {
+        for (int i = 0; i < mask.width; i++)
+        {
+            float wx = (mask.x0 + i + 0.5f) * cell;
+            float wy = (mask.y0 + j + 0.5f) * cell;
+            float lx = (c * wx + s * wy) / scale;
+            float ly = (-s * wx + c * wy) / scale;
+
+            int px = static_cast<int>(floor((lx + 0.5f) * width_));
+            int py = static_cast<int>(floor((0.5f - ly) * height_));
+            if (px < 0 || px >= width_ || py < 0 || py >= height_ || !solid_[py * width_ + px]) continue;
+
+            mask.bits[j * mask.words + i / 64] |= uint64_t(1) << (i % 64);
+        }
+    }
+}
+
+
+SpriteShapes::SpriteShapes(void)
+{
+}
+
+
+SpriteShapes::~SpriteShapes()
+{
+    for (std::map<GLuint, SpriteShape*>::iterator it = shapes_.begin(); it != shapes_.end(); ++it)
+    {
+        delete it->second;
+    }
+}
+
+
+void SpriteShapes::Add(GLuint texture, const unsigned char *rgba, int width, int height)
+{
+    if (!rgba || width <= 0 || height <= 0) return;
+
+    delete shapes_[texture];
+    shapes_[texture] = new SpriteShape(rgba, width, height);
+}
+
+
+void SpriteShapes::Prepare(GLuint texture, float scale)
+{
+    std::map<GLuint, SpriteShape*>::iterator it = shapes_.find(texture);
+    if (it != shapes_.end()) it->second->Prepare(scale);
+}
+
+
+bool SpriteShapes::Has(const GameObject &a, const GameObject &b) const
+{
+    return shapes_.count(a.GetTexture()) && shapes_.count(b.GetTexture());
+}
+
+
+bool SpriteShapes::Overlap(const GameObject &a, const GameObject &b)
+{
+    SpriteShape *shape_a = shapes_[a.GetTexture()];
+    SpriteShape *shape_b = shapes_[b.GetTexture()];
+    if (shape_a->IsEmpty() || shape_b->IsEmpty()) return false;
+
+    // a sprite never reaches further from its centre than half its diagonal
+    glm::vec3 offset = a.GetPosition() - b.GetPosition();
+    float reach = (a.GetScale() + b.GetScale()) * 0.7072f;
+    if (offset.x * offset.x + offset.y * offset.y > reach * reach) return false;
+
+    // then the boxes around the solid pixels, cheaper than lining up the masks
+    if (!BoxesOverlap(PlaceBox(*shape_a, a), PlaceBox(*shape_b, b))) return false;
+
+    const SpriteMask &mask_a = shape_a->GetMask(a.GetScale(), a.GetRotation());
+    const SpriteMask &mask_b = shape_b->GetMask(b.GetScale(), b.GetRotation());
+
+    // put both masks on the same grid of world cells
+    float cells = SHAPE_CELLS_PER_UNIT;
+    int ax = static_cast<int>(floor(a.GetPosition().x * cells + 0.5f)) + mask_a.x0;
+    int ay = static_cast<int>(floor(a.GetPosition().y * cells + 0.5f)) + mask_a.y0;
+    int bx = static_cast<int>(floor(b.GetPosition().x * cells + 0.5f)) + mask_b.x0;
+    int by = static_cast<int>(floor(b.GetPosition().y * cells + 0.5f)) + mask_b.y0;
+
+    // only the cells both masks cover can hold a hit
+    int x_start = ax > bx ? ax : bx;
+    int x_end = ax + mask_a.width < bx + mask_b.width ? ax + mask_a.width : bx + mask_b.width;
+    int y_start = ay > by ? ay : by;
+    int y_end = ay + mask_a.height < by + mask_b.height ? ay + mask_a.height : by + mask_b.height;
+
+    for (int y = y_start; y < y_end; y++)
+    {
+        const uint64_t *row_a = &mask_a.bits[(y - ay) * mask_a.words];
+        const uint64_t *row_b = &mask_b.bits[(y - by) * mask_b.words];
+
+        // anything outside the overlap is empty in one of the two rows, so whole words can be compared
+        for (int x = x_start; x < x_end; x += 64)
+        {
+            if (RowBits(row_a, mask_a.words, x - ax) & RowBits(row_b, mask_b.words, x - bx)) return true;
+        }
+    }
+
+    return false;
+}
+
+} // namespace game
@@ -0,0 +1,117 @@
+#ifndef SPRITE_SHAPE_H_
+#define SPRITE_SHAPE_H_
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <map>
+#include <vector>
+#include <stdint.h>
+
+#include "game_object.h"
+
+// how fine the masks are, in cells per world unit (a sprite at scale 1 is one unit across)
+#define SHAPE_CELLS_PER_UNIT 40
+
+// the rotations each mask is built at, objects use the one closest to their angle
+#define SHAPE_ANGLE_STEPS 64
+
+// pixels with at least this much alpha are solid
+#define SHAPE_ALPHA_THRESHOLD 128
+
+namespace game {
+
+    // A 1 bit mask of the solid pixels of a sprite, rotated and scaled into world cells
+    // Each row is packed into 64 bit words, bit i of a row is word i / 64 bit i % 64
+    struct SpriteMask {
+        int width;
+        int height;
+        int words;
+
+        // the cell of the first bit, relative to the cell the object sits in
+        int x0;
+        int y0;
+
+        std::vector<uint64_t> bits;
+    };
+
+    /*
+        The collision shape of one texture, worked out from its alpha when it is loaded: the box around
+        the solid pixels (in the sprites own space, which runs from -0.5 to 0.5) and a 1 bit mask of them
+        The masks objects actually test are the solid pixels rotated to each of SHAPE_ANGLE_STEPS angles at a
+        fixed number of cells per world unit, built once per scale the texture is drawn at, so two objects at
+        any scale or rotation can be lined up cell for cell and compared 64 cells at a time
+    */
+    class SpriteShape {
+
+        public:
+            // Constructor, reads the alpha out of an RGBA image
+            SpriteShape(const unsigned char *rgba, int width, int height);
+
+            // Build the rotated masks for a scale now rather than on the first test at it
+            void Prepare(float scale);
+
+            // The mask for an object at this scale and angle
+            const SpriteMask &GetMask(float scale, float angle);
+
+            // Getters
+            inline bool IsEmpty(void) const { return empty_; }
+            inline glm::vec2 GetBoxCentre(void) const { return box_centre_; }
+            inline glm::vec2 GetBoxHalf(void) const { return box_half_; }
+
+        private:
+            // the image size and which of its pixels are solid, row 0 is the top of the sprite
+            int width_;
+            int height_;
+            std::vector<unsigned char> solid_;
+
+            // the box around the solid pixels, and whether there were any
+            glm::vec2 box_centre_;
+            glm::vec2 box_half_;
+            bool empty_;
+
+            // the rotated masks for every scale asked for so far
+            struct ScaledMasks {
+                float scale;
+                std::vector<SpriteMask> masks;
+            };
+            std::vector<ScaledMasks> scaled_;
+
+            // Rasterise the solid pixels into world cells at one scale and angle
+            void BuildMask(float scale, float angle, SpriteMask &mask) const;
+
+    }; // class SpriteShape
+
+
+    /*
+        The collision shapes of every texture the game loaded
+        Overlap() first checks the boxes around the solid pixels of the two objects against each other and
+        only if those touch lines their masks up and ANDs them a word at a time
+    */
+    class SpriteShapes {
+
+        public:
+            // Constructor and destructor
+            SpriteShapes(void);
+            ~SpriteShapes();
+
+            // Work out the shape of a texture from its pixels
+            void Add(GLuint texture, const unsigned char *rgba, int width, int height);
+
+            // Build the masks for objects with this texture drawn at this scale
+            void Prepare(GLuint texture, float scale);
+
+            // Whether the shapes of both objects textures are known
+            bool Has(const GameObject &a, const GameObject &b) const;
+
+            // Whether the solid pixels of two objects overlap, both their textures have to have shapes
+            bool Overlap(const GameObject &a, const GameObject &b);
+
+        private:
+            std::map<GLuint, SpriteShape*> shapes_;
+
+    }; // class SpriteShapes
+
+} // namespace game
+
+#endif // SPRITE_SHAPE_H_
@@ -0,0 +1,354 @@
+#include <stdexcept>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <glm/gtc/constants.hpp>
+
+#include "stress_scenario.h"
+#include "input_recorder.h"
+
+namespace game {
+
+// the names the stress file uses for each kind, in STRESS_ order
+static const char *kind_names_g[STRESS_NUM_KINDS] = { "enemies", "collectibles", "projectiles", "emitters" };
+
+
+// The value at a fraction of the way through sorted frame times
+static float Percentile(const std::vector<float> &sorted, double fraction)
+{
+    if (sorted.empty()) return 0.0f;
+
+    // nearest rank
+    int rank = static_cast<int>(ceil(fraction * sorted.size())) - 1;
+    if (rank < 0) rank = 0;
+    if (rank >= sorted.size()) rank = sorted.size() - 1;
+    return sorted[rank];
+}
+
+
+StressScenario::StressScenario(void)
+{
+    ticks_ = 3600;
+    delta_time_ = 1.0 / 60.0;
+    budget_ = 1.0 / 60.0;
+    seed_ = 1;
+    min_radius_ = 2.0f;
+    max_radius_ = 6.0f;
+
+    for (int i = 0; i < STRESS_NUM_KINDS; i++)
+    {
+        ramps_[i].start = 0;
+        ramps_[i].end = 0;
+    }
+
+    volley_ = STRESS_VOLLEY_RANDOM;
+    volley_speed_ = 0.03f;
+    volley_angle_ = 0.0f;
+    script_length_ = 0;
+}
+
+
+void StressScenario::Load(const std::string &filename)
+{
+    std::ifstream f(filename.c_str());
+    if (f.fail()) {
+        throw(std::ios_base::failure(std::string("Error opening file ") + filename));
+    }
+
+    script_.clear();
+    script_length_ = 0;
+
+    std::string line;
+    int line_number = 0;
+    while (std::getline(f, line))
+    {
+        line_number++;
+
+        // the files are written on windows
+        if (!line.empty() && line[line.size() - 1] == '\r') line.erase(line.size() - 1);
+
+        std::istringstream tokens(line);
+        std::string keyword;
+        if (!(tokens >> keyword) || keyword[0] == '#') continue;
+
+        bool ok = true;
+        int kind = -1;
+        for (int i = 0; i < STRESS_NUM_KINDS; i++)
+        {
+            if (keyword == kind_names_g[i]) kind = i;
+        }
+
+        if (kind >= 0)
+        {
+            ok = static_cast<bool>(tokens >> ramps_[kind].start);
+
+            // a single count stays the same the whole run
+            if (!(tokens >> ramps_[kind].end)) ramps_[kind].end = ramps_[kind].start;
+            ok = ok && ramps_[kind].start >= 0 && ramps_[kind].end >= 0;
+        }
+        else if (keyword == "ticks")
+        {
+            ok = (tokens >> ticks_) && ticks_ > 0;
+        }
+        else if (keyword == "delta_time")
+        {
+            ok = (tokens >> delta_time_) && delta_time_ > 0.0;
+        }
+        else if (keyword == "budget_ms")
+        {
+            double ms = 0.0;
+            ok = (tokens >> ms) && ms > 0.0;
+            budget_ = ms / 1000.0;
+        }
+        else if (keyword == "seed")
+        {
+            unsigned long long seed = 0;
+            ok = static_cast<bool>(tokens >> seed);
+            seed_ = seed;
+        }
+        else if (keyword == "ring")
+        {
+            ok = (tokens >> min_radius_ >> max_radius_) && min_radius_ > 0.0f && max_radius_ >= min_radius_;
+        }
+        else if (keyword == "volley")
+        {
+            std::string pattern;
+            ok = static_cast<bool>(tokens >> pattern);
+            if (pattern == "random") volley_ = STRESS_VOLLEY_RANDOM;
+            else if (pattern == "spiral") volley_ = STRESS_VOLLEY_SPIRAL;
+            else if (pattern == "aimed") volley_ = STRESS_VOLLEY_AIMED;
+            else ok = false;
+
+            float speed;
+            if (tokens >> speed) volley_speed_ = speed;
+        }
+        else if (keyword == "step")
+        {
+            StressStep step;
+            step.keys = 0;
+            ok = (tokens >> step.ticks) && step.ticks > 0;
+
+            std::string key;
+            while (ok && tokens >> key)
+            {
+                if (key == "W") step.keys |= INPUT_KEY_W;
+                else if (key == "S") step.keys |= INPUT_KEY_S;
+                else if (key == "Q") step.keys |= INPUT_KEY_Q;
+                else if (key == "E") step.keys |= INPUT_KEY_E;
+                else if (key == "A") step.keys |= INPUT_KEY_A;
+                else if (key == "D") step.keys |= INPUT_KEY_D;
+                else if (key == "SPACE") step.keys |= INPUT_KEY_SPACE;
+                else if (key == "SHIFT") step.keys |= INPUT_KEY_LEFT_SHIFT;
+                else if (key != "none") ok = false;
+            }
+
+            if (ok)
+            {
+                script_.push_back(step);
+                script_length_ += step.ticks;
+            }
+        }
+        else
+        {
+            ok = false;
+        }
+
+        if (!ok) {
+            std::ostringstream error;
+            error << "Bad line " << line_number << " in stress file " << filename << ": " << line;
+            throw(std::runtime_error(error.str()));
+        }
+    }
+
+    filename_ = filename;
+    random_.Seed(seed_ ^ 0x5bd1e995ULL);
+    frames_.clear();
+    frames_.reserve(ticks_);
+}
+
+
+int StressScenario::GetTarget(int kind, int tick) const
+{
+    const StressRamp &ramp = ramps_[kind];
+    if (ticks_ <= 1) return ramp.end;
+
+    double t = static_cast<double>(tick) / (ticks_ - 1);
+    if (t > 1.0) t = 1.0;
+    return ramp.start + static_cast<int>(t * (ramp.end - ramp.start) + 0.5);
+}
+
+
+glm::vec3 StressScenario::RingPosition(const glm::vec3 &centre)
+{
+    float angle = random_.Range(0.0f, 2.0f * glm::pi<float>());
+    float radius = random_.Range(min_radius_, max_radius_);
+    return glm::vec3(centre.x + radius * cos(angle), centre.y + radius * sin(angle), 0.0f);
+}
+
+
+void StressScenario::FireVolley(Simulation &simulation, const glm::vec3 &centre)
+{
+    if (volley_ == STRESS_VOLLEY_SPIRAL)
+    {
+        // out from the player, each shot turned a little further than the last
+        volley_angle_ += 0.2f;
+        glm::vec3 direction(cos(volley_angle_), sin(volley_angle_), 0.0f);
+        simulation.AddBullet(centre, volley_speed_ * direction);
+    }
+    else if (volley_ == STRESS_VOLLEY_AIMED)
+    {
+        // in from the ring, straight at the player
+        glm::vec3 position = RingPosition(centre);
+        simulation.AddBullet(position, volley_speed_ * glm::normalize(centre - position));
+    }
+    else
+    {
+        float angle = random_.Range(0.0f, 2.0f * glm::pi<float>());
+        simulation.AddBullet(RingPosition(centre), volley_speed_ * glm::vec3(cos(angle), sin(angle), 0.0f));
+    }
+}
+
+
+void StressScenario::Populate(Simulation &simulation, int tick)
+{
+    glm::vec3 centre = simulation.GetPlayer()->GetPosition();
+
+    int target = GetTarget(STRESS_ENEMIES, tick);
+    while (simulation.GetEnemies().size() < target)
+    {
+        simulation.AddEnemy(random_.NextInt(2) == 0 ? SPAWN_NAVY : SPAWN_MONSTER, RingPosition(centre));
+    }
+
+    target = GetTarget(STRESS_COLLECTIBLES, tick);
+    while (simulation.GetCollectibles().size() < target)
+    {
+        simulation.AddCollectible(random_.NextInt(3), RingPosition(centre));
+    }
+
+    // the players own shots count towards the projectiles, the volley only makes up the difference
+    target = GetTarget(STRESS_PROJECTILES, tick);
+    while (simulation.GetBullets().size() < target)
+    {
+        FireVolley(simulation, centre);
+    }
+
+    target = GetTarget(STRESS_EMITTERS, tick);
+    while (simulation.GetEmitters().size() < target)
+    {
+        simulation.AddEmitter(RingPosition(centre));
+    }
+}
+
+
+uint8_t StressScenario::GetKeys(int tick) const
+{
+    if (script_.empty()) return 0;
+
+    int t = tick % script_length_;
+    for (int i = 0; i < script_.size(); i++)
+    {
+        if (t < script_[i].ticks) return script_[i].keys;
+        t -= script_[i].ticks;
+    }
+    return 0;
+}
+
+
+void StressScenario::RecordFrame(int tick, double frame_time, const Simulation &simulation)
+{
+    StressFrame frame;
+    frame.tick = tick;
+    frame.time = static_cast<float>(frame_time);
+    frame.counts[STRESS_ENEMIES] = simulation.GetEnemies().size();
+    frame.counts[STRESS_COLLECTIBLES] = simulation.GetCollectibles().size();
+    frame.counts[STRESS_PROJECTILES] = simulation.GetBullets().size() + simulation.GetSpikes().size();
+    frame.counts[STRESS_EMITTERS] = simulation.GetEmitters().size();
+    frame.entities = simulation.GetNumEntities();
+    frames_.push_back(frame);
+}
+
+
+void StressScenario::PrintCounts(std::ostream &out, const StressFrame &frame) const
+{
+    for (int i = 0; i < STRESS_NUM_KINDS; i++)
+    {
+        out << kind_names_g[i] << " " << frame.counts[i] << ", ";
+    }
+    out << frame.entities << " entities";
+}
+
+
+void StressScenario::Report(std::ostream &out) const
+{
+    out << "Stress scenario " << filename_ << ", seed " << seed_ << ", " << frames_.size() << " of " << ticks_ << " frames, budget " << budget_ * 1000.0 << " ms" << std::endl;
+    if (frames_.empty()) return;
+
+    std::vector<float> sorted(frames_.size());
+    for (int i = 0; i < frames_.size(); i++)
+    {
+        sorted[i] = frames_[i].time;
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    int over = sorted.end() - std::upper_bound(sorted.begin(), sorted.end(), static_cast<float>(budget_));
+    out << "  frame time p50 " << Percentile(sorted, 0.5) * 1000.0f << " ms, p90 " << Percentile(sorted, 0.9) * 1000.0f
+        << " ms, p99 " << Percentile(sorted, 0.99) * 1000.0f << " ms, max " << sorted.back() * 1000.0f << " ms" << std::endl;
+    out << "  " << over << " frames over budget (" << 100.0 * over / frames_.size() << "%)" << std::endl;
+
+    // the first single frame over, and the first time the average over a window of frames went over
+    int first_over = -1;
+    int first_sustained = -1;
+    double window = 0.0;
+    for (int i = 0; i < frames_.size(); i++)
+    {
+        if (first_over < 0 && frames_[i].time > budget_) first_over = i;
+
+        window += frames_[i].time;
+        if (i >= STRESS_WINDOW) window -= frames_[i - STRESS_WINDOW].time;
+        if (first_sustained < 0 && i >= STRESS_WINDOW - 1 && window / STRESS_WINDOW > budget_) first_sustained = i;
+    }
+
+    if (first_over >= 0)
+    {
+        out << "  first frame over budget: tick " << frames_[first_over].tick << " (" << frames_[first_over].time * 1000.0f << " ms) with ";
+        PrintCounts(out, frames_[first_over]);
+        out << std::endl;
+    }
+    if (first_sustained >= 0)
+    {
+        out << "  average of " << STRESS_WINDOW << " frames over budget from tick " << frames_[first_sustained].tick << " with ";
+        PrintCounts(out, frames_[first_sustained]);
+        out << std::endl;
+    }
+    if (first_over < 0)
+    {
+        out << "  the budget was never exceeded" << std::endl;
+    }
+
+    // the run cut into slices so the cost can be read against the counts as they ramp up
+    const int slices = 10;
+    int slice_size = (frames_.size() + slices - 1) / slices;
+    out << "  ticks          p50 ms    p99 ms   counts at the end of the slice" << std::endl;
+    for (int s = 0; s * slice_size < frames_.size(); s++)
+    {
+        int begin = s * slice_size;
+        int end = std::min(begin + slice_size, static_cast<int>(frames_.size()));
+
+        std::vector<float> slice;
+        for (int i = begin; i < end; i++)
+        {
+            slice.push_back(frames_[i].time);
+        }
+        std::sort(slice.begin(), slice.end());
+
+        char row[64];
+        snprintf(row, sizeof(row), "  %5d-%-6d %9.3f %9.3f   ", frames_[begin].tick, frames_[end - 1].tick, Percentile(slice, 0.5) * 1000.0f, Percentile(slice, 0.99) * 1000.0f);
+        out << row;
+        PrintCounts(out, frames_[end - 1]);
+        out << std::endl;
+    }
+}
+
+} // namespace game
@@ -0,0 +1,135 @@
+#ifndef STRESS_SCENARIO_H_
+#define STRESS_SCENARIO_H_
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <stdint.h>
+
+#include "simulation.h"
+#include "random.h"
+
+// the kinds of entity a scenario keeps topped up
+#define STRESS_ENEMIES 0
+#define STRESS_COLLECTIBLES 1
+#define STRESS_PROJECTILES 2
+#define STRESS_EMITTERS 3
+#define STRESS_NUM_KINDS 4
+
+// how the scenario fires its own projectiles
+#define STRESS_VOLLEY_RANDOM 0
+#define STRESS_VOLLEY_SPIRAL 1
+#define STRESS_VOLLEY_AIMED 2
+
+// frames averaged together to decide the budget is being blown all the time and not just by one hitch
+#define STRESS_WINDOW 30
+
+namespace game {
+
+    // How many of a kind to keep in the world, going in a straight line from start to end over the run
+    struct StressRamp {
+        int start;
+        int end;
+    };
+
+    // The player holds these keys (INPUT_KEY_ bits) for this many ticks
+    struct StressStep {
+        int ticks;
+        uint8_t keys;
+    };
+
+    // What one frame cost and what was in the world at the time
+    struct StressFrame {
+        int tick;
+        float time;
+        int counts[STRESS_NUM_KINDS];
+        int entities;
+    };
+
+    /*
+        StressScenario drives a stress run from a scenario file
+        Before every frame it tops the simulation up with enemies, collectibles, projectiles and particle
+        emitters, ramping the counts up over the run, and plays a looping script of keys for the player
+        Every frame time is recorded with the counts next to it, and the report gives the percentiles
+        and the counts at which the frame budget was first blown
+    */
+    class StressScenario {
+
+        public:
+            // Constructor
+            StressScenario(void);
+
+            // Read a scenario file, throws if it cant be opened or a line doesnt make sense
+            void Load(const std::string &filename);
+
+            // How many of a kind the scenario wants in the world at a tick
+            int GetTarget(int kind, int tick) const;
+
+            // Top the simulation up to the counts for this tick
+            void Populate(Simulation &simulation, int tick);
+
+            // The keys the script holds down at a tick
+            uint8_t GetKeys(int tick) const;
+
+            // Remember how long the frame at a tick took (in seconds) and what was in the world
+            void RecordFrame(int tick, double frame_time, const Simulation &simulation);
+
+            // Print the frame time percentiles and where the budget was exceeded
+            void Report(std::ostream &out) const;
+
+            // Getters
+            inline bool IsLoaded(void) const { return !filename_.empty(); }
+            inline int GetTicks(void) const { return ticks_; }
+            inline double GetDeltaTime(void) const { return delta_time_; }
+            inline double GetBudget(void) const { return budget_; }
+            inline uint64_t GetSeed(void) const { return seed_; }
+
+        private:
+            // the file we were loaded from
+            std::string filename_;
+
+            // how long the run is and the step every frame simulates
+            int ticks_;
+            double delta_time_;
+
+            // the frame budget in seconds
+            double budget_;
+
+            uint64_t seed_;
+
+            // everything is spawned in a ring around the player
+            float min_radius_;
+            float max_radius_;
+
+            // the counts to keep in the world
+            StressRamp ramps_[STRESS_NUM_KINDS];
+
+            // how the extra projectiles are fired and how fast they go
+            int volley_;
+            float volley_speed_;
+            float volley_angle_;
+
+            // the keys script, looped, and the number of ticks it takes to go through once
+            std::vector<StressStep> script_;
+            int script_length_;
+
+            // where the top ups are placed, kept apart from the games own streams
+            Random random_;
+
+            // one per recorded frame
+            std::vector<StressFrame> frames_;
+
+            // A point in the ring around the centre
+            glm::vec3 RingPosition(const glm::vec3 &centre);
+
+            // Fire one of the scenarios own projectiles
+            void FireVolley(Simulation &simulation, const glm::vec3 &centre);
+
+            // Print the counts a frame was recorded with
+            void PrintCounts(std::ostream &out, const StressFrame &frame) const;
+
+    }; // class StressScenario
+
+} // namespace game
+
+#endif // STRESS_SCENARIO_H_
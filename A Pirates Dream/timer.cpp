@@ -1,51 +1,99 @@
-#include <GLFW/glfw3.h>
-#include <iostream>
-
-#include "timer.h"
-
-namespace game {
-
-Timer::Timer(void)
-{
-    // by default a timer is not active
-    is_active_ = false;
-}
-
-
-Timer::~Timer(void)
-{
-}
-
-
-void Timer::Start(float end_time)
-{
-    // set the start time to now
-    start_time_ = glfwGetTime();
-
-    // mark how long we want the timer to run   
-    end_time_ = end_time;
-
-    // and set the timer to be active
-    is_active_ = true;
-}
-
-
-
-int Timer::Finished(int i)
-{
-    // if the timer hasnt been activated than we can have possibly reached the end
-    if (!is_active_) return 2;
-
-    // if the current time - when we started the timer is greater than the number of seconds we want to run the timer than the timer has finished
-    if (glfwGetTime() - start_time_ > end_time_) 
-    {
-        // lets set it back to inactive so we can tell if we can use it again
-        if (i == 1) is_active_ = false;
-        return 1;
-    }
-    
-    // otherwise return false
-    return 0;
-}
-
-} // namespace game
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "timer.h"
+
+namespace game {
+
+Timer::Timer(TimerWheel *wheel)
+{
+    wheel_ = wheel;
+
+    // by default a timer is not active
+    is_active_ = false;
+    expired_ = false;
+    start_time_ = 0.0;
+    end_time_ = 0.0;
+
+    // when our entry comes due we mark ourselves as done and let the owner know
+    entry_.callback_ = [this]() {
+        expired_ = true;
+        if (callback_) callback_();
+    };
+}
+
+
+Timer::~Timer(void)
+{
+    // make sure the wheel doesnt call back into us after were gone
+    if (entry_.wheel_) entry_.wheel_->Cancel(&entry_);
+}
+
+
+void Timer::Start(double end_time)
+{
+    if (!wheel_) {
+        throw(std::runtime_error(std::string("Timer started without an active timer wheel")));
+    }
+
+    // set the start time to now
+    start_time_ = wheel_->GetTime();
+
+    // mark how long we want the timer to run   
+    end_time_ = end_time;
+
+    // and set the timer to be active
+    is_active_ = true;
+    expired_ = false;
+
+    // let the wheel tell us when were done
+    wheel_->Schedule(&entry_, end_time);
+}
+
+
+void Timer::Stop(void)
+{
+    if (entry_.wheel_) entry_.wheel_->Cancel(&entry_);
+
+    is_active_ = false;
+    expired_ = false;
+}
+
+
+int Timer::Finished(int i)
+{
+    // if the timer hasnt been activated than we can have possibly reached the end
+    if (!is_active_) return 2;
+
+    // the wheel marks us expired once the end time has passed
+    if (expired_) 
+    {
+        // lets set it back to inactive so we can tell if we can use it again
+        if (i == 1) is_active_ = false;
+        return 1;
+    }
+    
+    // otherwise return false
+    return 0;
+}
+
+
+void Timer::Save(Snapshot &snapshot) const
+{
+    snapshot.Write(is_active_);
+    snapshot.Write(expired_);
+    snapshot.Write(start_time_);
+    snapshot.Write(end_time_);
+}
+
+
+void Timer::Load(Snapshot &snapshot)
+{
+    snapshot.Read(is_active_);
+    snapshot.Read(expired_);
+    snapshot.Read(start_time_);
+    snapshot.Read(end_time_);
+}
+
+} // namespace game
@@ -1,38 +1,75 @@
-#ifndef TIMER_H_
-#define TIMER_H_
-
-#include <GLFW/glfw3.h>
-
-namespace game {
-
-    // A class implementing a simple timer
-    class Timer {
-
-        public:
-            // Constructor and destructor
-            Timer(void);
-            ~Timer();
-
-            // Start the timer now: end time given in seconds
-            void Start(float end_time); 
-
-            inline double GetTime(void) { return end_time_ - (glfwGetTime() - start_time_);   }
-
-            // Check if timer has finished
-            int Finished(int i = 1);
-
-        private:
-            // the time we started the timer
-            float start_time_;
-
-            // the number of seconds we want to run the timer for
-            float end_time_;
-
-            // a checker to see if the timer has been started
-            bool is_active_;
-
-    }; // class Timer
-
-} // namespace game
-
-#endif // TIMER_H_
+#ifndef TIMER_H_
+#define TIMER_H_
+
+#include <functional>
+
+#include "timer_wheel.h"
+#include "snapshot.h"
+#include "alloc_tracker.h"
+
+namespace game {
+
+    // A class implementing a simple timer
+    // The timer is driven by a TimerWheel, so checking it never has to read the system clock
+    class Timer {
+
+        public:
+            // every game object makes one, so they get a tag of their own
+            ALLOC_TAGGED_NEW(ALLOC_TAG_TIMER)
+
+            // Constructor and destructor
+            // By default the timer runs on the wheel that is active on this thread
+            Timer(TimerWheel *wheel = TimerWheel::GetActive());
+            ~Timer();
+
+            // Start the timer now: end time given in seconds
+            void Start(double end_time); 
+
+            // Stop the timer without it finishing
+            void Stop(void);
+
+            inline double GetTime(void) const { return end_time_ - (wheel_->GetTime() - start_time_); }
+
+            // Check if timer has finished
+            int Finished(int i = 1);
+
+            // Check if the timer has been started and not yet collected
+            inline bool IsActive(void) const { return is_active_; }
+
+            // Set a function to be called by the wheel as soon as the timer runs out
+            inline void SetCallback(std::function<void(void)> callback) { callback_ = callback; }
+
+            // Save or restore where the timer is at, the wheel puts its entry back (see TimerWheel::Load)
+            void Save(Snapshot &snapshot) const;
+            void Load(Snapshot &snapshot);
+
+            // Our slot on the wheel
+            inline TimerEntry *GetEntry(void) { return &entry_; }
+
+        private:
+            // the wheel that drives this timer
+            TimerWheel *wheel_;
+
+            // our slot on the wheel
+            TimerEntry entry_;
+
+            // the time we started the timer
+            double start_time_;
+
+            // the number of seconds we want to run the timer for
+            double end_time_;
+
+            // a checker to see if the timer has been started
+            bool is_active_;
+
+            // set by the wheel once the end time has passed
+            bool expired_;
+
+            // called when the timer runs out
+            std::function<void(void)> callback_;
+
+    }; // class Timer
+
+} // namespace game
+
+#endif // TIMER_H_
@@ -0,0 +1,319 @@
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#include "timer_wheel.h"
+
+namespace game {
+
+// the wheel timers on this thread are started on
+static thread_local TimerWheel *active_wheel_g = nullptr;
+
+
+// small helpers for the circular slot lists
+static inline void Unlink(TimerEntry *entry)
+{
+    entry->prev_->next_ = entry->next_;
+    entry->next_->prev_ = entry->prev_;
+    entry->prev_ = nullptr;
+    entry->next_ = nullptr;
+}
+
+
+static inline void PushBack(TimerEntry *head, TimerEntry *entry)
+{
+    entry->prev_ = head->prev_;
+    entry->next_ = head;
+    head->prev_->next_ = entry;
+    head->prev_ = entry;
+}
+
+
+static inline void Splice(TimerEntry *from, TimerEntry *to)
+{
+    // move the whole list hanging off from onto the empty list to
+    if (from->next_ == from) return;
+
+    to->next_ = from->next_;
+    to->prev_ = from->prev_;
+    to->next_->prev_ = to;
+    to->prev_->next_ = to;
+
+    from->next_ = from;
+    from->prev_ = from;
+}
+
+
+TimerWheel::TimerWheel(double tick_length)
+{
+    tick_length_ = tick_length;
+    time_ = 0.0;
+    current_tick_ = 0;
+    count_ = 0;
+
+    // every slot starts as an empty circular list
+    for (int l = 0; l < TIMER_WHEEL_LEVELS; l++)
+    {
+        for (int s = 0; s < TIMER_WHEEL_SLOTS; s++)
+        {
+            slots_[l][s].prev_ = &slots_[l][s];
+            slots_[l][s].next_ = &slots_[l][s];
+        }
+    }
+}
+
+
+TimerWheel::~TimerWheel()
+{
+    // detach anything still pending so its owner doesnt try to cancel it on a dead wheel later
+    for (int l = 0; l < TIMER_WHEEL_LEVELS; l++)
+    {
+        for (int s = 0; s < TIMER_WHEEL_SLOTS; s++)
+        {
+            TimerEntry *head = &slots_[l][s];
+            while (head->next_ != head)
+            {
+                TimerEntry *entry = head->next_;
+                Unlink(entry);
+                entry->wheel_ = nullptr;
+            }
+        }
+    }
+
+    if (active_wheel_g == this) active_wheel_g = nullptr;
+}
+
+
+void TimerWheel::SetActive(TimerWheel *wheel)
+{
+    active_wheel_g = wheel;
+}
+
+
+TimerWheel *TimerWheel::GetActive(void)
+{
+    return active_wheel_g;
+}
+
+
+void TimerWheel::Schedule(TimerEntry *entry, double delay)
+{
+    if (entry->IsScheduled()) Cancel(entry);
+
+    // round up so a timer never fires early, and always wait at least one tick
+    double ticks = ceil(delay / tick_length_);
+    if (ticks < 1.0) ticks = 1.0;
+
+    entry->expiry_ = current_tick_ + static_cast<uint64_t>(ticks);
+    entry->wheel_ = this;
+
+    Place(entry);
+    count_++;
+}
+
+
+void TimerWheel::Cancel(TimerEntry *entry)
+{
+    if (!entry->IsScheduled()) return;
+
+    Unlink(entry);
+    count_--;
+}
+
+
+void TimerWheel::Place(TimerEntry *entry)
+{
+    // anything already due goes into the slot we are about to process
+    if (entry->expiry_ <= current_tick_)
+    {
+        PushBack(&slots_[0][current_tick_ & (TIMER_WHEEL_SLOTS - 1)], entry);
+        return;
+    }
+
+    uint64_t delta = entry->expiry_ - current_tick_;
+    uint64_t expiry = entry->expiry_;
+
+    // find the lowest level whose range covers the delay
+    for (int l = 0; l < TIMER_WHEEL_LEVELS; l++)
+    {
+        if (delta < (static_cast<uint64_t>(1) << (TIMER_WHEEL_BITS * (l + 1))))
+        {
+            int index = static_cast<int>((expiry >> (TIMER_WHEEL_BITS * l)) & (TIMER_WHEEL_SLOTS - 1));
+            PushBack(&slots_[l][index], entry);
+            return;
+        }
+    }
+
+    // further out than the wheel can hold, park it in the furthest top level slot
+    // it gets placed again with its real expiry when that slot cascades
+    int top = TIMER_WHEEL_LEVELS - 1;
+    uint64_t furthest = current_tick_ + (static_cast<uint64_t>(1) << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS)) - 1;
+    int index = static_cast<int>((furthest >> (TIMER_WHEEL_BITS * top)) & (TIMER_WHEEL_SLOTS - 1));
+    PushBack(&slots_[top][index], entry);
+}
+
+
+void TimerWheel::Cascade(int level, int index)
+{
+    TimerEntry pending;
+    pending.prev_ = &pending;
+    pending.next_ = &pending;
+    Splice(&slots_[level][index], &pending);
+
+    while (pending.next_ != &pending)
+    {
+        TimerEntry *entry = pending.next_;
+        Unlink(entry);
+        Place(entry);
+    }
+}
+
+
+void TimerWheel::Expire(int index)
+{
+    // take the list out first so callbacks can freely schedule or cancel other entries
+    TimerEntry pending;
+    pending.prev_ = &pending;
+    pending.next_ = &pending;
+    Splice(&slots_[0][index], &pending);
+
+    while (pending.next_ != &pending)
+    {
+        TimerEntry *entry = pending.next_;
+        Unlink(entry);
+        count_--;
+
+        if (entry->callback_) entry->callback_();
+    }
+}
+
+
+void TimerWheel::Advance(double delta_time)
+{
+    time_ += delta_time;
+
+    uint64_t target = static_cast<uint64_t>(time_ / tick_length_);
+
+    // nothing pending so theres nothing to walk through
+    if (count_ == 0)
+    {
+        if (target > current_tick_) current_tick_ = target;
+        return;
+    }
+
+    while (current_tick_ < target)
+    {
+        current_tick_++;
+
+        // when a level wraps around we pull the next slot of the level above down
+        for (int l = 1; l < TIMER_WHEEL_LEVELS; l++)
+        {
+            if ((current_tick_ & ((static_cast<uint64_t>(1) << (TIMER_WHEEL_BITS * l)) - 1)) != 0) break;
+
+            int index = static_cast<int>((current_tick_ >> (TIMER_WHEEL_BITS * l)) & (TIMER_WHEEL_SLOTS - 1));
+            Cascade(l, index);
+        }
+
+        Expire(static_cast<int>(current_tick_ & (TIMER_WHEEL_SLOTS - 1)));
+
+        // once everything has fired we can jump straight to the end
+        if (count_ == 0)
+        {
+            current_tick_ = target;
+            break;
+        }
+    }
+}
+
+
+void TimerWheel::Save(Snapshot &snapshot, const std::vector<TimerEntry*> &entries) const
+{
+    std::unordered_map<const TimerEntry*, int> index;
+    for (int i = 0; i < entries.size(); i++)
+    {
+        index[entries[i]] = i;
+    }
+
+    snapshot.Write(time_);
+    snapshot.Write(current_tick_);
+
+    // anything scheduled that isnt in the list (nobody can put it back) is left out
+    int count = 0;
+    for (int l = 0; l < TIMER_WHEEL_LEVELS; l++)
+    {
+        for (int s = 0; s < TIMER_WHEEL_SLOTS; s++)
+        {
+            const TimerEntry *head = &slots_[l][s];
+            for (const TimerEntry *entry = head->next_; entry != head; entry = entry->next_)
+            {
+                if (index.count(entry)) count++;
+            }
+        }
+    }
+    snapshot.Write(count);
+
+    for (int l = 0; l < TIMER_WHEEL_LEVELS; l++)
+    {
+        for (int s = 0; s < TIMER_WHEEL_SLOTS; s++)
+        {
+            const TimerEntry *head = &slots_[l][s];
+            for (const TimerEntry *entry = head->next_; entry != head; entry = entry->next_)
+            {
+                std::unordered_map<const TimerEntry*, int>::const_iterator it = index.find(entry);
+                if (it == index.end()) continue;
+
+                int slot = l * TIMER_WHEEL_SLOTS + s;
+                snapshot.Write(slot);
+                snapshot.Write(it->second);
+                snapshot.Write(entry->expiry_);
+            }
+        }
+    }
+}
+
+
+void TimerWheel::Load(Snapshot &snapshot, const std::vector<TimerEntry*> &entries)
+{
+    // take everything off, the owners state says whether it is running and the snapshot where it goes
+    for (int l = 0; l < TIMER_WHEEL_LEVELS; l++)
+    {
+        for (int s = 0; s < TIMER_WHEEL_SLOTS; s++)
+        {
+            TimerEntry *head = &slots_[l][s];
+            while (head->next_ != head)
+            {
+                Unlink(head->next_);
+            }
+        }
+    }
+    count_ = 0;
+
+    snapshot.Read(time_);
+    snapshot.Read(current_tick_);
+
+    int count;
+    snapshot.Read(count);
+    for (int i = 0; i < count; i++)
+    {
+        int slot, which;
+        uint64_t expiry;
+        snapshot.Read(slot);
+        snapshot.Read(which);
+        snapshot.Read(expiry);
+
+        if (slot < 0 || slot >= TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS || which < 0 || which >= entries.size() || entries[which]->IsScheduled())
+        {
+            throw(std::runtime_error(std::string("Snapshot has a timer the wheel cant put back")));
+        }
+
+        // straight onto the end of its old slot, so entries that share a slot keep their order
+        TimerEntry *entry = entries[which];
+        entry->expiry_ = expiry;
+        entry->wheel_ = this;
+        PushBack(&slots_[slot / TIMER_WHEEL_SLOTS][slot % TIMER_WHEEL_SLOTS], entry);
+        count_++;
+    }
+}
+
+} // namespace game
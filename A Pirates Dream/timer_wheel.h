@@ -0,0 +1,123 @@
+#ifndef TIMER_WHEEL_H_
+#define TIMER_WHEEL_H_
+
+#include <functional>
+#include <vector>
+#include <stdint.h>
+
+#include "snapshot.h"
+
+// number of slots per level (a power of two) and number of levels in the wheel
+#define TIMER_WHEEL_BITS 6
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_LEVELS 4
+
+namespace game {
+
+    class TimerWheel;
+
+    // A single pending expiry, intrusively linked into one of the wheel's slots
+    // Owners (usually a Timer) keep the entry alive for as long as it is scheduled
+    struct TimerEntry {
+        TimerEntry(void) : prev_(nullptr), next_(nullptr), expiry_(0), wheel_(nullptr) {}
+
+        inline bool IsScheduled(void) const { return next_ != nullptr; }
+
+        // links for the slot list, null when the entry is not scheduled
+        TimerEntry *prev_;
+        TimerEntry *next_;
+
+        // the tick on which the entry fires
+        uint64_t expiry_;
+
+        // the wheel the entry is scheduled on
+        TimerWheel *wheel_;
+
+        // called once when the entry expires
+        std::function<void(void)> callback_;
+    };
+
+    /*
+        A hierarchical timer wheel driven by the frame clock
+        Scheduling and cancelling are O(1), and advancing the wheel only touches the slots
+        that come due, so the per frame cost depends on the timers firing and not on how
+        many timers exist
+    */
+    class TimerWheel {
+
+        public:
+            // Constructor and destructor, tick_length is the resolution of the wheel in seconds
+            TimerWheel(double tick_length = 1.0 / 120.0);
+            ~TimerWheel();
+
+            // Move the clock forward and fire every entry that came due
+            void Advance(double delta_time);
+
+            // Schedule an entry to fire delay seconds from now (reschedules it if it is already pending)
+            void Schedule(TimerEntry *entry, double delay);
+
+            // Remove an entry without firing it
+            void Cancel(TimerEntry *entry);
+
+            // Save the clock and the slot every scheduled entry sits in, in the order they sit there
+            // entries are all the entries that could be scheduled, each is written as its place in that list
+            void Save(Snapshot &snapshot, const std::vector<TimerEntry*> &entries) const;
+
+            // Drop whatever is scheduled now and put the saved clock and entries back exactly where they were,
+            // so they fire on the same ticks and in the same order as they would have, entries has to list
+            // the same entries in the same order as when it was saved
+            void Load(Snapshot &snapshot, const std::vector<TimerEntry*> &entries);
+
+            // Getters
+            inline double GetTime(void) const { return time_; }
+            inline uint64_t GetTick(void) const { return current_tick_; }
+            inline int GetCount(void) const { return count_; }
+
+            // The wheel that newly started timers on this thread will use
+            static void SetActive(TimerWheel *wheel);
+            static TimerWheel *GetActive(void);
+
+        private:
+            // the sentinel heads of every slot list
+            TimerEntry slots_[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+
+            // the length of one tick in seconds
+            double tick_length_;
+
+            // the time on the frame clock, kept in double so it doesnt drift over long sessions
+            double time_;
+
+            // the last tick we processed
+            uint64_t current_tick_;
+
+            // the number of entries currently scheduled
+            int count_;
+
+            // Put an entry into the slot matching its expiry relative to the current tick
+            void Place(TimerEntry *entry);
+
+            // Move every entry of a higher level slot down to where it now belongs
+            void Cascade(int level, int index);
+
+            // Fire every entry in the current level 0 slot
+            void Expire(int index);
+
+    }; // class TimerWheel
+
+
+    // Makes a wheel the active one for the block it is declared in and puts back whichever was active before,
+    // so simulations can take turns on a thread without leaving their wheel behind for the next one
+    class TimerWheelScope {
+
+        public:
+            inline TimerWheelScope(TimerWheel *wheel) : previous_(TimerWheel::GetActive()) { TimerWheel::SetActive(wheel); }
+            inline ~TimerWheelScope() { TimerWheel::SetActive(previous_); }
+
+        private:
+            TimerWheel *previous_;
+
+    }; // class TimerWheelScope
+
+} // namespace game
+
+#endif // TIMER_WHEEL_H_
@@ -0,0 +1,101 @@
+#include <cmath>
+
+#include "transform.h"
+
+namespace game {
+
+Transform::Transform(void)
+{
+    position_ = glm::vec3(0.0f);
+    angle_ = 0.0f;
+    scale_ = 1.0f;
+    parent_ = nullptr;
+    follow_ = TRANSFORM_FOLLOW_FRAME;
+    frame_ = glm::mat4(1.0f);
+    world_ = glm::mat4(1.0f);
+    dirty_ = true;
+    version_ = 0;
+    parent_version_ = 0;
+}
+
+
+void Transform::SetLocal(const glm::vec3 &position, float angle, float scale)
+{
+    // most objects only move some of the time, comparing is a lot cheaper than rebuilding
+    if (position == position_ && angle == angle_ && scale == scale_) return;
+
+    position_ = position;
+    angle_ = angle;
+    scale_ = scale;
+    dirty_ = true;
+}
+
+
+void Transform::SetParent(Transform *parent, int follow)
+{
+    parent_ = parent;
+    follow_ = follow;
+    dirty_ = true;
+}
+
+
+const glm::mat4 &Transform::GetWorldMatrix(void)
+{
+    Evaluate();
+    return world_;
+}
+
+
+glm::vec3 Transform::GetWorldPosition(void)
+{
+    Evaluate();
+    return glm::vec3(frame_[3]);
+}
+
+
+void Transform::Evaluate(void)
+{
+    // anything above us has to be right before we can be
+    if (parent_)
+    {
+        parent_->Evaluate();
+        if (parent_->version_ != parent_version_) dirty_ = true;
+    }
+
+    if (!dirty_) return;
+
+    // translation * rotation about z, written out instead of multiplying two full matrices
+    float c = cos(angle_);
+    float s = sin(angle_);
+    glm::mat4 local(1.0f);
+    local[0][0] = c;
+    local[0][1] = s;
+    local[1][0] = -s;
+    local[1][1] = c;
+    local[3] = glm::vec4(position_, 1.0f);
+
+    if (!parent_)
+    {
+        frame_ = local;
+    }
+    else if (follow_ == TRANSFORM_FOLLOW_POSITION)
+    {
+        frame_ = local;
+        frame_[3] = glm::vec4(glm::vec3(parent_->frame_[3]) + position_, 1.0f);
+    }
+    else
+    {
+        frame_ = parent_->frame_ * local;
+    }
+
+    // scaling only touches the x and y axes (the sprites are flat)
+    world_ = frame_;
+    world_[0] *= scale_;
+    world_[1] *= scale_;
+
+    if (parent_) parent_version_ = parent_->version_;
+    version_++;
+    dirty_ = false;
+}
+
+} // namespace game
@@ -0,0 +1,73 @@
+#ifndef TRANSFORM_H_
+#define TRANSFORM_H_
+
+#include <glm/glm.hpp>
+
+// how much of its parent a transform follows
+#define TRANSFORM_FOLLOW_FRAME 0
+#define TRANSFORM_FOLLOW_POSITION 1
+
+namespace game {
+
+    /*
+        The position, rotation and scale of an object, with the matrices that place it in the world cached
+        A transform can hang off a parent, in which case its values are relative to the parents frame
+        (the parents position and rotation, but not its scale) or only to the parents position
+        The matrices are only rebuilt when the transform or something above it changed: every transform
+        keeps a version that goes up when its frame changes, and a child that sees a new version on its
+        parent rebuilds too. Asking for a world matrix brings the parents up to date first, so a chain is
+        always worked out top down and each link at most once per change
+    */
+    class Transform {
+
+        public:
+            // Constructor, starts at the origin with no parent
+            Transform(void);
+
+            // Set the values relative to the parent (or the world), only marks the transform dirty if one changed
+            void SetLocal(const glm::vec3 &position, float angle, float scale);
+
+            // Hang the transform off another one, the parent has to outlive it (or be changed first)
+            void SetParent(Transform *parent, int follow = TRANSFORM_FOLLOW_FRAME);
+
+            // The matrix that places the object in the world (parent * translation * rotation * scale)
+            const glm::mat4 &GetWorldMatrix(void);
+
+            // Where the object ended up in the world
+            glm::vec3 GetWorldPosition(void);
+
+            // Getters
+            inline Transform *GetParent(void) const { return parent_; }
+            inline unsigned int GetVersion(void) const { return version_; }
+
+        private:
+            // the local values
+            glm::vec3 position_;
+            float angle_;
+            float scale_;
+
+            // what we hang off and how much of it we follow
+            Transform *parent_;
+            int follow_;
+
+            // the world position and rotation without our scale, this is what children follow
+            glm::mat4 frame_;
+
+            // the frame with the scale on
+            glm::mat4 world_;
+
+            // the local values changed since the matrices were built
+            bool dirty_;
+
+            // goes up every time the frame is rebuilt, and the parents version when we last built ours
+            unsigned int version_;
+            unsigned int parent_version_;
+
+            // Rebuild the matrices if we or a parent changed
+            void Evaluate(void);
+
+    }; // class Transform
+
+} // namespace game
+
+#endif // TRANSFORM_H_
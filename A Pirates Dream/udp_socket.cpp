@@ -0,0 +1,227 @@
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <mutex>
+typedef int socklen_t;
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+#include "udp_socket.h"
+
+namespace game {
+
+#ifdef _WIN32
+// winsock has to be started once per process for as long as any socket is open
+static std::mutex winsock_mutex_g;
+static int winsock_users_g = 0;
+
+static void StartWinsock(void)
+{
+    std::lock_guard<std::mutex> lock(winsock_mutex_g);
+    if (winsock_users_g++ > 0) return;
+
+    WSADATA data;
+    if (WSAStartup(MAKEWORD(2, 2), &data) != 0)
+    {
+        winsock_users_g--;
+        throw(std::runtime_error(std::string("Could not start Winsock")));
+    }
+}
+
+
+static void StopWinsock(void)
+{
+    std::lock_guard<std::mutex> lock(winsock_mutex_g);
+    if (--winsock_users_g == 0) WSACleanup();
+}
+
+
+static bool WouldBlock(void)
+{
+    // a port that isnt listening shows up as a reset on the next receive, for UDP that is just a lost packet
+    int error = WSAGetLastError();
+    return error == WSAEWOULDBLOCK || error == WSAECONNRESET;
+}
+#else
+static bool WouldBlock(void)
+{
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == ECONNREFUSED || errno == EINTR;
+}
+#endif
+
+
+NetAddress NetAddress::Loopback(int port)
+{
+    return NetAddress(0x7f000001, static_cast<uint16_t>(port));
+}
+
+
+NetAddress NetAddress::Parse(const std::string &host, int port)
+{
+    unsigned int a, b, c, d;
+    char extra;
+    if (sscanf(host.c_str(), "%u.%u.%u.%u%c", &a, &b, &c, &d, &extra) != 4 || a > 255 || b > 255 || c > 255 || d > 255)
+    {
+        throw(std::runtime_error(std::string("Not an address: ") + host));
+    }
+    return NetAddress((a << 24) | (b << 16) | (c << 8) | d, static_cast<uint16_t>(port));
+}
+
+
+std::string NetAddress::ToString(void) const
+{
+    char text[32];
+    snprintf(text, sizeof(text), "%u.%u.%u.%u:%u", (host >> 24) & 255, (host >> 16) & 255, (host >> 8) & 255, host & 255, port);
+    return std::string(text);
+}
+
+
+UdpSocket::UdpSocket(void)
+{
+    handle_ = 0;
+    open_ = false;
+    port_ = 0;
+}
+
+
+UdpSocket::~UdpSocket()
+{
+    Close();
+}
+
+
+void UdpSocket::Open(int port)
+{
+    Close();
+
+#ifdef _WIN32
+    StartWinsock();
+    SOCKET s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (s == INVALID_SOCKET)
+    {
+        StopWinsock();
+        throw(std::runtime_error(std::string("Could not create a UDP socket")));
+    }
+#else
+    int s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (s < 0)
+    {
+        throw(std::runtime_error(std::string("Could not create a UDP socket")));
+    }
+#endif
+    handle_ = static_cast<uintptr_t>(s);
+    open_ = true;
+
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(static_cast<uint16_t>(port));
+
+    bool bound = bind(s, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+
+#ifdef _WIN32
+    u_long non_blocking = 1;
+    bool blocking = ioctlsocket(s, FIONBIO, &non_blocking) != 0;
+#else
+    bool blocking = fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK) != 0;
+#endif
+
+    if (!bound || blocking)
+    {
+        Close();
+        throw(std::runtime_error(std::string("Could not open UDP port ") + std::to_string(port)));
+    }
+
+    // find out which port we got if we let the system choose
+    socklen_t length = sizeof(address);
+    getsockname(s, reinterpret_cast<sockaddr*>(&address), &length);
+    port_ = ntohs(address.sin_port);
+}
+
+
+void UdpSocket::Close(void)
+{
+    if (!open_) return;
+
+#ifdef _WIN32
+    closesocket(static_cast<SOCKET>(handle_));
+    StopWinsock();
+#else
+    close(static_cast<int>(handle_));
+#endif
+    handle_ = 0;
+    open_ = false;
+    port_ = 0;
+}
+
+
+bool UdpSocket::Send(const NetAddress &to, const void *data, int size)
+{
+    if (!open_) return false;
+
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(to.host);
+    address.sin_port = htons(to.port);
+
+#ifdef _WIN32
+    int sent = sendto(static_cast<SOCKET>(handle_), static_cast<const char*>(data), size, 0, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+#else
+    int sent = static_cast<int>(sendto(static_cast<int>(handle_), data, size, 0, reinterpret_cast<sockaddr*>(&address), sizeof(address)));
+#endif
+    return sent == size;
+}
+
+
+int UdpSocket::Receive(NetAddress &from, void *data, int size)
+{
+    if (!open_) return -1;
+
+    while (true)
+    {
+        sockaddr_in address;
+        socklen_t length = sizeof(address);
+
+#ifdef _WIN32
+        int received = recvfrom(static_cast<SOCKET>(handle_), static_cast<char*>(data), size, 0, reinterpret_cast<sockaddr*>(&address), &length);
+        // the part that didnt fit is gone, what did is still worth a look
+        if (received < 0 && WSAGetLastError() == WSAEMSGSIZE) received = size;
+#else
+        int received = static_cast<int>(recvfrom(static_cast<int>(handle_), data, size, 0, reinterpret_cast<sockaddr*>(&address), &length));
+#endif
+
+        if (received >= 0)
+        {
+            from = NetAddress(ntohl(address.sin_addr.s_addr), ntohs(address.sin_port));
+            return received;
+        }
+
+        // the errors that only mean there is nothing more to read right now
+        if (!WouldBlock())
+        {
+            throw(std::runtime_error(std::string("Could not receive on UDP port ") + std::to_string(port_)));
+        }
+#ifdef _WIN32
+        if (WSAGetLastError() == WSAECONNRESET) continue;
+#else
+        if (errno == ECONNREFUSED || errno == EINTR) continue;
+#endif
+        return -1;
+    }
+}
+
+} // namespace game
@@ -0,0 +1,72 @@
+#ifndef UDP_SOCKET_H_
+#define UDP_SOCKET_H_
+
+#include <stdint.h>
+#include <string>
+
+// the biggest packet we send or take, small enough to never be split up on the way
+#define UDP_MAX_PACKET 1200
+
+namespace game {
+
+    // Where a packet goes to or came from, an IPv4 address and a port in the machines own byte order
+    struct NetAddress {
+        uint32_t host;
+        uint16_t port;
+
+        NetAddress(void) : host(0), port(0) {}
+        NetAddress(uint32_t host, uint16_t port) : host(host), port(port) {}
+
+        inline bool operator==(const NetAddress &other) const { return host == other.host && port == other.port; }
+        inline bool operator!=(const NetAddress &other) const { return !(*this == other); }
+
+        // A port on this machine (127.0.0.1)
+        static NetAddress Loopback(int port);
+
+        // A dotted address like 192.168.0.2, throws if it isnt one
+        static NetAddress Parse(const std::string &host, int port);
+
+        std::string ToString(void) const;
+    };
+
+    /*
+        A non blocking UDP socket, sending never waits and receiving gives back nothing when there is nothing
+        there, so the game can poll it once a frame along with everything else
+        Packets can go missing, come twice or come out of order, whoever uses this has to cope with that
+        Works with BSD sockets and with Winsock, which is started up with the first socket and shut down with the last
+    */
+    class UdpSocket {
+
+        public:
+            // Constructor and destructor
+            UdpSocket(void);
+            ~UdpSocket();
+
+            // Bind to a port on every address of this machine, 0 lets the system pick one, throws if it cant
+            void Open(int port);
+            void Close(void);
+
+            // Send a packet, false if it couldnt go right now (it is just dropped, like the network might)
+            bool Send(const NetAddress &to, const void *data, int size);
+
+            // Take the next waiting packet, returns its size or -1 if there isnt one
+            // Packets bigger than size are cut short
+            int Receive(NetAddress &from, void *data, int size);
+
+            // Getters
+            inline bool IsOpen(void) const { return open_; }
+            inline int GetPort(void) const { return port_; }
+
+        private:
+            // the socket handle, wide enough for a Winsock SOCKET
+            uintptr_t handle_;
+            bool open_;
+
+            // the port we ended up bound to
+            int port_;
+
+    }; // class UdpSocket
+
+} // namespace game
+
+#endif // UDP_SOCKET_H_
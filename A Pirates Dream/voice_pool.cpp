@@ -0,0 +1,300 @@
+#include <algorithm>
+#include <cmath>
+
+#include "voice_pool.h"
+
+namespace audio_manager {
+
+VoicePool::VoicePool(void)
+{
+    for (int i = 0; i < VOICE_MAX_VOICES; i++)
+    {
+        voices_[i].active = false;
+        voices_[i].source = -1;
+    }
+    for (int i = 0; i < VOICE_NUM_SOURCES; i++)
+    {
+        sources_[i] = 0;
+        bound_[i] = -1;
+    }
+    backend_ = NULL;
+    initialized_ = false;
+    listener_x_ = listener_y_ = listener_z_ = 0.0f;
+    ranked_.reserve(VOICE_MAX_VOICES);
+}
+
+
+VoicePool::~VoicePool()
+{
+    ShutDown();
+}
+
+
+void VoicePool::Init(AudioBackend *backend)
+{
+    if (initialized_) return;
+
+    backend_ = backend;
+    for (int i = 0; i < VOICE_NUM_SOURCES; i++)
+    {
+        sources_[i] = backend_->CreateSource();
+        // the same fall off we rank the voices with
+        backend_->SetSourceDistance(sources_[i], VOICE_REFERENCE_DISTANCE, VOICE_MAX_DISTANCE, VOICE_ROLLOFF);
+        bound_[i] = -1;
+    }
+    initialized_ = true;
+}
+
+
+void VoicePool::ShutDown(void)
+{
+    if (!initialized_) return;
+
+    for (int i = 0; i < VOICE_MAX_VOICES; i++)
+    {
+        Stop(i);
+    }
+    for (int i = 0; i < VOICE_NUM_SOURCES; i++)
+    {
+        backend_->DeleteSource(sources_[i]);
+    }
+    initialized_ = false;
+}
+
+
+int VoicePool::Play(unsigned int buffer, int channels, double length, int sound, int priority, float gain, bool loop, float x, float y, float z)
+{
+    if (!initialized_) return -1;
+
+    Voice voice;
+    voice.active = true;
+    voice.buffer = buffer;
+    voice.channels = channels;
+    voice.length = length;
+    voice.sound = sound;
+    voice.priority = priority;
+    voice.gain = gain;
+    voice.loop = loop;
+    voice.x = x;
+    voice.y = y;
+    voice.z = z;
+    voice.elapsed = 0.0;
+    voice.started = false;
+    voice.audibility = Audibility(voice);
+    voice.source = -1;
+
+    // a free voice, or else the least important one if the new one matters more
+    int slot = -1;
+    for (int i = 0; i < VOICE_MAX_VOICES; i++)
+    {
+        if (!voices_[i].active)
+        {
+            slot = i;
+            break;
+        }
+        if (slot < 0 || voices_[i].priority < voices_[slot].priority ||
+            (voices_[i].priority == voices_[slot].priority && voices_[i].audibility < voices_[slot].audibility))
+        {
+            slot = i;
+        }
+    }
+
+    if (voices_[slot].active)
+    {
+        const Voice &victim = voices_[slot];
+        if (victim.priority > priority || (victim.priority == priority && victim.audibility >= voice.audibility)) return -1;
+        Stop(slot);
+    }
+
+    // it gets a source on the next update, along with everything else that started this frame
+    voices_[slot] = voice;
+    return slot;
+}
+
+
+void VoicePool::Stop(int voice)
+{
+    if (voice < 0 || voice >= VOICE_MAX_VOICES || !voices_[voice].active) return;
+    Unbind(voice);
+    voices_[voice].active = false;
+}
+
+
+void VoicePool::StopSound(int sound)
+{
+    for (int i = 0; i < VOICE_MAX_VOICES; i++)
+    {
+        if (voices_[i].active && voices_[i].sound == sound) Stop(i);
+    }
+}
+
+
+void VoicePool::SetListenerPosition(float x, float y, float z)
+{
+    listener_x_ = x;
+    listener_y_ = y;
+    listener_z_ = z;
+}
+
+
+void VoicePool::Update(double delta_time)
+{
+    if (!initialized_) return;
+
+    ranked_.clear();
+    for (int i = 0; i < VOICE_MAX_VOICES; i++)
+    {
+        Voice &voice = voices_[i];
+        if (!voice.active) continue;
+
+        if (voice.started) voice.elapsed += delta_time;
+        voice.started = true;
+
+        // a bound voice can run out a little before our clock says so, trust the source
+        bool ended = !voice.loop && voice.elapsed >= voice.length;
+        if (voice.source >= 0 && !voice.loop && backend_->GetSourceState(sources_[voice.source]) == AUDIO_SOURCE_STOPPED)
+        {
+            ended = true;
+        }
+        if (ended)
+        {
+            Stop(i);
+            continue;
+        }
+
+        voice.audibility = Audibility(voice);
+        ranked_.push_back(i);
+    }
+
+    // most important first, priority before loudness
+    std::sort(ranked_.begin(), ranked_.end(), [this](int a, int b) {
+        if (voices_[a].priority != voices_[b].priority) return voices_[a].priority > voices_[b].priority;
+        return voices_[a].audibility > voices_[b].audibility;
+    });
+
+    // anything past the number of sources (or too quiet to hear) goes virtual
+    bool keep[VOICE_MAX_VOICES];
+    int wanted = 0;
+    for (int i = 0; i < ranked_.size(); i++)
+    {
+        int index = ranked_[i];
+        keep[index] = wanted < VOICE_NUM_SOURCES && voices_[index].audibility >= VOICE_MIN_AUDIBLE;
+        if (keep[index]) wanted++;
+        else Unbind(index);
+    }
+
+    // and the ones that made the cut but dont have a source yet take the ones just freed
+    int source = 0;
+    for (int i = 0; i < ranked_.size(); i++)
+    {
+        int index = ranked_[i];
+        Voice &voice = voices_[index];
+        if (!keep[index]) continue;
+
+        if (voice.source >= 0)
+        {
+            // only mono sounds get placed, the gain of anything else is the fall off we worked out
+            if (voice.channels != 1) backend_->SetSourceGain(sources_[voice.source], voice.audibility);
+            continue;
+        }
+
+        while (bound_[source] >= 0) source++;
+        Bind(index, source);
+    }
+}
+
+
+bool VoicePool::IsPlaying(int sound) const
+{
+    for (int i = 0; i < VOICE_MAX_VOICES; i++)
+    {
+        if (voices_[i].active && voices_[i].sound == sound) return true;
+    }
+    return false;
+}
+
+
+bool VoicePool::AnyPlaying(void) const
+{
+    return GetNumVoices() > 0;
+}
+
+
+int VoicePool::GetNumVoices(void) const
+{
+    int count = 0;
+    for (int i = 0; i < VOICE_MAX_VOICES; i++)
+    {
+        if (voices_[i].active) count++;
+    }
+    return count;
+}
+
+
+int VoicePool::GetNumBound(void) const
+{
+    int count = 0;
+    for (int i = 0; i < VOICE_NUM_SOURCES; i++)
+    {
+        if (bound_[i] >= 0) count++;
+    }
+    return count;
+}
+
+
+float VoicePool::Audibility(const Voice &voice) const
+{
+    float dx = voice.x - listener_x_;
+    float dy = voice.y - listener_y_;
+    float dz = voice.z - listener_z_;
+    float distance = sqrt(dx * dx + dy * dy + dz * dz);
+
+    // inverse distance, clamped to the reference and max distances
+    if (distance < VOICE_REFERENCE_DISTANCE) distance = VOICE_REFERENCE_DISTANCE;
+    if (distance > VOICE_MAX_DISTANCE) distance = VOICE_MAX_DISTANCE;
+    return voice.gain * VOICE_REFERENCE_DISTANCE / (VOICE_REFERENCE_DISTANCE + VOICE_ROLLOFF * (distance - VOICE_REFERENCE_DISTANCE));
+}
+
+
+void VoicePool::Bind(int voice, int source)
+{
+    Voice &v = voices_[voice];
+    unsigned int s = sources_[source];
+
+    backend_->SetSourceBuffer(s, v.buffer);
+    backend_->SetSourceLooping(s, v.loop);
+    if (v.channels == 1)
+    {
+        backend_->SetSourceRelative(s, false);
+        backend_->SetSourcePosition(s, v.x, v.y, v.z);
+        backend_->SetSourceGain(s, v.gain);
+    }
+    else
+    {
+        backend_->SetSourceRelative(s, true);
+        backend_->SetSourcePosition(s, 0.0f, 0.0f, 0.0f);
+        backend_->SetSourceGain(s, v.audibility);
+    }
+
+    // pick up where the voice would be if it had been playing all along
+    double offset = v.loop && v.length > 0.0 ? fmod(v.elapsed, v.length) : v.elapsed;
+    backend_->SetSourceOffset(s, static_cast<float>(offset));
+    backend_->PlaySource(s);
+
+    v.source = source;
+    bound_[source] = voice;
+}
+
+
+void VoicePool::Unbind(int voice)
+{
+    Voice &v = voices_[voice];
+    if (v.source < 0) return;
+
+    backend_->StopSource(sources_[v.source]);
+    backend_->SetSourceBuffer(sources_[v.source], 0);
+    bound_[v.source] = -1;
+    v.source = -1;
+}
+
+} // namespace audio_manager
@@ -0,0 +1,118 @@
+#ifndef VOICE_POOL_H_
+#define VOICE_POOL_H_
+
+#include <vector>
+
+#include "audio_backend.h"
+
+// how many sources the pool owns, which is how many sounds can really be heard at once
+#define VOICE_NUM_SOURCES 16
+
+// how many sounds can be playing at once counting the ones not bound to a source
+#define VOICE_MAX_VOICES 64
+
+// a higher priority voice always gets a source before a lower one however quiet it is
+#define VOICE_PRIORITY_LOW 0
+#define VOICE_PRIORITY_NORMAL 1
+#define VOICE_PRIORITY_HIGH 2
+
+// how the volume falls off with distance from the listener (the same inverse distance curve OpenAL uses)
+#define VOICE_REFERENCE_DISTANCE 2.0f
+#define VOICE_MAX_DISTANCE 20.0f
+#define VOICE_ROLLOFF 1.0f
+
+// voices quieter than this are never given a source
+#define VOICE_MIN_AUDIBLE 0.01f
+
+namespace audio_manager {
+
+    /*
+        A fixed set of sources shared by every sound that gets played
+        Each play request gets a voice, and every update the voices are ranked by priority and then by how
+        loud they are where the listener is. The top VOICE_NUM_SOURCES are bound to sources and actually
+        play, the rest are virtual: they keep their place in the sound (so one that gets a source later comes
+        in where it would have been) but cost nothing, and they are dropped once they would have ended
+        So a burst of explosions layers up to the number of sources and the nearest ones are the ones heard
+    */
+    class VoicePool {
+
+        public:
+            // Constructor and destructor
+            VoicePool(void);
+            ~VoicePool();
+
+            // Make the sources on a backend, and free them again
+            void Init(AudioBackend *backend);
+            void ShutDown(void);
+
+            // Start a voice, returns its index or -1 if every voice is busy with something more important
+            // channels is the number of channels in the buffer and length how long it plays for in seconds
+            int Play(unsigned int buffer, int channels, double length, int sound, int priority, float gain, bool loop, float x, float y, float z);
+
+            // Stop a voice, or every voice playing a sound
+            void Stop(int voice);
+            void StopSound(int sound);
+
+            // Where the listener is, the voices are ranked by their distance from it
+            void SetListenerPosition(float x, float y, float z);
+
+            // Move the voices along, drop the ones that ended and rebind the sources to the most important
+            void Update(double delta_time);
+
+            // Whether a sound has a voice playing it (bound or not)
+            bool IsPlaying(int sound) const;
+            bool AnyPlaying(void) const;
+
+            // Getters
+            int GetNumVoices(void) const;
+            int GetNumBound(void) const;
+
+        private:
+            struct Voice {
+                bool active;
+                unsigned int buffer;
+                int channels;
+                double length;
+                int sound;
+                int priority;
+                float gain;
+                bool loop;
+                float x, y, z;
+
+                // how far into the sound it is, kept going while it is virtual too
+                // a voice started since the last update hasnt had any of that time yet
+                double elapsed;
+                bool started;
+
+                // how loud it would be at the listener, worked out each update
+                float audibility;
+
+                // the source it is bound to, -1 while it is virtual
+                int source;
+            };
+
+            Voice voices_[VOICE_MAX_VOICES];
+
+            // the sources, and which voice each one is playing (-1 when free)
+            AudioBackend *backend_;
+            unsigned int sources_[VOICE_NUM_SOURCES];
+            int bound_[VOICE_NUM_SOURCES];
+            bool initialized_;
+
+            float listener_x_, listener_y_, listener_z_;
+
+            // scratch list of voices for ranking them
+            std::vector<int> ranked_;
+
+            // How loud a voice is at the listener
+            float Audibility(const Voice &voice) const;
+
+            // Give a voice a source or take it back
+            void Bind(int voice, int source);
+            void Unbind(int voice);
+
+    }; // class VoicePool
+
+} // namespace audio_manager
+
+#endif // VOICE_POOL_H_
@@ -0,0 +1,304 @@
+#include <string.h>
+
+#include "wav_decoder.h"
+#include "audio_manager.h"
+
+// the wav format tags we can read
+#define WAV_FORMAT_PCM 1
+#define WAV_FORMAT_IMA_ADPCM 0x11
+
+namespace audio_manager {
+
+// How far each ADPCM step moves, and how the next step changes with each 4 bit code
+static const int ima_step_table[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+    253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+    1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+    3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487,
+    12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+static const int ima_index_table[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+
+// Little endian fields out of the header, wav files are little endian whatever the machine is
+static uint32_t ReadU32(const unsigned char *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+
+static uint16_t ReadU16(const unsigned char *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+
+// Turn one 4 bit ADPCM code into the next sample, moving the predictor and step along
+static int16_t DecodeNibble(int code, int &predictor, int &index)
+{
+    int step = ima_step_table[index];
+    int diff = step >> 3;
+    if (code & 1) diff += step >> 2;
+    if (code & 2) diff += step >> 1;
+    if (code & 4) diff += step;
+    if (code & 8) diff = -diff;
+
+    predictor += diff;
+    if (predictor < -32768) predictor = -32768;
+    if (predictor > 32767) predictor = 32767;
+
+    index += ima_index_table[code];
+    if (index < 0) index = 0;
+    if (index > 88) index = 88;
+
+    return static_cast<int16_t>(predictor);
+}
+
+
+WavDecoder::WavDecoder(void)
+{
+    file_ = NULL;
+    format_ = 0;
+    channels_ = 0;
+    sample_rate_ = 0;
+    bits_ = 0;
+    block_align_ = 0;
+    block_frames_ = 0;
+    data_start_ = 0;
+    frames_ = 0;
+    position_ = 0;
+    block_size_ = 0;
+    block_position_ = 0;
+}
+
+
+WavDecoder::~WavDecoder()
+{
+    Close();
+}
+
+
+void WavDecoder::Open(const char *filename)
+{
+    Close();
+
+    file_ = fopen(filename, "rb");
+    if (!file_)
+    {
+        throw(AudioManagerException(std::string("Error opening file ") + filename));
+    }
+
+    unsigned char header[12];
+    if (fread(header, 1, 12, file_) != 12 || memcmp(header, "RIFF", 4) != 0 || memcmp(header + 8, "WAVE", 4) != 0)
+    {
+        Close();
+        throw(AudioManagerException(std::string("Not a wav file ") + filename));
+    }
+
+    // walk the chunks until we have the format and find the samples, skipping anything else (lists, cues)
+    bool have_format = false;
+    int fact_frames = -1;
+    while (true)
+    {
+        unsigned char chunk[8];
+        if (fread(chunk, 1, 8, file_) != 8)
+        {
+            Close();
+            throw(AudioManagerException(std::string("No samples in wav file ") + filename));
+        }
+        uint32_t size = ReadU32(chunk + 4);
+
+        if (memcmp(chunk, "fmt ", 4) == 0)
+        {
+            // ADPCM adds the size of its blocks after the plain 16 bytes
+            unsigned char format[20];
+            int wanted = size < 20 ? 16 : 20;
+            if (size < 16 || fread(format, 1, wanted, file_) != wanted)
+            {
+                Close();
+                throw(AudioManagerException(std::string("Bad format in wav file ") + filename));
+            }
+            format_ = ReadU16(format);
+            channels_ = ReadU16(format + 2);
+            sample_rate_ = ReadU32(format + 4);
+            block_align_ = ReadU16(format + 12);
+            bits_ = ReadU16(format + 14);
+
+            bool supported = channels_ >= 1 && channels_ <= 2;
+            if (format_ == WAV_FORMAT_PCM)
+            {
+                supported = supported && (bits_ == 8 || bits_ == 16);
+            }
+            else if (format_ == WAV_FORMAT_IMA_ADPCM && wanted == 20)
+            {
+                // every channel starts a block with a 4 byte header holding its first sample
+                block_frames_ = ReadU16(format + 18);
+                supported = supported && bits_ == 4 && block_align_ > 4 * channels_ &&
+                            block_frames_ == (block_align_ - 4 * channels_) * 2 / channels_ + 1;
+            }
+            else
+            {
+                supported = false;
+            }
+            if (!supported)
+            {
+                Close();
+                throw(AudioManagerException(std::string("Unsupported wav format in ") + filename));
+            }
+            have_format = true;
+            fseek(file_, size - wanted + (size & 1), SEEK_CUR);
+        }
+        else if (memcmp(chunk, "fact", 4) == 0 && size >= 4)
+        {
+            // compressed files say up front how many frames they hold, the last block is usually padded
+            unsigned char fact[4];
+            if (fread(fact, 1, 4, file_) == 4) fact_frames = ReadU32(fact);
+            fseek(file_, size - 4 + (size & 1), SEEK_CUR);
+        }
+        else if (memcmp(chunk, "data", 4) == 0)
+        {
+            if (!have_format)
+            {
+                Close();
+                throw(AudioManagerException(std::string("Bad format in wav file ") + filename));
+            }
+            data_start_ = ftell(file_);
+            position_ = 0;
+            if (format_ == WAV_FORMAT_PCM)
+            {
+                frames_ = size / (channels_ * bits_ / 8);
+            }
+            else
+            {
+                int header = 4 * channels_;
+                int rest = size % block_align_;
+                frames_ = (size / block_align_) * block_frames_ + (rest >= header ? (rest - header) * 2 / channels_ + 1 : 0);
+                if (fact_frames >= 0 && fact_frames < frames_) frames_ = fact_frames;
+
+                block_bytes_.resize(block_align_);
+                block_.resize(block_frames_ * channels_);
+                block_size_ = 0;
+                block_position_ = 0;
+            }
+            return;
+        }
+        else
+        {
+            // chunks are padded to an even size
+            fseek(file_, size + (size & 1), SEEK_CUR);
+        }
+    }
+}
+
+
+void WavDecoder::Close(void)
+{
+    if (file_) fclose(file_);
+    file_ = NULL;
+}
+
+
+int WavDecoder::Read(int16_t *out, int frames)
+{
+    if (!file_) return 0;
+    if (frames > frames_ - position_) frames = frames_ - position_;
+
+    if (format_ == WAV_FORMAT_IMA_ADPCM)
+    {
+        // hand out what is left of the block, decoding the next one when it runs out
+        int done = 0;
+        while (done < frames)
+        {
+            if (block_position_ >= block_size_ && !DecodeBlock()) break;
+            int take = block_size_ - block_position_;
+            if (take > frames - done) take = frames - done;
+            memcpy(out + done * channels_, &block_[block_position_ * channels_], take * channels_ * sizeof(int16_t));
+            block_position_ += take;
+            done += take;
+        }
+        position_ += done;
+        return done;
+    }
+
+    int samples = frames * channels_;
+    int got = 0;
+    if (bits_ == 16)
+    {
+        // the samples are already what we want (on a little endian machine)
+        got = fread(out, 2, samples, file_);
+    }
+    else
+    {
+        // 8 bit samples are unsigned, centre them and scale them up
+        while (got < samples)
+        {
+            int want = samples - got < sizeof(raw_) ? samples - got : sizeof(raw_);
+            int read = fread(raw_, 1, want, file_);
+            for (int i = 0; i < read; i++)
+            {
+                out[got + i] = static_cast<int16_t>((raw_[i] - 128) << 8);
+            }
+            got += read;
+            if (read < want) break;
+        }
+    }
+
+    position_ += got / channels_;
+    return got / channels_;
+}
+
+
+void WavDecoder::Rewind(void)
+{
+    if (!file_) return;
+    fseek(file_, data_start_, SEEK_SET);
+    position_ = 0;
+    block_size_ = 0;
+    block_position_ = 0;
+}
+
+
+bool WavDecoder::DecodeBlock(void)
+{
+    int got = fread(&block_bytes_[0], 1, block_align_, file_);
+    int header = 4 * channels_;
+    if (got < header) return false;
+
+    // the last block can be cut short
+    int frames = (got - header) * 2 / channels_ + 1;
+    if (frames > block_frames_) frames = block_frames_;
+
+    // each channel starts from the sample in its header
+    int predictor[2], index[2];
+    for (int c = 0; c < channels_; c++)
+    {
+        const unsigned char *h = &block_bytes_[4 * c];
+        predictor[c] = static_cast<int16_t>(ReadU16(h));
+        index[c] = h[2] > 88 ? 88 : h[2];
+        block_[c] = static_cast<int16_t>(predictor[c]);
+    }
+
+    // then the channels take turns with 4 bytes (8 codes, low nibble first) each
+    const unsigned char *data = &block_bytes_[header];
+    int bytes = got - header;
+    for (int i = 0; i < bytes; i++)
+    {
+        int group = i / 4;
+        int c = group % channels_;
+        int frame = 1 + (group / channels_) * 8 + (i % 4) * 2;
+
+        if (frame < frames) block_[frame * channels_ + c] = DecodeNibble(data[i] & 0x0f, predictor[c], index[c]);
+        if (frame + 1 < frames) block_[(frame + 1) * channels_ + c] = DecodeNibble(data[i] >> 4, predictor[c], index[c]);
+    }
+
+    block_size_ = frames;
+    block_position_ = 0;
+    return true;
+}
+
+} // namespace audio_manager
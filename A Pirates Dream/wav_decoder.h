@@ -0,0 +1,78 @@
+#ifndef WAV_DECODER_H_
+#define WAV_DECODER_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace audio_manager {
+
+    /*
+        Reads the samples of a wav file a piece at a time instead of loading it all up front
+        Handles uncompressed 8 and 16 bit files and IMA ADPCM ones (4 bits a sample, a quarter the size of 16 bit,
+        what sox -e ima-adpcm and most editors write), whatever is in the file comes out as signed 16 bit samples
+        with the channels interleaved
+        ADPCM comes in blocks that each start from a known sample, so only one block is ever decoded at a time
+    */
+    class WavDecoder {
+
+        public:
+            // Constructor and destructor
+            WavDecoder(void);
+            ~WavDecoder();
+
+            // Open a file and read its header, throws an AudioManagerException if it isnt a wav we can play
+            void Open(const char *filename);
+
+            // Close the file
+            void Close(void);
+
+            // Decode up to frames frames into out (frames * channels samples), returns how many it got,
+            // fewer than asked means the end of the file
+            int Read(int16_t *out, int frames);
+
+            // Go back to the first sample
+            void Rewind(void);
+
+            // Getters
+            inline bool IsOpen(void) const { return file_ != NULL; }
+            inline int GetChannels(void) const { return channels_; }
+            inline int GetSampleRate(void) const { return sample_rate_; }
+            inline int GetFrames(void) const { return frames_; }
+
+        private:
+            FILE *file_;
+
+            // the format of the samples in the file
+            int format_;
+            int channels_;
+            int sample_rate_;
+            int bits_;
+
+            // the size of an ADPCM block in the file and how many frames it decodes to
+            int block_align_;
+            int block_frames_;
+
+            // where the samples start in the file, how many frames there are and how many weve read
+            long data_start_;
+            int frames_;
+            int position_;
+
+            // scratch space for the raw bytes of 8 bit files
+            unsigned char raw_[4096];
+
+            // the ADPCM block being read, raw and decoded, and how far into it we are
+            std::vector<unsigned char> block_bytes_;
+            std::vector<int16_t> block_;
+            int block_size_;
+            int block_position_;
+
+            // Decode the next ADPCM block into block_, false at the end of the file
+            bool DecodeBlock(void);
+
+    }; // class WavDecoder
+
+} // namespace audio_manager
+
+#endif // WAV_DECODER_H_